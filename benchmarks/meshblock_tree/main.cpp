@@ -0,0 +1,152 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file main.cpp
+//  \brief Times the neighbor search of the linear octree MeshBlockTree against the
+//  pointer tree it replaced, on a randomly refined periodic 3D mesh. Usage:
+//
+//    meshblock-tree-benchmark [ntrials=10] [nlevels=3]
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <Kokkos_Core.hpp>
+
+#include "mesh/logical_location.hpp"
+#include "mesh/meshblock_tree.hpp"
+
+using parthenon::LogicalLocation;
+using parthenon::MeshBlockTree;
+using parthenon::RootGridInfo;
+
+namespace {
+// The pointer tree of the previous MeshBlockTree, reduced to what the neighbor search
+// uses. Every node holds pointers to its eight daughters and the search descends from
+// the root of a full periodic grid of 2^level blocks per direction at every level.
+class PointerTree {
+ public:
+  PointerTree(const std::vector<LogicalLocation> &leaves, const std::vector<int> &gids) {
+    for (int n = 0; n < leaves.size(); ++n) {
+      Node *node = &root_;
+      const auto &loc = leaves[n];
+      for (int level = 0; level < loc.level(); ++level) {
+        const int sh = loc.level() - level - 1;
+        auto &daughter = node->daughters[Daughter_(loc.lx1(), loc.lx2(), loc.lx3(), sh)];
+        if (daughter == nullptr) daughter = std::make_unique<Node>();
+        node = daughter.get();
+      }
+      node->gid = gids[n];
+    }
+  }
+
+  // gid of the same level or coarser neighbor, -1 if the neighbor is finer
+  int FindNeighbor(const LogicalLocation &loc, int ox1, int ox2, int ox3) const {
+    const std::int64_t nmax = std::int64_t(1) << loc.level();
+    const std::int64_t lx = (loc.lx1() + ox1 + nmax) % nmax;
+    const std::int64_t ly = (loc.lx2() + ox2 + nmax) % nmax;
+    const std::int64_t lz = (loc.lx3() + ox3 + nmax) % nmax;
+    const Node *node = &root_;
+    for (int level = 0; level < loc.level(); ++level) {
+      if (node->IsLeaf()) break;
+      node = node->daughters[Daughter_(lx, ly, lz, loc.level() - level - 1)].get();
+    }
+    return node->gid;
+  }
+
+ private:
+  struct Node {
+    int gid = -1;
+    std::unique_ptr<Node> daughters[8];
+    bool IsLeaf() const { return daughters[0] == nullptr; }
+  };
+
+  static int Daughter_(std::int64_t lx, std::int64_t ly, std::int64_t lz, int sh) {
+    return ((lx >> sh) & 1LL) + 2 * ((ly >> sh) & 1LL) + 4 * ((lz >> sh) & 1LL);
+  }
+
+  Node root_;
+};
+
+// Sum of gid + 1 over the neighbors of all leaves, searched ntrials times
+template <typename Find>
+std::int64_t SearchNeighbors(const std::vector<LogicalLocation> &leaves, int ntrials,
+                             const Find &find) {
+  std::int64_t sum = 0;
+  for (int trial = 0; trial < ntrials; ++trial) {
+    for (const auto &leaf : leaves) {
+      for (int ox3 = -1; ox3 <= 1; ++ox3) {
+        for (int ox2 = -1; ox2 <= 1; ++ox2) {
+          for (int ox1 = -1; ox1 <= 1; ++ox1) {
+            sum += find(leaf, ox1, ox2, ox3) + 1;
+          }
+        }
+      }
+    }
+  }
+  return sum;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const int ntrials = (argc > 1) ? std::atoi(argv[1]) : 10;
+  const int nlevels = (argc > 2) ? std::atoi(argv[2]) : 3;
+
+  // 4^3 root blocks, of which 30% are refined at every level
+  RootGridInfo rg_info(2, 4, 4, 4, true, true, true);
+  MeshBlockTree tree(rg_info, 3);
+  tree.CreateRootGrid();
+  std::mt19937 gen(1234);
+  std::bernoulli_distribution refine(0.3);
+  int count;
+  for (int level = 2; level < 2 + nlevels; ++level) {
+    tree.CountMeshBlock(count);
+    std::vector<LogicalLocation> leaves(count), lref;
+    tree.GetMeshBlockList(leaves.data(), nullptr, count);
+    for (const auto &leaf : leaves) {
+      if (refine(gen)) lref.push_back(leaf);
+    }
+    int nnew = 0;
+    tree.Refine(lref, nnew);
+  }
+  tree.CountMeshBlock(count);
+  std::vector<LogicalLocation> leaves(count);
+  std::vector<int> gids(count);
+  tree.GetMeshBlockList(leaves.data(), gids.data(), count);
+  const PointerTree pointer_tree(leaves, gids);
+
+  auto linear = [&](const LogicalLocation &loc, int ox1, int ox2, int ox3) {
+    return tree.FindNeighbor(loc, ox1, ox2, ox3).GetGid();
+  };
+  auto pointer = [&](const LogicalLocation &loc, int ox1, int ox2, int ox3) {
+    return pointer_tree.FindNeighbor(loc, ox1, ox2, ox3);
+  };
+  Kokkos::Timer timer;
+  const auto linear_sum = SearchNeighbors(leaves, ntrials, linear);
+  const double linear_time = timer.seconds();
+  timer.reset();
+  const auto pointer_sum = SearchNeighbors(leaves, ntrials, pointer);
+  const double pointer_time = timer.seconds();
+
+  std::cout << "Neighbor search of " << count << " blocks, " << ntrials << " trials"
+            << std::endl
+            << "  linear octree: " << linear_time << " s" << std::endl
+            << "  pointer tree:  " << pointer_time << " s" << std::endl;
+  if (linear_sum != pointer_sum) {
+    std::cerr << "The trees found different neighbors" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
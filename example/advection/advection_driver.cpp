@@ -75,14 +75,18 @@ TaskCollection AdvectionDriver::MakeTaskCollection(BlockList_t &blocks, const in
   }
 
   const int num_partitions = pmesh->DefaultNumPartitions();
+  const int base_id = pmesh->mesh_data.GetStageId("base");
+  const int c0_id = pmesh->mesh_data.GetStageId(stage_name[stage - 1]);
+  const int c1_id = pmesh->mesh_data.GetStageId(stage_name[stage]);
+  const int dudt_id = pmesh->mesh_data.GetStageId("dUdt");
 
   // note that task within this region that contains one tasklist per pack
   // could still be executed in parallel
   TaskRegion &single_tasklist_per_pack_region2 = tc.AddRegion(num_partitions);
   for (int i = 0; i < num_partitions; i++) {
     auto &tl = single_tasklist_per_pack_region2[i];
-    auto &mc0 = pmesh->mesh_data.GetOrAdd(stage_name[stage - 1], i);
-    auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
+    auto &mc0 = pmesh->mesh_data.GetOrAddPartition(c0_id, i);
+    auto &mc1 = pmesh->mesh_data.GetOrAddPartition(c1_id, i);
 
     const auto any = parthenon::BoundaryType::any;
 
@@ -119,10 +123,10 @@ TaskCollection AdvectionDriver::MakeTaskCollection(BlockList_t &blocks, const in
   TaskRegion &single_tasklist_per_pack_region = tc.AddRegion(num_partitions);
   for (int i = 0; i < num_partitions; i++) {
     auto &tl = single_tasklist_per_pack_region[i];
-    auto &mbase = pmesh->mesh_data.GetOrAdd("base", i);
-    auto &mc0 = pmesh->mesh_data.GetOrAdd(stage_name[stage - 1], i);
-    auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
-    auto &mdudt = pmesh->mesh_data.GetOrAdd("dUdt", i);
+    auto &mbase = pmesh->mesh_data.GetOrAddPartition(base_id, i);
+    auto &mc0 = pmesh->mesh_data.GetOrAddPartition(c0_id, i);
+    auto &mc1 = pmesh->mesh_data.GetOrAddPartition(c1_id, i);
+    auto &mdudt = pmesh->mesh_data.GetOrAddPartition(dudt_id, i);
 
     auto send_flx = tl.AddTask(none, parthenon::LoadAndSendFluxCorrections, mc0);
     auto recv_flx = tl.AddTask(none, parthenon::ReceiveFluxCorrections, mc0);
@@ -168,6 +172,13 @@ TaskCollection AdvectionDriver::MakeTaskCollection(BlockList_t &blocks, const in
       }
     }
   }
+
+  // Start reducing the refinement flags and costs for the remesh at the end of the step
+  // once all blocks are tagged
+  if (stage == integrator->nstages) {
+    TaskRegion &remesh_region = tc.AddRegion(1);
+    remesh_region[0].AddTask(none, &Mesh::StartRemeshExchange, pmesh);
+  }
   return tc;
 }
 
@@ -119,13 +119,14 @@ TaskCollection PiDriver::MakeTaskCollection(T &blocks) {
   TaskCollection tc;
 
   const int num_partitions = pmesh->DefaultNumPartitions();
+  const int base_id = pmesh->mesh_data.GetStageId("base");
   ParArrayHost<Real> areas("areas", num_partitions);
   TaskRegion &async_region = tc.AddRegion(num_partitions);
   {
     // asynchronous region where area is computed per partition
     for (int i = 0; i < num_partitions; i++) {
       TaskID none(0);
-      auto &md = pmesh->mesh_data.GetOrAdd("base", i);
+      auto &md = pmesh->mesh_data.GetOrAddPartition(base_id, i);
       auto get_area = async_region[i].AddTask(none, ComputeArea, md, areas, i);
     }
   }
@@ -439,15 +439,19 @@ TaskCollection ParticleDriver::MakeTaskCollection(BlockList_t &blocks, int stage
   }
 
   const int num_partitions = pmesh->DefaultNumPartitions();
+  const int base_id = pmesh->mesh_data.GetStageId("base");
+  const int c0_id = pmesh->mesh_data.GetStageId(stage_name[stage - 1]);
+  const int c1_id = pmesh->mesh_data.GetStageId(stage_name[stage]);
+  const int dudt_id = pmesh->mesh_data.GetStageId("dUdt");
   // note that task within this region that contains one tasklist per pack
   // could still be executed in parallel
   TaskRegion &single_tasklist_per_pack_region = tc.AddRegion(num_partitions);
   for (int i = 0; i < num_partitions; i++) {
     auto &tl = single_tasklist_per_pack_region[i];
-    auto &mbase = pmesh->mesh_data.GetOrAdd("base", i);
-    auto &mc0 = pmesh->mesh_data.GetOrAdd(stage_name[stage - 1], i);
-    auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
-    auto &mdudt = pmesh->mesh_data.GetOrAdd("dUdt", i);
+    auto &mbase = pmesh->mesh_data.GetOrAddPartition(base_id, i);
+    auto &mc0 = pmesh->mesh_data.GetOrAddPartition(c0_id, i);
+    auto &mc1 = pmesh->mesh_data.GetOrAddPartition(c1_id, i);
+    auto &mdudt = pmesh->mesh_data.GetOrAddPartition(dudt_id, i);
 
     const auto any = parthenon::BoundaryType::any;
 
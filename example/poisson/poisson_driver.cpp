@@ -56,6 +56,8 @@ TaskCollection PoissonDriver::MakeTaskCollection(BlockList_t &blocks) {
   auto warn_flag = pkg->Param<bool>("warn_without_convergence");
 
   const int num_partitions = pmesh->DefaultNumPartitions();
+  const int base_id = pmesh->mesh_data.GetStageId("base");
+  const int delta_id = pmesh->mesh_data.GetStageId("delta");
   TaskRegion &solver_region = tc.AddRegion(num_partitions);
 
   // setup some reductions
@@ -74,8 +76,8 @@ TaskCollection PoissonDriver::MakeTaskCollection(BlockList_t &blocks) {
   for (int i = 0; i < num_partitions; i++) {
     reg_dep_id = 0;
     // make/get a mesh_data container for the state
-    auto &md = pmesh->mesh_data.GetOrAdd("base", i);
-    auto &mdelta = pmesh->mesh_data.GetOrAdd("delta", i);
+    auto &md = pmesh->mesh_data.GetOrAddPartition(base_id, i);
+    auto &mdelta = pmesh->mesh_data.GetOrAddPartition(delta_id, i);
 
     TaskList &tl = solver_region[i];
 
@@ -78,11 +78,12 @@ TaskCollection PoissonDriver::MakeTaskCollection(BlockList_t &blocks) {
           "MGBiCGSTABsolver");
 
   const int num_partitions = pmesh->DefaultNumPartitions();
+  const int base_id = pmesh->mesh_data.GetStageId("base");
   TaskRegion &region = tc.AddRegion(num_partitions);
   int reg_dep_id = 0;
   for (int i = 0; i < num_partitions; ++i) {
     TaskList &tl = region[i];
-    auto &md = pmesh->mesh_data.GetOrAdd("base", i);
+    auto &md = pmesh->mesh_data.GetOrAddPartition(base_id, i);
 
     // Possibly set rhs <- A.u_exact for a given u_exact so that the exact solution is
     // known when we solve A.u = rhs
@@ -0,0 +1,343 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef AMR_CRITERIA_FUSED_CRITERIA_HPP_
+#define AMR_CRITERIA_FUSED_CRITERIA_HPP_
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "amr_criteria/amr_criteria.hpp"
+#include "basic_types.hpp"
+#include "defs.hpp"
+#include "interface/make_pack_descriptor.hpp"
+#include "interface/mesh_data.hpp"
+#include "interface/sparse_pack.hpp"
+#include "interface/state_descriptor.hpp"
+#include "kokkos_abstraction.hpp"
+
+namespace parthenon {
+namespace Refinement {
+
+// Device refinement criteria are functors that return the recommended change in
+// refinement level for a single cell of a block,
+//
+//   KOKKOS_INLINE_FUNCTION AmrTag operator()(const SparsePack<> &pack, const int ndim,
+//                                            const int b, const int k, const int j,
+//                                            const int i) const;
+//
+// where pack contains the variables the criteria were registered with, in the order
+// they were passed (i.e. variable n is PackIdx(n)). Since the tag of a criterion only
+// grows with the quantity it checks, the tag of a block is the maximum tag over its
+// cells, so all criteria can be evaluated in a single pass over the data.
+
+// Compile time list of criteria evaluated together for each cell
+template <typename... Criteria>
+struct FusedCriteria;
+
+template <>
+struct FusedCriteria<> {
+  KOKKOS_INLINE_FUNCTION
+  int operator()(const SparsePack<> &pack, const int ndim, const int b, const int k,
+                 const int j, const int i) const {
+    return static_cast<int>(AmrTag::derefine);
+  }
+};
+
+template <typename Criterion, typename... Rest>
+struct FusedCriteria<Criterion, Rest...> {
+  FusedCriteria(const Criterion &crit, const Rest &...rest)
+      : crit_(crit), rest_(rest...) {}
+
+  KOKKOS_INLINE_FUNCTION
+  int operator()(const SparsePack<> &pack, const int ndim, const int b, const int k,
+                 const int j, const int i) const {
+    const int tag = static_cast<int>(crit_(pack, ndim, b, k, j, i));
+    const int rest_tag = rest_(pack, ndim, b, k, j, i);
+    return (tag > rest_tag) ? tag : rest_tag;
+  }
+
+ private:
+  Criterion crit_;
+  FusedCriteria<Rest...> rest_;
+};
+
+// Raise tags(b) to the maximum tag of all criteria over the cells kb x jb x ib of block b
+// of pack, in a single kernel
+template <typename... Criteria>
+void TagBlocks(const SparsePack<> &pack, const IndexRange &ib, const IndexRange &jb,
+               const IndexRange &kb, const ParArray1D<AmrTag> &tags,
+               const Criteria &...criteria) {
+  const FusedCriteria<Criteria...> fused(criteria...);
+  const int ndim = 1 + (jb.e > jb.s) + (kb.e > kb.s);
+  par_for_outer(
+      DEFAULT_OUTER_LOOP_PATTERN, "Refinement::TagBlocks", DevExecSpace(), 0, 0, 0,
+      pack.GetNBlocks() - 1, KOKKOS_LAMBDA(team_mbr_t member, const int b) {
+        int btag = static_cast<int>(AmrTag::derefine);
+        par_reduce_inner(
+            member, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            [&](const int k, const int j, const int i, int &ltag) {
+              const int tag = fused(pack, ndim, b, k, j, i);
+              ltag = (tag > ltag) ? tag : ltag;
+            },
+            Kokkos::Max<int>(btag));
+        Kokkos::single(Kokkos::PerTeam(member), [&]() {
+          if (btag > static_cast<int>(tags(b))) tags(b) = static_cast<AmrTag>(btag);
+        });
+      });
+}
+
+// Raise tags(b) to the maximum tag of all criteria over the interior cells of block b
+// of md, in a single kernel
+template <typename... Criteria>
+void TagBlocks(MeshData<Real> *md, const SparsePack<> &pack,
+               const ParArray1D<AmrTag> &tags, const Criteria &...criteria) {
+  TagBlocks(pack, md->GetBoundsI(IndexDomain::interior),
+            md->GetBoundsJ(IndexDomain::interior), md->GetBoundsK(IndexDomain::interior),
+            tags, criteria...);
+}
+
+// Register device criteria acting on the variables vars with the package pkg. The
+// criteria of a package are evaluated in a single pass over the data in Tag(MeshData).
+template <typename... Criteria>
+void RegisterRefinementCriteria(StateDescriptor *pkg,
+                                const std::vector<std::string> &vars,
+                                const Criteria &...criteria) {
+  // The pack descriptor can only be built once the packages are resolved
+  auto pdesc = std::make_shared<std::unique_ptr<SparsePack<>::Descriptor>>();
+  pkg->CheckRefinementMesh = [=](MeshData<Real> *md, ParArray1D<AmrTag> &tags) {
+    if (*pdesc == nullptr) {
+      *pdesc = std::make_unique<SparsePack<>::Descriptor>(
+          MakePackDescriptor(md->GetMeshPointer()->resolved_packages.get(), vars));
+    }
+    TagBlocks(md, (*pdesc)->GetPack(md), tags, criteria...);
+  };
+}
+
+// Tag on the value of component comp of variable var, e.g. a density threshold
+struct ThresholdCriterion {
+  ThresholdCriterion(int var, int comp, Real refine_above, Real derefine_below)
+      : var_(var), comp_(comp), refine_above_(refine_above),
+        derefine_below_(derefine_below) {}
+
+  KOKKOS_INLINE_FUNCTION
+  AmrTag operator()(const SparsePack<> &pack, const int ndim, const int b, const int k,
+                    const int j, const int i) const {
+    PackIdx idx(var_, comp_);
+    if (!pack.Contains(b, idx)) return AmrTag::same;
+    const Real q = pack(b, idx, k, j, i);
+    if (q > refine_above_) return AmrTag::refine;
+    if (q < derefine_below_) return AmrTag::derefine;
+    return AmrTag::same;
+  }
+
+ private:
+  int var_, comp_;
+  Real refine_above_, derefine_below_;
+};
+
+// Tag on the maximum normalized gradient of components [comp_start, comp_end] of
+// variable var, e.g. all components of a vector field
+struct GradientCriterion {
+  GradientCriterion(int var, int comp_start, int comp_end, Real refine_tol,
+                    Real derefine_tol)
+      : var_(var), comp_start_(comp_start), comp_end_(comp_end),
+        refine_tol_(refine_tol), derefine_tol_(derefine_tol) {}
+
+  KOKKOS_INLINE_FUNCTION
+  AmrTag operator()(const SparsePack<> &pack, const int ndim, const int b, const int k,
+                    const int j, const int i) const {
+    if (!pack.Contains(b, PackIdx(var_))) return AmrTag::same;
+    Real maxd = 0.0;
+    for (int c = comp_start_; c <= comp_end_; ++c) {
+      const auto &q = pack(b, PackIdx(var_, c));
+      const Real scale = std::abs(q(k, j, i)) + TINY_NUMBER;
+      Real d = 0.5 * std::abs(q(k, j, i + 1) - q(k, j, i - 1)) / scale;
+      maxd = (d > maxd) ? d : maxd;
+      if (ndim > 1) {
+        d = 0.5 * std::abs(q(k, j + 1, i) - q(k, j - 1, i)) / scale;
+        maxd = (d > maxd) ? d : maxd;
+      }
+      if (ndim > 2) {
+        d = 0.5 * std::abs(q(k + 1, j, i) - q(k - 1, j, i)) / scale;
+        maxd = (d > maxd) ? d : maxd;
+      }
+    }
+    if (maxd > refine_tol_) return AmrTag::refine;
+    if (maxd < derefine_tol_) return AmrTag::derefine;
+    return AmrTag::same;
+  }
+
+ private:
+  int var_, comp_start_, comp_end_;
+  Real refine_tol_, derefine_tol_;
+};
+
+// Loehner's error estimator for component comp of variable var, i.e. the second
+// differences over the first differences, where the latter are filtered by filter times
+// the magnitude of the variable to ignore small ripples. Only the second derivatives
+// along each direction are included, not the mixed ones:
+//   E = sqrt(sum_d |q_{d-1} - 2 q + q_{d+1}|^2 / sum_d den_d^2),
+//   den_d = |q_{d+1} - q| + |q - q_{d-1}| + filter * (|q_{d+1}| + 2 |q| + |q_{d-1}|)
+struct LohnerCriterion {
+  LohnerCriterion(int var, int comp, Real refine_tol, Real derefine_tol,
+                  Real filter = 0.01)
+      : var_(var), comp_(comp), refine_tol_(refine_tol), derefine_tol_(derefine_tol),
+        filter_(filter) {}
+
+  KOKKOS_INLINE_FUNCTION
+  AmrTag operator()(const SparsePack<> &pack, const int ndim, const int b, const int k,
+                    const int j, const int i) const {
+    PackIdx idx(var_, comp_);
+    if (!pack.Contains(b, idx)) return AmrTag::same;
+    const auto &q = pack(b, idx);
+    Real num = 0.0, den = 0.0;
+    AddDirection(q(k, j, i - 1), q(k, j, i), q(k, j, i + 1), num, den);
+    if (ndim > 1) AddDirection(q(k, j - 1, i), q(k, j, i), q(k, j + 1, i), num, den);
+    if (ndim > 2) AddDirection(q(k - 1, j, i), q(k, j, i), q(k + 1, j, i), num, den);
+    const Real e = std::sqrt(num / (den + TINY_NUMBER));
+    if (e > refine_tol_) return AmrTag::refine;
+    if (e < derefine_tol_) return AmrTag::derefine;
+    return AmrTag::same;
+  }
+
+ private:
+  KOKKOS_INLINE_FUNCTION
+  void AddDirection(const Real qm, const Real q0, const Real qp, Real &num,
+                    Real &den) const {
+    const Real d2 = qp - 2.0 * q0 + qm;
+    const Real d1 = std::abs(qp - q0) + std::abs(q0 - qm) +
+                    filter_ * (std::abs(qp) + 2.0 * std::abs(q0) + std::abs(qm));
+    num += d2 * d2;
+    den += d1 * d1;
+  }
+
+  int var_, comp_;
+  Real refine_tol_, derefine_tol_, filter_;
+};
+
+// Maximum normalized first/second derivative of q at (k, j, i) over all directions
+template <typename Q>
+KOKKOS_INLINE_FUNCTION Real FirstDerivativeAt(const Q &q, const int ndim, const int k,
+                                              const int j, const int i) {
+  Real scale = std::abs(q(k, j, i));
+  Real maxd = 0.5 * std::abs((q(k, j, i + 1) - q(k, j, i - 1))) / (scale + TINY_NUMBER);
+  if (ndim > 1) {
+    Real d = 0.5 * std::abs((q(k, j + 1, i) - q(k, j - 1, i))) / (scale + TINY_NUMBER);
+    maxd = (d > maxd ? d : maxd);
+  }
+  if (ndim > 2) {
+    Real d = 0.5 * std::abs((q(k + 1, j, i) - q(k - 1, j, i))) / (scale + TINY_NUMBER);
+    maxd = (d > maxd ? d : maxd);
+  }
+  return maxd;
+}
+
+template <typename Q>
+KOKKOS_INLINE_FUNCTION Real SecondDerivativeAt(const Q &q, const int ndim, const int k,
+                                               const int j, const int i) {
+  Real aqt = std::abs(q(k, j, i)) + TINY_NUMBER;
+  Real qavg = 0.5 * (q(k, j, i + 1) + q(k, j, i - 1));
+  Real maxd = std::abs(qavg - q(k, j, i)) / (std::abs(qavg) + aqt);
+  if (ndim > 1) {
+    qavg = 0.5 * (q(k, j + 1, i) + q(k, j - 1, i));
+    Real d = std::abs(qavg - q(k, j, i)) / (std::abs(qavg) + aqt);
+    maxd = (d > maxd ? d : maxd);
+  }
+  if (ndim > 2) {
+    qavg = 0.5 * (q(k + 1, j, i) + q(k - 1, j, i));
+    Real d = std::abs(qavg - q(k, j, i)) / (std::abs(qavg) + aqt);
+    maxd = (d > maxd ? d : maxd);
+  }
+  return maxd;
+}
+
+KOKKOS_INLINE_FUNCTION AmrTag TagFromDerivative(const Real maxd,
+                                                const Real refine_criteria,
+                                                const Real derefine_criteria) {
+  if (maxd > refine_criteria) return AmrTag::refine;
+  if (maxd < derefine_criteria) return AmrTag::derefine;
+  return AmrTag::same;
+}
+
+// Device side description of a derivative criterion read from the input
+struct DerivativeCriterion {
+  int order;     // 1 or 2
+  int var;       // index of the field in the pack descriptor
+  int component; // flattened component of the field
+  int max_level;
+  Real refine_criteria, derefine_criteria;
+};
+
+// All derivative criteria read from the input, as a single device criterion
+struct DerivativeCriteria {
+  ParArray1D<DerivativeCriterion> criteria;
+  ParArray1D<int> levels; // logical level of each block
+
+  KOKKOS_INLINE_FUNCTION
+  AmrTag operator()(const SparsePack<> &pack, const int ndim, const int b, const int k,
+                    const int j, const int i) const {
+    AmrTag delta_level = AmrTag::derefine;
+    for (int c = 0; c < criteria.extent_int(0); ++c) {
+      const auto &crit = criteria(c);
+      PackIdx idx(crit.var, crit.component);
+      AmrTag temp_delta = AmrTag::same; // unallocated fields do not matter
+      if (pack.Contains(b, idx)) {
+        const auto &q = pack(b, idx);
+        const Real d = (crit.order == 1) ? FirstDerivativeAt(q, ndim, k, j, i)
+                                         : SecondDerivativeAt(q, ndim, k, j, i);
+        temp_delta = TagFromDerivative(d, crit.refine_criteria, crit.derefine_criteria);
+      }
+      // don't refine if we're at the max level
+      if (temp_delta == AmrTag::refine && levels(b) >= crit.max_level)
+        temp_delta = AmrTag::same;
+      delta_level = (temp_delta > delta_level) ? temp_delta : delta_level;
+    }
+    return delta_level;
+  }
+};
+
+// Evaluates the first and second derivative criteria of the input for all blocks of a
+// MeshData in a single kernel. Like the per-block criteria, the derivatives are taken
+// over the interior and the first layer of ghost cells. The device copy of the criteria
+// and the pack descriptor are set up on the first call and reused afterwards, the
+// per-block arrays are kept by each MeshData.
+class DerivativeTagger {
+ public:
+  using BlockArrays = RefinementTagArrays;
+
+  // Criteria other than first and second derivatives are kept in HostCriteria
+  explicit DerivativeTagger(const std::vector<std::shared_ptr<AMRCriteria>> &criteria);
+
+  // Sets the device tags of the blocks of md, derefine for blocks without any criteria.
+  // The arrays belong to md and are reused by the next call for it.
+  const BlockArrays &Tag(MeshData<Real> *md, StateDescriptor *resolved_packages);
+
+  const std::vector<std::shared_ptr<AMRCriteria>> &HostCriteria() const {
+    return host_criteria_;
+  }
+
+ private:
+  void SetUp_(MeshData<Real> *md, StateDescriptor *resolved_packages);
+
+  std::vector<std::shared_ptr<AMRCriteria>> derivative_criteria_, host_criteria_;
+  bool set_up_ = false;
+  ParArray1D<DerivativeCriterion> criteria_;
+  std::unique_ptr<SparsePack<>::Descriptor> desc_;
+};
+
+} // namespace Refinement
+} // namespace parthenon
+
+#endif // AMR_CRITERIA_FUSED_CRITERIA_HPP_
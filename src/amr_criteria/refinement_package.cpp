@@ -16,12 +16,18 @@
 #include <algorithm>
 #include <exception>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "amr_criteria/amr_criteria.hpp"
+#include "amr_criteria/fused_criteria.hpp"
+#include "interface/make_pack_descriptor.hpp"
 #include "interface/mesh_data.hpp"
 #include "interface/meshblock_data.hpp"
+#include "interface/sparse_pack.hpp"
 #include "interface/state_descriptor.hpp"
+#include "kokkos_abstraction.hpp"
 #include "mesh/mesh.hpp"
 #include "mesh/mesh_refinement.hpp"
 #include "mesh/meshblock.hpp"
@@ -44,6 +50,8 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin) {
     ref->amr_criteria.push_back(AMRCriteria::MakeAMRCriteria(method, pin, block_name));
     numcrit++;
   }
+  // set up by the first call of Tag(MeshData), once all packages are known
+  ref->AddParam("tagger", std::shared_ptr<DerivativeTagger>(), true);
   return ref;
 }
 
@@ -96,24 +104,11 @@ AmrTag FirstDerivative(const AMRBounds &bnds, const ParArray3D<Real> &q,
       loop_pattern_mdrange_tag, "refinement first derivative", DevExecSpace(), bnds.ks,
       bnds.ke, bnds.js, bnds.je, bnds.is, bnds.ie,
       KOKKOS_LAMBDA(int k, int j, int i, Real &maxd) {
-        Real scale = std::abs(q(k, j, i));
-        Real d =
-            0.5 * std::abs((q(k, j, i + 1) - q(k, j, i - 1))) / (scale + TINY_NUMBER);
+        Real d = FirstDerivativeAt(q, ndim, k, j, i);
         maxd = (d > maxd ? d : maxd);
-        if (ndim > 1) {
-          d = 0.5 * std::abs((q(k, j + 1, i) - q(k, j - 1, i))) / (scale + TINY_NUMBER);
-          maxd = (d > maxd ? d : maxd);
-        }
-        if (ndim > 2) {
-          d = 0.5 * std::abs((q(k + 1, j, i) - q(k - 1, j, i))) / (scale + TINY_NUMBER);
-          maxd = (d > maxd ? d : maxd);
-        }
       },
       Kokkos::Max<Real>(maxd));
-
-  if (maxd > refine_criteria) return AmrTag::refine;
-  if (maxd < derefine_criteria) return AmrTag::derefine;
-  return AmrTag::same;
+  return TagFromDerivative(maxd, refine_criteria, derefine_criteria);
 }
 
 AmrTag SecondDerivative(const AMRBounds &bnds, const ParArray3D<Real> &q,
@@ -124,26 +119,11 @@ AmrTag SecondDerivative(const AMRBounds &bnds, const ParArray3D<Real> &q,
       loop_pattern_mdrange_tag, "refinement second derivative", DevExecSpace(), bnds.ks,
       bnds.ke, bnds.js, bnds.je, bnds.is, bnds.ie,
       KOKKOS_LAMBDA(int k, int j, int i, Real &maxd) {
-        Real aqt = std::abs(q(k, j, i)) + TINY_NUMBER;
-        Real qavg = 0.5 * (q(k, j, i + 1) + q(k, j, i - 1));
-        Real d = std::abs(qavg - q(k, j, i)) / (std::abs(qavg) + aqt);
+        Real d = SecondDerivativeAt(q, ndim, k, j, i);
         maxd = (d > maxd ? d : maxd);
-        if (ndim > 1) {
-          qavg = 0.5 * (q(k, j + 1, i) + q(k, j - 1, i));
-          d = std::abs(qavg - q(k, j, i)) / (std::abs(qavg) + aqt);
-          maxd = (d > maxd ? d : maxd);
-        }
-        if (ndim > 2) {
-          qavg = 0.5 * (q(k + 1, j, i) + q(k - 1, j, i));
-          d = std::abs(qavg - q(k, j, i)) / (std::abs(qavg) + aqt);
-          maxd = (d > maxd ? d : maxd);
-        }
       },
       Kokkos::Max<Real>(maxd));
-
-  if (maxd > refine_criteria) return AmrTag::refine;
-  if (maxd < derefine_criteria) return AmrTag::derefine;
-  return AmrTag::same;
+  return TagFromDerivative(maxd, refine_criteria, derefine_criteria);
 }
 
 void SetRefinement_(MeshBlockData<Real> *rc) {
@@ -154,17 +134,125 @@ void SetRefinement_(MeshBlockData<Real> *rc) {
 template <>
 TaskStatus Tag(MeshBlockData<Real> *rc) {
   Kokkos::Profiling::pushRegion("Task_Tag_Block");
+  auto &remesh_stats = rc->GetBlockPointer()->pmy_mesh->remesh_stats;
+  auto phase_timer = remesh_stats.Time(RemeshStats::Phase::tag);
   SetRefinement_(rc);
+  remesh_stats.AddVolume(RemeshStats::Phase::tag, 1, 0);
   Kokkos::Profiling::popRegion(); // Task_Tag_Block
   return TaskStatus::complete;
 }
 
+DerivativeTagger::DerivativeTagger(
+    const std::vector<std::shared_ptr<AMRCriteria>> &criteria) {
+  for (auto &amr : criteria) {
+    if (std::dynamic_pointer_cast<AMRFirstDerivative>(amr) ||
+        std::dynamic_pointer_cast<AMRSecondDerivative>(amr)) {
+      derivative_criteria_.push_back(amr);
+    } else {
+      host_criteria_.push_back(amr);
+    }
+  }
+}
+
+void DerivativeTagger::SetUp_(MeshData<Real> *md, StateDescriptor *resolved_packages) {
+  auto pmbd = md->GetBlockData(0);
+  std::vector<std::string> fields;
+  std::vector<DerivativeCriterion> criteria;
+  for (auto &amr : derivative_criteria_) {
+    if (!pmbd->HasVariable(amr->field)) continue;
+    const int order = std::dynamic_pointer_cast<AMRFirstDerivative>(amr) ? 1 : 2;
+    const auto &var = *pmbd->GetVarPtr(amr->field);
+    const int component =
+        (amr->comp6 * var.GetDim(5) + amr->comp5) * var.GetDim(4) + amr->comp4;
+    auto it = std::find(fields.begin(), fields.end(), amr->field);
+    const int ifield = std::distance(fields.begin(), it);
+    if (it == fields.end()) fields.push_back(amr->field);
+    criteria.push_back(DerivativeCriterion{order, ifield, component, amr->max_level,
+                                           amr->refine_criteria,
+                                           amr->derefine_criteria});
+  }
+  set_up_ = true;
+  if (criteria.empty()) return;
+
+  criteria_ = ParArray1D<DerivativeCriterion>("refinement criteria", criteria.size());
+  auto criteria_h = Kokkos::create_mirror_view(criteria_);
+  for (int c = 0; c < criteria.size(); ++c)
+    criteria_h(c) = criteria[c];
+  Kokkos::deep_copy(criteria_, criteria_h);
+  desc_ = std::make_unique<SparsePack<>::Descriptor>(
+      MakePackDescriptor(resolved_packages, fields));
+}
+
+const DerivativeTagger::BlockArrays &
+DerivativeTagger::Tag(MeshData<Real> *md, StateDescriptor *resolved_packages) {
+  const int nblocks = md->NumBlocks();
+  auto &arrays = md->GetRefinementTagArrays();
+  if (arrays.tags.extent_int(0) != nblocks) {
+    arrays.tags = ParArray1D<AmrTag>("refinement tags", nblocks);
+    arrays.tags_h = Kokkos::create_mirror_view(arrays.tags);
+    arrays.levels = ParArray1D<int>("block levels", nblocks);
+    arrays.levels_h = Kokkos::create_mirror_view(arrays.levels);
+  }
+  Kokkos::deep_copy(arrays.tags, AmrTag::derefine);
+  if (!set_up_ && nblocks > 0) SetUp_(md, resolved_packages);
+  if (desc_ == nullptr) return arrays;
+
+  for (int b = 0; b < nblocks; ++b)
+    arrays.levels_h(b) = md->GetBlockData(b)->GetBlockPointer()->loc.level();
+  Kokkos::deep_copy(arrays.levels, arrays.levels_h);
+
+  // same cells as AMRCriteria::GetBounds
+  const AMRBounds bnds(md->GetBoundsI(IndexDomain::interior),
+                       md->GetBoundsJ(IndexDomain::interior),
+                       md->GetBoundsK(IndexDomain::interior));
+  TagBlocks(desc_->GetPack(md), IndexRange{bnds.is, bnds.ie},
+            IndexRange{bnds.js, bnds.je}, IndexRange{bnds.ks, bnds.ke}, arrays.tags,
+            DerivativeCriteria{criteria_, arrays.levels});
+  return arrays;
+}
+
 template <>
 TaskStatus Tag(MeshData<Real> *rc) {
   Kokkos::Profiling::pushRegion("Task_Tag_Mesh");
-  for (int i = 0; i < rc->NumBlocks(); i++) {
-    SetRefinement_(rc->GetBlockData(i).get());
+  auto pmesh = rc->GetMeshPointer();
+  auto phase_timer = pmesh->remesh_stats.Time(RemeshStats::Phase::tag);
+  auto &tagger = *pmesh->packages.Get("Refinement")
+                      ->MutableParam<std::shared_ptr<DerivativeTagger>>("tagger");
+  if (tagger == nullptr) {
+    std::vector<std::shared_ptr<AMRCriteria>> criteria;
+    for (auto &pkg : pmesh->packages.AllPackages()) {
+      criteria.insert(criteria.end(), pkg.second->amr_criteria.begin(),
+                      pkg.second->amr_criteria.end());
+    }
+    tagger = std::make_shared<DerivativeTagger>(criteria);
+  }
+  // Device criteria of all blocks, only the final tags are copied to the host
+  const auto &arrays = tagger->Tag(rc, pmesh->resolved_packages.get());
+  auto tags = arrays.tags;
+  for (auto &pkg : pmesh->packages.AllPackages()) {
+    pkg.second->CheckRefinement(rc, tags);
+  }
+  Kokkos::deep_copy(arrays.tags_h, tags);
+
+  for (int b = 0; b < rc->NumBlocks(); b++) {
+    auto pmbd = rc->GetBlockData(b);
+    MeshBlock *pmb = pmbd->GetBlockPointer();
+    AmrTag delta_level = arrays.tags_h(b);
+    for (auto &pkg : pmb->packages.AllPackages()) {
+      if (delta_level == AmrTag::refine) break;
+      delta_level = std::max(delta_level, pkg.second->CheckRefinement(pmbd.get()));
+    }
+    for (auto &amr : tagger->HostCriteria()) {
+      if (delta_level == AmrTag::refine) break;
+      AmrTag temp_delta = (*amr)(pmbd.get());
+      if ((temp_delta == AmrTag::refine) && pmb->loc.level() >= amr->max_level) {
+        temp_delta = AmrTag::same;
+      }
+      delta_level = std::max(delta_level, temp_delta);
+    }
+    pmb->pmr->SetRefinement(delta_level);
   }
+  pmesh->remesh_stats.AddVolume(RemeshStats::Phase::tag, rc->NumBlocks(), 0);
   Kokkos::Profiling::popRegion(); // Task_Tag_Mesh
   return TaskStatus::complete;
 }
@@ -38,6 +38,11 @@ TaskStatus ApplyBoundaryConditionsOnCoarseOrFine(std::shared_ptr<MeshBlockData<R
   MeshBlock *pmb = rc->GetBlockPointer();
   Mesh *pmesh = pmb->pmy_mesh;
   const int ndim = pmesh->ndim;
+  // nothing to prolongate from without coarse buffers, see Mesh::LazyCoarseBuffers
+  if (coarse && !pmb->HasCoarseBuffers()) {
+    Kokkos::Profiling::popRegion(); // Task_ApplyBoundaryConditionsOnCoarseOrFine
+    return TaskStatus::complete;
+  }
 
   for (int i = 0; i < BOUNDARY_NFACES; i++) {
     if (DoPhysicalBoundary_(pmb->boundary_flag[i], static_cast<BoundaryFace>(i), ndim)) {
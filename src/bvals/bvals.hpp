@@ -82,6 +82,7 @@ class BoundaryBase {
   void
   SearchAndSetNeighbors(Mesh *mesh, MeshBlockTree &tree, int *ranklist, int *nslist,
                         const std::unordered_set<LogicalLocation> &newly_refined = {});
+  void UpdateNeighborIds(MeshBlockTree &tree, int *ranklist, int *nslist);
 
  protected:
   // 1D refined or unrefined=2
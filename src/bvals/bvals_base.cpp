@@ -338,7 +338,7 @@ void BoundaryBase::SearchAndSetNeighbors(
     Mesh *mesh, MeshBlockTree &tree, int *ranklist, int *nslist,
     const std::unordered_set<LogicalLocation> &newly_refined) {
   Kokkos::Profiling::pushRegion("SearchAndSetNeighbors");
-  MeshBlockTree *neibt;
+  MeshBlockTree::Node neibt;
   int myox1, myox2 = 0, myox3 = 0, myfx1, myfx2, myfx3;
   myfx1 = ((loc.lx1() & 1LL) == 1LL);
   myfx2 = ((loc.lx2() & 1LL) == 1LL);
@@ -365,20 +365,20 @@ void BoundaryBase::SearchAndSetNeighbors(
   // x1 face
   for (int n = -1; n <= 1; n += 2) {
     neibt = tree.FindNeighbor(loc, n, 0, 0);
-    if (neibt == nullptr) {
+    if (!neibt) {
       bufid += nf1 * nf2;
       continue;
     }
-    if (neibt->pleaf_ != nullptr) { // neighbor at finer level
+    if (!neibt.IsLeaf()) { // neighbor at finer level
       int fface = 1 - (n + 1) / 2;  // 0 for BoundaryFace::outer_x1, 1 for inner_x1
-      nblevel[1][1][n + 1] = neibt->loc_.level() + 1;
+      nblevel[1][1][n + 1] = neibt.GetLocation().level() + 1;
       for (int f2 = 0; f2 < nf2; f2++) {
         for (int f1 = 0; f1 < nf1; f1++) {
-          MeshBlockTree *nf = neibt->GetLeaf(fface, f1, f2);
-          int fid = nf->gid_;
-          int nlevel = nf->loc_.level();
+          auto nf = neibt.GetLeaf(fface, f1, f2);
+          int fid = nf.GetGid();
+          int nlevel = nf.GetLocation().level();
           int tbid = FindBufferID(-n, 0, 0, 0, 0);
-          neighbor[nneighbor].SetNeighbor(nf->loc_, ranklist[fid], nlevel, fid,
+          neighbor[nneighbor].SetNeighbor(nf.GetLocation(), ranklist[fid], nlevel, fid,
                                           fid - nslist[ranklist[fid]], n, 0, 0,
                                           NeighborConnect::face, bufid, tbid, f1, f2);
           bufid++;
@@ -386,8 +386,8 @@ void BoundaryBase::SearchAndSetNeighbors(
         }
       }
     } else { // neighbor at same or coarser level
-      int nlevel = neibt->loc_.level();
-      int nid = neibt->gid_;
+      int nlevel = neibt.GetLocation().level();
+      int nid = neibt.GetGid();
       nblevel[1][1][n + 1] = nlevel;
       int tbid;
       if (nlevel == loc.level()) { // neighbor at same level
@@ -395,7 +395,7 @@ void BoundaryBase::SearchAndSetNeighbors(
       } else { // neighbor at coarser level
         tbid = FindBufferID(-n, 0, 0, myfx2, myfx3);
       }
-      neighbor[nneighbor].SetNeighbor(neibt->loc_, ranklist[nid], nlevel, nid,
+      neighbor[nneighbor].SetNeighbor(neibt.GetLocation(), ranklist[nid], nlevel, nid,
                                       nid - nslist[ranklist[nid]], n, 0, 0,
                                       NeighborConnect::face, bufid, tbid);
       bufid += nf1 * nf2;
@@ -411,20 +411,20 @@ void BoundaryBase::SearchAndSetNeighbors(
   // x2 face
   for (int n = -1; n <= 1; n += 2) {
     neibt = tree.FindNeighbor(loc, 0, n, 0);
-    if (neibt == nullptr) {
+    if (!neibt) {
       bufid += nf1 * nf2;
       continue;
     }
-    if (neibt->pleaf_ != nullptr) { // neighbor at finer level
+    if (!neibt.IsLeaf()) { // neighbor at finer level
       int fface = 1 - (n + 1) / 2;  // 0 for BoundaryFace::outer_x2, 1 for inner_x2
-      nblevel[1][n + 1][1] = neibt->loc_.level() + 1;
+      nblevel[1][n + 1][1] = neibt.GetLocation().level() + 1;
       for (int f2 = 0; f2 < nf2; f2++) {
         for (int f1 = 0; f1 < nf1; f1++) {
-          MeshBlockTree *nf = neibt->GetLeaf(f1, fface, f2);
-          int fid = nf->gid_;
-          int nlevel = nf->loc_.level();
+          auto nf = neibt.GetLeaf(f1, fface, f2);
+          int fid = nf.GetGid();
+          int nlevel = nf.GetLocation().level();
           int tbid = FindBufferID(0, -n, 0, 0, 0);
-          neighbor[nneighbor].SetNeighbor(nf->loc_, ranklist[fid], nlevel, fid,
+          neighbor[nneighbor].SetNeighbor(nf.GetLocation(), ranklist[fid], nlevel, fid,
                                           fid - nslist[ranklist[fid]], 0, n, 0,
                                           NeighborConnect::face, bufid, tbid, f1, f2);
           bufid++;
@@ -432,8 +432,8 @@ void BoundaryBase::SearchAndSetNeighbors(
         }
       }
     } else { // neighbor at same or coarser level
-      int nlevel = neibt->loc_.level();
-      int nid = neibt->gid_;
+      int nlevel = neibt.GetLocation().level();
+      int nid = neibt.GetGid();
       nblevel[1][n + 1][1] = nlevel;
       int tbid;
       if (nlevel == loc.level()) { // neighbor at same level
@@ -441,7 +441,7 @@ void BoundaryBase::SearchAndSetNeighbors(
       } else { // neighbor at coarser level
         tbid = FindBufferID(0, -n, 0, myfx1, myfx3);
       }
-      neighbor[nneighbor].SetNeighbor(neibt->loc_, ranklist[nid], nlevel, nid,
+      neighbor[nneighbor].SetNeighbor(neibt.GetLocation(), ranklist[nid], nlevel, nid,
                                       nid - nslist[ranklist[nid]], 0, n, 0,
                                       NeighborConnect::face, bufid, tbid);
       bufid += nf1 * nf2;
@@ -453,20 +453,20 @@ void BoundaryBase::SearchAndSetNeighbors(
   if (!block_size_.symmetry(X3DIR)) {
     for (int n = -1; n <= 1; n += 2) {
       neibt = tree.FindNeighbor(loc, 0, 0, n);
-      if (neibt == nullptr) {
+      if (!neibt) {
         bufid += nf1 * nf2;
         continue;
       }
-      if (neibt->pleaf_ != nullptr) { // neighbor at finer level
+      if (!neibt.IsLeaf()) { // neighbor at finer level
         int fface = 1 - (n + 1) / 2;  // 0 for BoundaryFace::outer_x3, 1 for inner_x3
-        nblevel[n + 1][1][1] = neibt->loc_.level() + 1;
+        nblevel[n + 1][1][1] = neibt.GetLocation().level() + 1;
         for (int f2 = 0; f2 < nf2; f2++) {
           for (int f1 = 0; f1 < nf1; f1++) {
-            MeshBlockTree *nf = neibt->GetLeaf(f1, f2, fface);
-            int fid = nf->gid_;
-            int nlevel = nf->loc_.level();
+            auto nf = neibt.GetLeaf(f1, f2, fface);
+            int fid = nf.GetGid();
+            int nlevel = nf.GetLocation().level();
             int tbid = FindBufferID(0, 0, -n, 0, 0);
-            neighbor[nneighbor].SetNeighbor(nf->loc_, ranklist[fid], nlevel, fid,
+            neighbor[nneighbor].SetNeighbor(nf.GetLocation(), ranklist[fid], nlevel, fid,
                                             fid - nslist[ranklist[fid]], 0, 0, n,
                                             NeighborConnect::face, bufid, tbid, f1, f2);
             bufid++;
@@ -474,8 +474,8 @@ void BoundaryBase::SearchAndSetNeighbors(
           }
         }
       } else { // neighbor at same or coarser level
-        int nlevel = neibt->loc_.level();
-        int nid = neibt->gid_;
+        int nlevel = neibt.GetLocation().level();
+        int nid = neibt.GetGid();
         nblevel[n + 1][1][1] = nlevel;
         int tbid;
         if (nlevel == loc.level()) { // neighbor at same level
@@ -483,7 +483,7 @@ void BoundaryBase::SearchAndSetNeighbors(
         } else { // neighbor at coarser level
           tbid = FindBufferID(0, 0, -n, myfx1, myfx2);
         }
-        neighbor[nneighbor].SetNeighbor(neibt->loc_, ranklist[nid], nlevel, nid,
+        neighbor[nneighbor].SetNeighbor(neibt.GetLocation(), ranklist[nid], nlevel, nid,
                                         nid - nslist[ranklist[nid]], 0, 0, n,
                                         NeighborConnect::face, bufid, tbid);
         bufid += nf1 * nf2;
@@ -496,29 +496,29 @@ void BoundaryBase::SearchAndSetNeighbors(
   for (int m = -1; m <= 1; m += 2) {
     for (int n = -1; n <= 1; n += 2) {
       neibt = tree.FindNeighbor(loc, n, m, 0);
-      if (neibt == nullptr) {
+      if (!neibt) {
         bufid += nf2;
         continue;
       }
-      if (neibt->pleaf_ != nullptr) { // neighbor at finer level
+      if (!neibt.IsLeaf()) { // neighbor at finer level
         int ff1 = 1 - (n + 1) / 2;    // 0 for BoundaryFace::outer_x1, 1 for inner_x1
         int ff2 = 1 - (m + 1) / 2;    // 0 for BoundaryFace::outer_x2, 1 for inner_x2
 
-        nblevel[1][m + 1][n + 1] = neibt->loc_.level() + 1;
+        nblevel[1][m + 1][n + 1] = neibt.GetLocation().level() + 1;
         for (int f1 = 0; f1 < nf2; f1++) {
-          MeshBlockTree *nf = neibt->GetLeaf(ff1, ff2, f1);
-          int fid = nf->gid_;
-          int nlevel = nf->loc_.level();
+          auto nf = neibt.GetLeaf(ff1, ff2, f1);
+          int fid = nf.GetGid();
+          int nlevel = nf.GetLocation().level();
           int tbid = FindBufferID(-n, -m, 0, 0, 0);
-          neighbor[nneighbor].SetNeighbor(nf->loc_, ranklist[fid], nlevel, fid,
+          neighbor[nneighbor].SetNeighbor(nf.GetLocation(), ranklist[fid], nlevel, fid,
                                           fid - nslist[ranklist[fid]], n, m, 0,
                                           NeighborConnect::edge, bufid, tbid, f1, 0);
           bufid++;
           nneighbor++;
         }
       } else { // neighbor at same or coarser level
-        int nlevel = neibt->loc_.level();
-        int nid = neibt->gid_;
+        int nlevel = neibt.GetLocation().level();
+        int nid = neibt.GetGid();
         nblevel[1][m + 1][n + 1] = nlevel;
         int tbid;
         if (nlevel == loc.level()) { // neighbor at same level
@@ -527,7 +527,7 @@ void BoundaryBase::SearchAndSetNeighbors(
           tbid = FindBufferID(-n, -m, 0, myfx3, 0);
         }
         if (nlevel >= loc.level() || (myox1 == n && myox2 == m)) {
-          neighbor[nneighbor].SetNeighbor(neibt->loc_, ranklist[nid], nlevel, nid,
+          neighbor[nneighbor].SetNeighbor(neibt.GetLocation(), ranklist[nid], nlevel, nid,
                                           nid - nslist[ranklist[nid]], n, m, 0,
                                           NeighborConnect::edge, bufid, tbid);
           nneighbor++;
@@ -547,28 +547,28 @@ void BoundaryBase::SearchAndSetNeighbors(
   for (int m = -1; m <= 1; m += 2) {
     for (int n = -1; n <= 1; n += 2) {
       neibt = tree.FindNeighbor(loc, n, 0, m);
-      if (neibt == nullptr) {
+      if (!neibt) {
         bufid += nf1;
         continue;
       }
-      if (neibt->pleaf_ != nullptr) { // neighbor at finer level
+      if (!neibt.IsLeaf()) { // neighbor at finer level
         int ff1 = 1 - (n + 1) / 2;    // 0 for BoundaryFace::outer_x1, 1 for inner_x1
         int ff2 = 1 - (m + 1) / 2;    // 0 for BoundaryFace::outer_x3, 1 for inner_x3
-        nblevel[m + 1][1][n + 1] = neibt->loc_.level() + 1;
+        nblevel[m + 1][1][n + 1] = neibt.GetLocation().level() + 1;
         for (int f1 = 0; f1 < nf1; f1++) {
-          MeshBlockTree *nf = neibt->GetLeaf(ff1, f1, ff2);
-          int fid = nf->gid_;
-          int nlevel = nf->loc_.level();
+          auto nf = neibt.GetLeaf(ff1, f1, ff2);
+          int fid = nf.GetGid();
+          int nlevel = nf.GetLocation().level();
           int tbid = FindBufferID(-n, 0, -m, 0, 0);
-          neighbor[nneighbor].SetNeighbor(nf->loc_, ranklist[fid], nlevel, fid,
+          neighbor[nneighbor].SetNeighbor(nf.GetLocation(), ranklist[fid], nlevel, fid,
                                           fid - nslist[ranklist[fid]], n, 0, m,
                                           NeighborConnect::edge, bufid, tbid, f1, 0);
           bufid++;
           nneighbor++;
         }
       } else { // neighbor at same or coarser level
-        int nlevel = neibt->loc_.level();
-        int nid = neibt->gid_;
+        int nlevel = neibt.GetLocation().level();
+        int nid = neibt.GetGid();
         nblevel[m + 1][1][n + 1] = nlevel;
         int tbid;
         if (nlevel == loc.level()) { // neighbor at same level
@@ -577,7 +577,7 @@ void BoundaryBase::SearchAndSetNeighbors(
           tbid = FindBufferID(-n, 0, -m, myfx2, 0);
         }
         if (nlevel >= loc.level() || (myox1 == n && myox3 == m)) {
-          neighbor[nneighbor].SetNeighbor(neibt->loc_, ranklist[nid], nlevel, nid,
+          neighbor[nneighbor].SetNeighbor(neibt.GetLocation(), ranklist[nid], nlevel, nid,
                                           nid - nslist[ranklist[nid]], n, 0, m,
                                           NeighborConnect::edge, bufid, tbid);
           nneighbor++;
@@ -591,28 +591,28 @@ void BoundaryBase::SearchAndSetNeighbors(
   for (int m = -1; m <= 1; m += 2) {
     for (int n = -1; n <= 1; n += 2) {
       neibt = tree.FindNeighbor(loc, 0, n, m);
-      if (neibt == nullptr) {
+      if (!neibt) {
         bufid += nf1;
         continue;
       }
-      if (neibt->pleaf_ != nullptr) { // neighbor at finer level
+      if (!neibt.IsLeaf()) { // neighbor at finer level
         int ff1 = 1 - (n + 1) / 2;    // 0 for BoundaryFace::outer_x2, 1 for inner_x2
         int ff2 = 1 - (m + 1) / 2;    // 0 for BoundaryFace::outer_x3, 1 for inner_x3
-        nblevel[m + 1][n + 1][1] = neibt->loc_.level() + 1;
+        nblevel[m + 1][n + 1][1] = neibt.GetLocation().level() + 1;
         for (int f1 = 0; f1 < nf1; f1++) {
-          MeshBlockTree *nf = neibt->GetLeaf(f1, ff1, ff2);
-          int fid = nf->gid_;
-          int nlevel = nf->loc_.level();
+          auto nf = neibt.GetLeaf(f1, ff1, ff2);
+          int fid = nf.GetGid();
+          int nlevel = nf.GetLocation().level();
           int tbid = FindBufferID(0, -n, -m, 0, 0);
-          neighbor[nneighbor].SetNeighbor(nf->loc_, ranklist[fid], nlevel, fid,
+          neighbor[nneighbor].SetNeighbor(nf.GetLocation(), ranklist[fid], nlevel, fid,
                                           fid - nslist[ranklist[fid]], 0, n, m,
                                           NeighborConnect::edge, bufid, tbid, f1, 0);
           bufid++;
           nneighbor++;
         }
       } else { // neighbor at same or coarser level
-        int nlevel = neibt->loc_.level();
-        int nid = neibt->gid_;
+        int nlevel = neibt.GetLocation().level();
+        int nid = neibt.GetGid();
         nblevel[m + 1][n + 1][1] = nlevel;
         int tbid;
         if (nlevel == loc.level()) { // neighbor at same level
@@ -621,7 +621,7 @@ void BoundaryBase::SearchAndSetNeighbors(
           tbid = FindBufferID(0, -n, -m, myfx1, 0);
         }
         if (nlevel >= loc.level() || (myox2 == n && myox3 == m)) {
-          neighbor[nneighbor].SetNeighbor(neibt->loc_, ranklist[nid], nlevel, nid,
+          neighbor[nneighbor].SetNeighbor(neibt.GetLocation(), ranklist[nid], nlevel, nid,
                                           nid - nslist[ranklist[nid]], 0, n, m,
                                           NeighborConnect::edge, bufid, tbid);
           nneighbor++;
@@ -636,22 +636,22 @@ void BoundaryBase::SearchAndSetNeighbors(
     for (int m = -1; m <= 1; m += 2) {
       for (int n = -1; n <= 1; n += 2) {
         neibt = tree.FindNeighbor(loc, n, m, l);
-        if (neibt == nullptr) {
+        if (!neibt) {
           bufid++;
           continue;
         }
-        if (neibt->pleaf_ != nullptr) { // neighbor at finer level
+        if (!neibt.IsLeaf()) { // neighbor at finer level
           int ff1 = 1 - (n + 1) / 2;    // 0 for BoundaryFace::outer_x1, 1 for inner_x1
           int ff2 = 1 - (m + 1) / 2;    // 0 for BoundaryFace::outer_x2, 1 for inner_x2
           int ff3 = 1 - (l + 1) / 2;    // 0 for BoundaryFace::outer_x3, 1 for inner_x3
-          neibt = neibt->GetLeaf(ff1, ff2, ff3);
+          neibt = neibt.GetLeaf(ff1, ff2, ff3);
         }
-        int nlevel = neibt->loc_.level();
+        int nlevel = neibt.GetLocation().level();
         nblevel[l + 1][m + 1][n + 1] = nlevel;
         if (nlevel >= loc.level() || (myox1 == n && myox2 == m && myox3 == l)) {
-          int nid = neibt->gid_;
+          int nid = neibt.GetGid();
           int tbid = FindBufferID(-n, -m, -l, 0, 0);
-          neighbor[nneighbor].SetNeighbor(neibt->loc_, ranklist[nid], nlevel, nid,
+          neighbor[nneighbor].SetNeighbor(neibt.GetLocation(), ranklist[nid], nlevel, nid,
                                           nid - nslist[ranklist[nid]], n, m, l,
                                           NeighborConnect::corner, bufid, tbid);
           nneighbor++;
@@ -665,6 +665,23 @@ void BoundaryBase::SearchAndSetNeighbors(
   Kokkos::Profiling::popRegion(); // SearchAndSetNeighbors
 }
 
+//----------------------------------------------------------------------------------------
+// \!fn void BoundaryBase::UpdateNeighborIds(MeshBlockTree &tree,
+//                                           int *ranklist, int *nslist)
+// \brief Update the global/local ids and ranks of the neighbor blocks without searching
+//        the tree for the neighbors again. Only valid if the neighbors of this block
+//        did not change since the last call of SearchAndSetNeighbors.
+
+void BoundaryBase::UpdateNeighborIds(MeshBlockTree &tree, int *ranklist, int *nslist) {
+  for (int n = 0; n < nneighbor; ++n) {
+    auto &snb = neighbor[n].snb;
+    snb.gid = tree.FindMeshBlock(neighbor[n].loc).GetGid();
+    PARTHENON_REQUIRE(snb.gid >= 0, "Neighbor block is not a leaf of the tree.");
+    snb.rank = ranklist[snb.gid];
+    snb.lid = snb.gid - nslist[snb.rank];
+  }
+}
+
 void BoundaryBase::SetNeighborOwnership(
     const std::unordered_set<LogicalLocation> &newly_refined) {
   // Set neighbor block ownership
@@ -165,7 +165,16 @@ void EvolutionDriver::PostExecute(DriverStatus status) {
       std::cout << std::endl
                 << "Number of MeshBlocks = " << pmesh->nbtotal << "; " << pmesh->nbnew
                 << "  created, " << pmesh->nbdel << " destroyed during this simulation."
-                << std::endl;
+                << std::endl
+                << "Mesh modified " << pmesh->nremesh << " times, taking "
+                << pmesh->remesh_time << " s." << std::endl;
+    }
+    auto pool = pmesh->GetVariableStoragePool();
+    if (pool != nullptr && pool->Released() + pool->Dropped() > 0) {
+      std::cout << "Variable storage pool: " << pool->Hits() << " reused, "
+                << pool->Misses() << " new allocations, " << pool->Dropped()
+                << " freed over the limit, " << pool->SizeInBytes() << " bytes held ("
+                << pool->PeakSizeInBytes() << " at most) (rank 0)." << std::endl;
     }
   }
   Driver::PostExecute(status);
@@ -180,12 +189,15 @@ void EvolutionDriver::InitializeBlockTimeStepsAndBoundaries() {
   pmesh->boundary_comm_map.clear();
   pmesh->boundary_comm_flxcor_map.clear();
   const int num_partitions = pmesh->DefaultNumPartitions();
+  // "base" is the first stage of the leaf and of every GMG collection
+  const int base_id = pmesh->mesh_data.GetStageId("base");
   for (int i = 0; i < num_partitions; i++) {
-    auto &mbase = pmesh->mesh_data.GetOrAdd("base", i);
+    auto &mbase = pmesh->mesh_data.GetOrAddPartition(base_id, i);
     Update::EstimateTimestep(mbase.get());
     BuildBoundaryBuffers(mbase);
     for (int gmg_level = 0; gmg_level < pmesh->gmg_mesh_data.size(); ++gmg_level) {
-      auto &mdg = pmesh->gmg_mesh_data[gmg_level].GetOrAdd(gmg_level, "base", i);
+      auto &mdg =
+          pmesh->gmg_mesh_data[gmg_level].GetOrAddPartition(base_id, i, gmg_level);
       BuildBoundaryBuffers(mdg);
       BuildGMGBoundaryBuffers(mdg);
     }
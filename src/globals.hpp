@@ -33,6 +33,10 @@ struct SparseConfig {
   Real allocation_threshold = 1.0e-12;
   Real deallocation_threshold = 1.0e-14;
   int deallocation_count = 5;
+  // number of calls of Update::SparseDealloc between checks for deallocation
+  int deallocation_interval = 1;
+  // only check the interior instead of all cells of a block for deallocation
+  bool deallocation_interior_only = false;
 };
 
 extern int my_rank, nranks, nghost;
@@ -17,7 +17,7 @@
 #include "interface/mesh_data.hpp"
 #include "interface/meshblock_data.hpp"
 #include "mesh/mesh.hpp"
-#include "utils/partition_stl_containers.hpp"
+#include "utils/error_checking.hpp"
 
 namespace parthenon {
 
@@ -71,51 +71,46 @@ DataCollection<T>::AddShallow(const std::string &name,
   return Add(name, containers_["base"], field_names, true);
 }
 
+template <>
 std::shared_ptr<MeshData<Real>> &
-GetOrAdd_impl(Mesh *pmy_mesh_,
-              std::map<std::string, std::shared_ptr<MeshData<Real>>> &containers_,
-              BlockList_t &block_list, const std::string &mbd_label,
-              const int &partition_id, const int gmg_level) {
-  std::string label = mbd_label + "_part-" + std::to_string(partition_id);
-  if (gmg_level >= 0) label = label + "_gmg-" + std::to_string(gmg_level);
-  auto it = containers_.find(label);
-  if (it == containers_.end()) {
-    // TODO(someone) add caching of partitions to Mesh at some point
-    const int pack_size = pmy_mesh_->DefaultPackSize();
-    auto partitions = partition::ToSizeN(block_list, pack_size);
-    // Account for possibly empty block_list
-    if (partitions.size() == 0) partitions = std::vector<BlockList_t>(1);
-    for (auto i = 0; i < partitions.size(); i++) {
-      std::string md_label = mbd_label + "_part-" + std::to_string(i);
-      if (gmg_level >= 0) md_label = md_label + "_gmg-" + std::to_string(gmg_level);
-      containers_[md_label] = std::make_shared<MeshData<Real>>(mbd_label);
-      containers_[md_label]->Set(partitions[i], pmy_mesh_);
+DataCollection<MeshData<Real>>::GetOrAddPartition(int stage_id, int partition_id,
+                                                  int gmg_level) {
+  PARTHENON_DEBUG_REQUIRE(stage_id >= 0 && stage_id < stage_labels_.size(),
+                          "Unknown stage id");
+  if (stage_id >= partitions_.size()) partitions_.resize(stage_labels_.size());
+  auto &stage = partitions_[stage_id];
+  if (stage.empty()) {
+    const auto &partitions = pmy_mesh_->GetDefaultBlockPartitions(gmg_level);
+    stage.resize(partitions.size());
+    for (int i = 0; i < partitions.size(); i++) {
+      stage[i] = std::make_shared<MeshData<Real>>(stage_labels_[stage_id]);
+      stage[i]->Set(partitions[i], pmy_mesh_);
       if (gmg_level >= 0) {
         int min_gmg_logical_level = pmy_mesh_->GetGMGMinLogicalLevel();
-        containers_[md_label]->grid = GridIdentifier{GridType::two_level_composite,
-                                                     gmg_level + min_gmg_logical_level};
+        stage[i]->grid = GridIdentifier{GridType::two_level_composite,
+                                        gmg_level + min_gmg_logical_level};
       } else {
-        containers_[md_label]->grid = GridIdentifier{GridType::leaf, 0};
+        stage[i]->grid = GridIdentifier{GridType::leaf, 0};
       }
     }
   }
-  return containers_[label];
+  PARTHENON_DEBUG_REQUIRE(partition_id >= 0 && partition_id < stage.size(),
+                          "Partition id out of range");
+  return stage[partition_id];
 }
 
 template <>
 std::shared_ptr<MeshData<Real>> &
 DataCollection<MeshData<Real>>::GetOrAdd(const std::string &mbd_label,
                                          const int &partition_id) {
-  return GetOrAdd_impl(pmy_mesh_, containers_, pmy_mesh_->block_list, mbd_label,
-                       partition_id, -1);
+  return GetOrAddPartition(GetStageId(mbd_label), partition_id);
 }
 
 template <>
 std::shared_ptr<MeshData<Real>> &
 DataCollection<MeshData<Real>>::GetOrAdd(int gmg_level, const std::string &mbd_label,
                                          const int &partition_id) {
-  return GetOrAdd_impl(pmy_mesh_, containers_, pmy_mesh_->gmg_block_lists[gmg_level],
-                       mbd_label, partition_id, gmg_level);
+  return GetOrAddPartition(GetStageId(mbd_label), partition_id, gmg_level);
 }
 
 template class DataCollection<MeshData<Real>>;
@@ -24,6 +24,8 @@ class Mesh;
 /// The DataCollection class is an abstract container that contains at least a
 /// "base" container of some type (e.g., of MeshData or MeshBlockData) plus
 /// additional containers identified by string labels.
+/// The MeshData of the partitions of the mesh are stored separately, by an integer stage
+/// id (see GetStageId) and partition id, to keep string operations out of the lookup.
 /// Current usage includes (but is not limited to) storing MeshBlockData for different
 /// stages in multi-stage drivers or the corresponding MeshBlockPacks in a
 /// DataCollection of MeshData.
@@ -37,6 +39,7 @@ class DataCollection {
  public:
   DataCollection() {
     containers_["base"] = std::make_shared<T>("base"); // always add "base" container
+    GetStageId("base"); // so that it has the same stage id (0) in every collection
     pmy_mesh_ = nullptr;
   }
 
@@ -78,6 +81,25 @@ class DataCollection {
   std::shared_ptr<T> &GetOrAdd(int gmg_level, const std::string &mbd_label,
                                const int &partition_id);
 
+  // Id of the stage with the given label, which does not change for the lifetime of the
+  // collection and can be stored to look up partitions without the label
+  int GetStageId(const std::string &label) {
+    auto it = stage_ids_.find(label);
+    if (it != stage_ids_.end()) return it->second;
+    const int stage_id = stage_labels_.size();
+    stage_ids_.emplace(label, stage_id);
+    stage_labels_.push_back(label);
+    return stage_id;
+  }
+  // Partition partition_id of stage stage_id on GMG level gmg_level (or the leaf grid for
+  // gmg_level < 0). All partitions of a stage are created on first use from the
+  // partitions cached by the Mesh. A collection only holds partitions of a single grid.
+  std::shared_ptr<T> &GetOrAddPartition(int stage_id, int partition_id,
+                                        int gmg_level = -1);
+  // Partitions by stage id, entries of stages that were not used yet are empty
+  auto &Partitions() { return partitions_; }
+  const auto &Partitions() const { return partitions_; }
+
   void PurgeNonBase() {
     auto c = containers_.begin();
     while (c != containers_.end()) {
@@ -87,11 +109,17 @@ class DataCollection {
         ++c;
       }
     }
+    partitions_.clear();
   }
 
  private:
   Mesh *pmy_mesh_;
   std::map<std::string, std::shared_ptr<T>> containers_;
+  std::map<std::string, int> stage_ids_;
+  std::vector<std::string> stage_labels_;
+  // Only the outer vector grows, so references to the partitions remain valid when
+  // new stages are added
+  std::vector<std::vector<std::shared_ptr<T>>> partitions_;
 };
 
 } // namespace parthenon
@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "basic_types.hpp"
 #include "bvals/comms/bnd_info.hpp"
 #include "interface/sparse_pack_base.hpp"
 #include "interface/variable_pack.hpp"
@@ -187,6 +188,25 @@ struct GridIdentifier {
   int logical_level = 0;
 };
 
+// Persistent state of Update::SparseDealloc on a MeshData
+struct SparseDeallocState {
+  // number of calls, to only check every Globals::sparse_config.deallocation_interval
+  int ncalls = 0;
+  // whether each variable of the pack is below its deallocation threshold on each block,
+  // only reallocated when the pack grows
+  ParArray2D<bool> is_zero;
+  HostArray2D<bool> is_zero_h;
+};
+
+// Per-block arrays of Refinement::DerivativeTagger on a MeshData, so that partitions
+// tagged concurrently do not share them. Reallocated when the number of blocks changes.
+struct RefinementTagArrays {
+  ParArray1D<AmrTag> tags;
+  HostArray1D<AmrTag> tags_h;
+  ParArray1D<int> levels;
+  HostArray1D<int> levels_h;
+};
+
 /// The MeshData class is a container for cached MeshBlockPacks, i.e., it
 /// contains both the pointers to the MeshBlockData of the MeshBlocks contained
 /// in the object as well as maps to the cached MeshBlockPacks of VariablePacks or
@@ -217,6 +237,8 @@ class MeshData {
   }
 
   auto &GetBvarsCache() { return bvars_cache_; }
+  auto &GetSparseDeallocState() { return sparse_dealloc_state_; }
+  auto &GetRefinementTagArrays() { return refinement_tag_arrays_; }
 
   template <class... Ts>
   IndexRange GetBoundsI(Ts &&...args) const {
@@ -305,7 +327,12 @@ class MeshData {
   template <typename... Args>
   const auto &PackVariablesImpl(PackIndexMap *map_out, bool coarse, Args &&...args) {
     auto pack_function = [&](std::shared_ptr<MeshBlockData<T>> meshblock_data,
-                             PackIndexMap &map, vpack_types::VPackKey_t &key) {
+                             PackIndexMap &map,
+                             vpack_types::VPackKey_t &key) -> const VariablePack<T> & {
+      if (read_only_packs_) {
+        return meshblock_data->PackVariablesReadOnly(std::forward<Args>(args)..., map,
+                                                     key, coarse);
+      }
       return meshblock_data->PackVariables(std::forward<Args>(args)..., map, key, coarse);
     };
     return pack_on_mesh_impl::PackOnMesh<VariablePack<T>, vpack_types::VPackKey_t>(
@@ -411,6 +438,20 @@ class MeshData {
     return PackVariablesImpl(nullptr, coarse);
   }
 
+  // See MeshBlockData::PackVariablesReadOnly
+  template <class... Args>
+  const auto &PackVariablesReadOnly(Args &&...args) {
+    read_only_packs_ = true;
+    try {
+      const auto &pack = PackVariables(std::forward<Args>(args)...);
+      read_only_packs_ = false;
+      return pack;
+    } catch (...) {
+      read_only_packs_ = false;
+      throw;
+    }
+  }
+
   void ClearCaches() {
     sparse_pack_cache_.clear();
     block_data_.clear();
@@ -452,6 +493,10 @@ class MeshData {
   SparsePackCache sparse_pack_cache_;
   // caches for boundary information
   BvarsCache_t bvars_cache_;
+  SparseDeallocState sparse_dealloc_state_;
+  RefinementTagArrays refinement_tag_arrays_;
+  // set while building a pack with PackVariablesReadOnly
+  bool read_only_packs_ = false;
 };
 
 template <typename T, typename... Args>
@@ -18,6 +18,8 @@
 #include <memory>
 #include <set>
 #include <sstream>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -54,6 +56,18 @@ void MeshBlockData<T>::Initialize(
     AddField(q.first.base_name, q.second, q.first.sparse_id);
   }
 
+  // allocate the variables that are not sparse, in the arena of the block if enabled
+  VariableVector<T> dense_vars;
+  for (auto &v : varVector_) {
+    if (!Globals::sparse_config.enabled || !v->IsSparse()) dense_vars.push_back(v);
+  }
+  SetArena_(dense_vars);
+  for (auto &v : dense_vars) {
+    v->arena_ = arena_;
+    v->arena_block_ = arena_block_;
+    v->Allocate(pmy_block);
+  }
+
   Metadata::FlagCollection flags({Metadata::Sparse, Metadata::ForceAllocOnNewBlocks});
   auto vars = GetVariablesByFlag(flags);
   for (auto &v : vars.vars()) {
@@ -62,8 +76,8 @@ void MeshBlockData<T>::Initialize(
 }
 
 ///
-/// The internal routine for adding a new field.  This subroutine
-/// is topology aware and will allocate accordingly.
+/// The internal routine for adding a new field.  The field is not
+/// allocated, which is left to Initialize.
 ///
 /// @param label the name of the variable
 /// @param metadata the metadata associated with the variable
@@ -73,10 +87,43 @@ void MeshBlockData<T>::AddField(const std::string &base_name, const Metadata &me
                                 int sparse_id) {
   auto pvar = std::make_shared<Variable<T>>(base_name, metadata, sparse_id, pmy_block);
   Add(pvar);
+}
+
+/// Set the arena holding the data of vars, in order. The arena is shared by all local
+/// blocks if parthenon/mesh/mesh_variable_storage is true, and there is none if
+/// parthenon/mesh/variable_arena is false.
+template <typename T>
+void MeshBlockData<T>::SetArena_(const VariableVector<T> &vars) {
+  arena_ = nullptr;
+  arena_block_ = 0;
+  auto pmb = pmy_block.lock();
+  if (pmb == nullptr || pmb->pmy_mesh == nullptr) return;
+  auto pmesh = pmb->pmy_mesh;
+  const auto &options = pmesh->GetVariableArenaOptions();
+  if (!options.enabled || vars.empty()) return;
+
+  // blocks that are not in the block list, e.g. of the multigrid hierarchy, get an
+  // arena of their own
+  const int nblocks = pmesh->block_list.size();
+  if (options.mesh_wide && pmb->lid >= 0 && pmb->lid < nblocks) {
+    auto &arena = pmesh->mesh_arenas_[stage_name_];
+    if (arena == nullptr) {
+      arena = std::make_shared<VariableArena<T>>(options);
+      for (const auto &v : vars) {
+        arena->Add(v->label(), v->dims_, nblocks);
+      }
+      arena->Allocate(stage_name_ + ".mesh_arena");
+    }
+    arena_ = arena;
+    arena_block_ = pmb->lid;
+    return;
+  }
 
-  if (!Globals::sparse_config.enabled || !pvar->IsSparse()) {
-    pvar->Allocate(pmy_block);
+  arena_ = std::make_shared<VariableArena<T>>(options);
+  for (const auto &v : vars) {
+    arena_->Add(v->label(), v->dims_);
   }
+  arena_->Allocate(stage_name_ + ".arena");
 }
 
 // TODO(JMM): Move to unique IDs at some point
@@ -89,19 +136,14 @@ void MeshBlockData<T>::Initialize(const MeshBlockData<T> *src,
   resolved_packages_ = src->resolved_packages_;
   is_shallow_ = shallow_copy;
 
-  auto add_var = [=](auto var) {
-    if (shallow_copy || var->IsSet(Metadata::OneCopy)) {
-      Add(var);
-    } else {
-      Add(var->AllocateCopy(pmy_block));
-    }
+  auto is_copied = [=](const auto &var) {
+    return !shallow_copy && !var->IsSet(Metadata::OneCopy);
   };
 
   // special case when the list of names is empty, copy everything
+  VariableVector<T> src_vars;
   if (names.empty()) {
-    for (auto v : src->GetVariableVector()) {
-      add_var(v);
-    }
+    src_vars = src->GetVariableVector();
   } else {
     auto var_map = src->GetVariableMap();
 
@@ -110,12 +152,77 @@ void MeshBlockData<T>::Initialize(const MeshBlockData<T> *src,
       auto v = var_map.find(name);
       if (v != var_map.end()) {
         found = true;
-        add_var(v->second);
+        src_vars.push_back(v->second);
       }
       PARTHENON_REQUIRE_THROWS(found, "MeshBlockData::CopyFrom: Variable '" + name +
                                           "' not found");
     }
   }
+
+  // With parthenon/mesh/copy_on_write_stages, dense variables that are not filled by the
+  // boundary communication share the data of src until they are written
+  auto pmb = pmy_block.lock();
+  const bool copy_on_write =
+      pmb != nullptr && pmb->pmy_mesh != nullptr && pmb->pmy_mesh->CopyOnWriteStages();
+  auto is_shared = [=](const auto &var) {
+    return copy_on_write && is_copied(var) && var->IsAllocated() && !var->IsSparse() &&
+           !var->IsSet(Metadata::FillGhost) && !var->IsSet(Metadata::GMGProlongate) &&
+           !var->IsSet(Metadata::GMGRestrict);
+  };
+
+  // the copies of allocated variables that are not sparse share an arena if enabled
+  VariableVector<T> dense_vars;
+  for (const auto &v : src_vars) {
+    if (is_copied(v) && !is_shared(v) && v->IsAllocated() &&
+        (!Globals::sparse_config.enabled || !v->IsSparse())) {
+      dense_vars.push_back(v);
+    }
+  }
+  SetArena_(dense_vars);
+
+  nshared_ = 0;
+  for (const auto &v : src_vars) {
+    if (is_shared(v)) {
+      Add(v->ShareCopy(pmy_block));
+      nshared_++;
+    } else if (is_copied(v)) {
+      Add(v->AllocateCopy(pmy_block, arena_, arena_block_));
+    } else {
+      Add(v);
+    }
+  }
+}
+
+template <typename T>
+bool MeshBlockData<T>::MakeWritable(const VariableVector<T> &vars) {
+  if (nshared_ == 0) return false;
+  bool changed = false;
+  for (const auto &v : vars) {
+    if (!v->IsShared()) continue;
+    v->MakeWritable(GetBlockPointer());
+    nshared_--;
+    changed = true;
+  }
+  // invalidate the sparse packs holding the shared data
+  if (changed) GetBlockPointer()->IncrementAllocationEpoch();
+  return changed;
+}
+
+template <typename T>
+void MeshBlockData<T>::CheckScratchFluxes(const VariableVector<T> &vars) {
+  // labels of the variables by the start of their fluxes
+  std::unordered_map<const T *, std::string> scratch;
+  for (const auto &v : vars) {
+    if (!v->IsAllocated() || !v->IsSet(Metadata::WithFluxes) ||
+        !v->IsSet(Metadata::ScratchFluxes)) {
+      continue;
+    }
+    const auto [it, unique] = scratch.emplace(v->flux[X1DIR].data(), v->label());
+    PARTHENON_REQUIRE_THROWS(unique, "The fluxes of " + it->second + " and " +
+                                         v->label() +
+                                         " share their Metadata::ScratchFluxes storage "
+                                         "and cannot be in the same flux pack");
+  }
 }
 
 /// Queries related to variable packs
@@ -131,6 +238,9 @@ template <typename T>
 const VariableFluxPack<T> &MeshBlockData<T>::PackListedVariablesAndFluxes(
     const VarList &var_list, const VarList &flux_list, PackIndexMap *map,
     vpack_types::UidVecPair *key) {
+  if (MakeWritable(var_list.vars())) {
+    return PackListedVariablesAndFluxes(RebuildVarList_(var_list), flux_list, map, key);
+  }
   auto keys = std::make_pair(var_list.unique_ids(), flux_list.unique_ids());
 
   auto itr = varFluxPackMap_.find(keys);
@@ -149,6 +259,7 @@ const VariableFluxPack<T> &MeshBlockData<T>::PackListedVariablesAndFluxes(
   }
 
   if (make_new_pack) {
+    CheckScratchFluxes(flux_list.vars());
     FluxPackIndxPair<T> new_item;
     new_item.alloc_status = var_list.alloc_status();
     new_item.flux_alloc_status = flux_list.alloc_status();
@@ -183,6 +294,18 @@ const VariablePack<T> &
 MeshBlockData<T>::PackListedVariables(const VarList &var_list, bool coarse,
                                       PackIndexMap *map,
                                       vpack_types::VPackKey_t *key_out) {
+  if (coarse) {
+    // a VariablePack has no way to mark the blocks whose coarse buffers were released
+    auto pmb = pmy_block.lock();
+    PARTHENON_REQUIRE_THROWS(pmb == nullptr || pmb->pmy_mesh == nullptr ||
+                                 !pmb->pmy_mesh->LazyCoarseBuffers(),
+                             "Coarse VariablePacks are not supported with "
+                             "parthenon/mesh/lazy_coarse_buffers, use a sparse pack with "
+                             "PDOpt::Coarse instead");
+  }
+  if (!read_only_packs_ && MakeWritable(var_list.vars())) {
+    return PackListedVariables(RebuildVarList_(var_list), coarse, map, key_out);
+  }
   const auto &key = var_list.unique_ids();
   auto &packmap = coarse ? coarseVarPackMap_ : varPackMap_;
 
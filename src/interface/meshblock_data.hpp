@@ -137,6 +137,13 @@ class MeshBlockData {
 
   const auto &GetUidMap() const { return varUidMap_; }
 
+  // Get a variable for writing. A variable that shares the data of the container it was
+  // copied from (see NumSharedVariables) gets a private copy of it first.
+  Variable<T> &Get(const std::string &base_name, int sparse_id = InvalidSparseID) {
+    return GetWritable_(GetVarPtr(MakeVarLabel(base_name, sparse_id)));
+  }
+  Variable<T> &Get(const Uid_t &uid) { return GetWritable_(GetVarPtr(uid)); }
+  // Get a variable for reading, without copying shared data, which must not be written
   Variable<T> &Get(const std::string &base_name, int sparse_id = InvalidSparseID) const {
     return *GetVarPtr(MakeVarLabel(base_name, sparse_id));
   }
@@ -363,6 +370,22 @@ class MeshBlockData {
     return PackVariablesImpl({}, coarse, nullptr, nullptr);
   }
 
+  /// Pack variables, taking the arguments of PackVariables, for reading only. Unlike
+  /// PackVariables, this does not make the variables writable (see MakeWritable), so
+  /// the pack must not be written.
+  template <class... ARGS>
+  const VariablePack<T> &PackVariablesReadOnly(ARGS &&...args) {
+    read_only_packs_ = true;
+    try {
+      const auto &pack = PackVariables(std::forward<ARGS>(args)...);
+      read_only_packs_ = false;
+      return pack;
+    } catch (...) {
+      read_only_packs_ = false;
+      throw;
+    }
+  }
+
   /// Remove a variable from the container or throw exception if not
   /// found.
   /// @param label the name of the variable to be deleted
@@ -413,10 +436,44 @@ class MeshBlockData {
   }
 
   bool IsShallow() const { return is_shallow_; }
+  // Contiguous storage of the data of the dense variables allocated by this container,
+  // nullptr unless parthenon/mesh/variable_arena is true. With
+  // parthenon/mesh/mesh_variable_storage it is shared by all local blocks and the data
+  // of this block is at GetArenaBlock().
+  const std::shared_ptr<VariableArena<T>> &GetArena() const { return arena_; }
+  int GetArenaBlock() const { return arena_block_; }
+
+  // Number of variables that share the data of the container they were copied from,
+  // with parthenon/mesh/copy_on_write_stages
+  int NumSharedVariables() const { return nshared_; }
+  // Give the variables that share the data of the container they were copied from a
+  // private copy of it, which has to happen before they are written. VariablePacks and
+  // SparsePacks do this for their variables, unless they are built with
+  // PackVariablesReadOnly or PDOpt::ReadOnly, and so does the non-const Get. Returns
+  // whether any variable was copied.
+  bool MakeWritable(const VariableVector<T> &vars);
+  bool MakeWritable(const std::string &label) { return MakeWritable({GetVarPtr(label)}); }
+
+  // Throws if the fluxes of several of vars are the same Metadata::ScratchFluxes storage,
+  // which a flux pack of them would read as the fluxes of every one of them
+  static void CheckScratchFluxes(const VariableVector<T> &vars);
 
  private:
   void AddField(const std::string &base_name, const Metadata &metadata,
                 int sparse_id = InvalidSparseID);
+  void SetArena_(const VariableVector<T> &vars);
+  Variable<T> &GetWritable_(const std::shared_ptr<Variable<T>> &var) {
+    if (var->IsShared()) MakeWritable({var});
+    return *var;
+  }
+  // the same variables with their current allocation status
+  static VarList RebuildVarList_(const VarList &var_list) {
+    VarList rebuilt;
+    for (const auto &v : var_list.vars()) {
+      rebuilt.Add(v);
+    }
+    return rebuilt;
+  }
 
   void Add(std::shared_ptr<Variable<T>> var) noexcept {
     varVector_.push_back(var);
@@ -439,6 +496,7 @@ class MeshBlockData {
                              "Tried to allocate non-sparse variable " + label);
 
     var->Allocate(pmy_block, flag_uninitialized);
+    GetBlockPointer()->IncrementAllocationEpoch();
 
     return var;
   }
@@ -461,6 +519,7 @@ class MeshBlockData {
       std::int64_t bytes = var->Deallocate();
       auto pmb = GetBlockPointer();
       pmb->LogMemUsage(-bytes);
+      pmb->IncrementAllocationEpoch();
     }
   }
 
@@ -468,6 +527,11 @@ class MeshBlockData {
   std::shared_ptr<StateDescriptor> resolved_packages_;
   bool is_shallow_ = false;
   const std::string stage_name_;
+  std::shared_ptr<VariableArena<T>> arena_;
+  int arena_block_ = 0;
+  int nshared_ = 0;
+  // set while building a pack with PackVariablesReadOnly
+  bool read_only_packs_ = false;
 
   VariableVector<T> varVector_; ///< the saved variable array
   std::map<Uid_t, std::shared_ptr<Variable<T>>> varUidMap_;
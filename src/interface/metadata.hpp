@@ -115,7 +115,9 @@
   /** the variable participate in GMG calculations */                                    \
   PARTHENON_INTERNAL_FOR_FLAG(GMGRestrict)                                               \
   /** the variable must always be allocated for new blocks **/                           \
-  PARTHENON_INTERNAL_FOR_FLAG(ForceAllocOnNewBlocks)
+  PARTHENON_INTERNAL_FOR_FLAG(ForceAllocOnNewBlocks)                                     \
+  /** the fluxes share storage with other such variables of the same shape */            \
+  PARTHENON_INTERNAL_FOR_FLAG(ScratchFluxes)
 namespace parthenon {
 
 namespace internal {
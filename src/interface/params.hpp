@@ -17,6 +17,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <typeindex>
 #include <typeinfo>
 #include <unordered_set>
@@ -45,6 +46,26 @@ class Params {
   // can't copy because we have a map of unique_ptr
   Params(const Params &p) = delete;
 
+  // Typed reference to a parameter that reads it without looking up its key, e.g. to
+  // look up a parameter once at initialization and read it in every task. Updates of the
+  // parameter are visible through the handle, which stays valid for the lifetime of the
+  // Params or until reset is called.
+  template <typename T>
+  class Handle {
+   public:
+    Handle() = default;
+
+    const T &operator*() const { return **value_; }
+    const T *operator->() const { return value_->get(); }
+    const T &Get() const { return **value_; }
+    bool IsValid() const { return value_ != nullptr; }
+
+   private:
+    friend class Params;
+    explicit Handle(const std::unique_ptr<T> *value) : value_(value) {}
+    const std::unique_ptr<T> *value_ = nullptr;
+  };
+
   /// Adds object based on type of the value
   ///
   /// Throws an error if the key is already in use
@@ -70,7 +91,13 @@ class Params {
                              "Parameter " + key + " must be marked as mutable");
     PARTHENON_REQUIRE_THROWS(myTypes_.at(key) == std::type_index(typeid(T)),
                              "WRONG TYPE FOR KEY '" + key + "'");
-    myParams_[key] = std::unique_ptr<Params::base_t>(new object_t<T>(value));
+    // update in place, so that handles and pointers to the parameter remain valid
+    auto typed_ptr = GetTypedPointer_<T>(key);
+    if constexpr (std::is_copy_assignable_v<T>) {
+      *typed_ptr->pValue = value;
+    } else {
+      typed_ptr->pValue = std::make_unique<T>(value);
+    }
   }
 
   void reset() {
@@ -85,6 +112,12 @@ class Params {
     return *typed_ptr->pValue;
   }
 
+  // Handle to read the parameter repeatedly without the lookup by key, see Handle
+  template <typename T>
+  Handle<T> GetHandle(const std::string &key) const {
+    return Handle<T>(&GetTypedPointer_<T>(key)->pValue);
+  }
+
   // Returning a pointer feels safer than returning a non-const reference.
   // Memory is managed by params so we don't want reference counting.
   // But we also don't want the reference completely re-assigned.
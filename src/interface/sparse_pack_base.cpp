@@ -28,6 +28,7 @@
 #include "interface/sparse_pack_base.hpp"
 #include "interface/state_descriptor.hpp"
 #include "interface/variable.hpp"
+#include "mesh/meshblock.hpp"
 #include "utils/utils.hpp"
 namespace parthenon {
 namespace impl {
@@ -112,6 +113,50 @@ template SparsePackBase::alloc_t
 SparsePackBase::GetAllocStatus<MeshData<Real>>(MeshData<Real> *, const PackDescriptor &,
                                                const std::vector<bool> &);
 
+template <class T>
+void SparsePackBase::MakeWritable(T *pmd, const PackDescriptor &desc,
+                                  const std::vector<bool> &include_block) {
+  using mbd_t = MeshBlockData<Real>;
+  ForEachBlock(pmd, include_block, [&](int b, mbd_t *pmbd) {
+    if (pmbd->NumSharedVariables() == 0) return;
+    const auto &uid_map = pmbd->GetUidMap();
+    VariableVector<Real> vars;
+    for (const auto &vgroup : desc.var_groups) {
+      for (const auto &[var_name, uid] : vgroup) {
+        auto it = uid_map.find(uid);
+        if (it != uid_map.end()) vars.push_back(it->second);
+      }
+    }
+    pmbd->MakeWritable(vars);
+  });
+}
+
+template void
+SparsePackBase::MakeWritable<MeshBlockData<Real>>(MeshBlockData<Real> *,
+                                                  const PackDescriptor &,
+                                                  const std::vector<bool> &);
+template void SparsePackBase::MakeWritable<MeshData<Real>>(MeshData<Real> *,
+                                                           const PackDescriptor &,
+                                                           const std::vector<bool> &);
+
+template <class T>
+SparsePackBase::epoch_t
+SparsePackBase::GetAllocationEpoch(T *pmd, const std::vector<bool> &include_block) {
+  using mbd_t = MeshBlockData<Real>;
+  epoch_t epoch = 0;
+  ForEachBlock(pmd, include_block, [&](int b, mbd_t *pmbd) {
+    epoch += pmbd->GetBlockPointer()->GetAllocationEpoch();
+  });
+  return epoch;
+}
+
+template SparsePackBase::epoch_t
+SparsePackBase::GetAllocationEpoch<MeshBlockData<Real>>(MeshBlockData<Real> *,
+                                                        const std::vector<bool> &);
+template SparsePackBase::epoch_t
+SparsePackBase::GetAllocationEpoch<MeshData<Real>>(MeshData<Real> *,
+                                                   const std::vector<bool> &);
+
 template <class T>
 SparsePackBase SparsePackBase::Build(T *pmd, const PackDescriptor &desc,
                                      const std::vector<bool> &include_block) {
@@ -136,11 +181,13 @@ SparsePackBase SparsePackBase::Build(T *pmd, const PackDescriptor &desc,
     }
     nblocks++;
     const auto &uid_map = pmbd->GetUidMap();
+    VariableVector<Real> flux_vars;
     for (int i = 0; i < nvar; ++i) {
       for (const auto &[var_name, uid] : desc.var_groups[i]) {
         if (uid_map.count(uid) > 0) {
           const auto pv = uid_map.at(uid);
           if (pv->IsAllocated()) {
+            if (desc.with_fluxes) flux_vars.push_back(pv);
             if (pv->IsSet(Metadata::Face) || pv->IsSet(Metadata::Edge))
               contains_face_or_edge = true;
             int prod = pv->GetDim(6) * pv->GetDim(5) * pv->GetDim(4);
@@ -151,6 +198,7 @@ SparsePackBase SparsePackBase::Build(T *pmd, const PackDescriptor &desc,
       }
     }
 
+    if (desc.with_fluxes) mbd_t::CheckScratchFluxes(flux_vars);
     max_size = std::max(size, max_size);
   });
   pack.nblocks_ = desc.flat ? 1 : nblocks;
@@ -198,15 +246,18 @@ SparsePackBase SparsePackBase::Build(T *pmd, const PackDescriptor &desc,
         if (uid_map.count(uid) > 0) {
           const auto pv = uid_map.at(uid);
           if (pv->IsAllocated()) {
+            // without a coarse buffer (see Mesh::LazyCoarseBuffers) the entries of a
+            // coarse pack remain empty views
+            const bool has_coarse = pv->coarse_s.size() > 0;
             for (int t = 0; t < pv->GetDim(6); ++t) {
               for (int u = 0; u < pv->GetDim(5); ++u) {
                 for (int v = 0; v < pv->GetDim(4); ++v) {
                   if (pv->IsSet(Metadata::Face) || pv->IsSet(Metadata::Edge)) {
-                    if (pack.coarse_) {
+                    if (pack.coarse_ && has_coarse) {
                       pack_h(0, b, idx) = pv->coarse_s.Get(0, t, u, v);
                       pack_h(1, b, idx) = pv->coarse_s.Get(1, t, u, v);
                       pack_h(2, b, idx) = pv->coarse_s.Get(2, t, u, v);
-                    } else {
+                    } else if (!pack.coarse_) {
                       pack_h(0, b, idx) = pv->data.Get(0, t, u, v);
                       pack_h(1, b, idx) = pv->data.Get(1, t, u, v);
                       pack_h(2, b, idx) = pv->data.Get(2, t, u, v);
@@ -225,9 +276,9 @@ SparsePackBase SparsePackBase::Build(T *pmd, const PackDescriptor &desc,
 
                   } else { // This is a cell, node, or a variable that doesn't have
                            // topology information
-                    if (pack.coarse_) {
+                    if (pack.coarse_ && has_coarse) {
                       pack_h(0, b, idx) = pv->coarse_s.Get(0, t, u, v);
-                    } else {
+                    } else if (!pack.coarse_) {
                       pack_h(0, b, idx) = pv->data.Get(0, t, u, v);
                     }
                     if (pv->IsSet(Metadata::Vector))
@@ -287,28 +338,19 @@ template SparsePackBase SparsePackBase::Build<MeshData<Real>>(MeshData<Real> *,
 template <class T>
 SparsePackBase &SparsePackCache::Get(T *pmd, const PackDescriptor &desc,
                                      const std::vector<bool> &include_block) {
-  if (pack_map.count(desc.identifier) > 0) {
-    auto &cache_tuple = pack_map[desc.identifier];
-    auto &pack = std::get<0>(cache_tuple);
-    auto alloc_status_in = SparsePackBase::GetAllocStatus(pmd, desc, include_block);
-    auto &alloc_status = std::get<1>(cache_tuple);
-    if (alloc_status.size() != alloc_status_in.size())
-      return BuildAndAdd(pmd, desc, include_block);
-    for (int i = 0; i < alloc_status_in.size(); ++i) {
-      if (alloc_status[i] != alloc_status_in[i])
-        return BuildAndAdd(pmd, desc, include_block);
-    }
-    auto &include_status = std::get<2>(cache_tuple);
-    if (include_status.size() != include_block.size())
-      return BuildAndAdd(pmd, desc, include_block);
-    for (int i = 0; i < include_block.size(); ++i) {
-      if (include_status[i] != include_block[i])
-        return BuildAndAdd(pmd, desc, include_block);
-    }
-    // Cached version is not stale, so just return a reference to it
-    return std::get<0>(cache_tuple);
-  }
-  return BuildAndAdd(pmd, desc, include_block);
+  auto it = pack_map.find(desc.key);
+  if (it == pack_map.end()) return BuildAndAdd(pmd, desc, include_block);
+  auto &[pack, alloc_status, include_status, epoch, check] = it->second;
+  if (check != desc.check || include_status != include_block)
+    return BuildAndAdd(pmd, desc, include_block);
+  // Nothing was (de)allocated on the blocks since the pack was built or last checked
+  const auto epoch_in = SparsePackBase::GetAllocationEpoch(pmd, include_block);
+  if (epoch_in == epoch) return pack;
+  // Otherwise the pack is only stale if the allocation status of a variable in it changed
+  if (SparsePackBase::GetAllocStatus(pmd, desc, include_block) != alloc_status)
+    return BuildAndAdd(pmd, desc, include_block);
+  epoch = epoch_in;
+  return pack;
 }
 template SparsePackBase &SparsePackCache::Get<MeshData<Real>>(MeshData<Real> *,
                                                               const PackDescriptor &,
@@ -320,11 +362,11 @@ SparsePackCache::Get<MeshBlockData<Real>>(MeshBlockData<Real> *, const PackDescr
 template <class T>
 SparsePackBase &SparsePackCache::BuildAndAdd(T *pmd, const PackDescriptor &desc,
                                              const std::vector<bool> &include_block) {
-  if (pack_map.count(desc.identifier) > 0) pack_map.erase(desc.identifier);
-  pack_map[desc.identifier] = {SparsePackBase::Build(pmd, desc, include_block),
-                               SparsePackBase::GetAllocStatus(pmd, desc, include_block),
-                               include_block};
-  return std::get<0>(pack_map[desc.identifier]);
+  auto &entry = pack_map[desc.key];
+  entry = {SparsePackBase::Build(pmd, desc, include_block),
+           SparsePackBase::GetAllocStatus(pmd, desc, include_block), include_block,
+           SparsePackBase::GetAllocationEpoch(pmd, include_block), desc.check};
+  return std::get<0>(entry);
 }
 template SparsePackBase &
 SparsePackCache::BuildAndAdd<MeshData<Real>>(MeshData<Real> *, const PackDescriptor &,
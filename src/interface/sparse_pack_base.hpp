@@ -14,6 +14,7 @@
 #define INTERFACE_SPARSE_PACK_BASE_HPP_
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <limits>
 #include <map>
@@ -30,6 +31,7 @@
 #include "interface/state_descriptor.hpp"
 #include "interface/variable.hpp"
 #include "interface/variable_state.hpp"
+#include "utils/hash.hpp"
 #include "utils/utils.hpp"
 
 namespace parthenon {
@@ -43,7 +45,10 @@ using SparsePackIdxMap = std::unordered_map<std::string, std::size_t>;
 
 class StateDescriptor;
 
-enum class PDOpt { WithFluxes, Coarse, Flatten };
+// Packs give the variables of copy-on-write stages a private copy of their data, since
+// they may be written (see MeshBlockData::MakeWritable), unless ReadOnly declares that
+// the pack is only read
+enum class PDOpt { WithFluxes, Coarse, Flatten, ReadOnly };
 
 class SparsePackBase {
  public:
@@ -55,6 +60,7 @@ class SparsePackBase {
 
   using alloc_t = std::vector<int>;
   using include_t = std::vector<bool>;
+  using epoch_t = std::uint64_t;
   using pack_t = ParArray3D<ParArray3D<Real, VariableState>>;
   using bounds_t = ParArray3D<int>;
   using bounds_h_t = typename ParArray3D<int>::HostMirror;
@@ -65,6 +71,7 @@ class SparsePackBase {
   template <class T>
   static SparsePackBase GetPack(T *pmd, const impl::PackDescriptor &desc,
                                 const std::vector<bool> &include_block) {
+    if (!desc.read_only) MakeWritable(pmd, desc, include_block);
     auto &cache = pmd->GetSparsePackCache();
     return cache.Get(pmd, desc, include_block);
   }
@@ -78,6 +85,17 @@ class SparsePackBase {
   static alloc_t GetAllocStatus(T *pmd, const impl::PackDescriptor &desc,
                                 const std::vector<bool> &include_block);
 
+  // Make the variables in pmd matching desc writable
+  template <class T>
+  static void MakeWritable(T *pmd, const impl::PackDescriptor &desc,
+                           const std::vector<bool> &include_block);
+
+  // Get the sum of the allocation epochs of the blocks in pmd. Since the epoch of a block
+  // only grows, the sum only stays the same if no variable of the blocks was
+  // (de)allocated.
+  template <class T>
+  static epoch_t GetAllocationEpoch(T *pmd, const std::vector<bool> &include_block);
+
   // Actually build a `SparsePackBase` (i.e. create a view of views, fill on host, and
   // deep copy the view of views to device) from the variables specified in desc contained
   // from the blocks contained in pmd (which can either be MeshBlockData/MeshData).
@@ -105,6 +123,17 @@ class SparsePackBase {
 class SparsePackCache {
  public:
   std::size_t size() const { return pack_map.size(); }
+  // device memory of the cached packs
+  std::int64_t SizeInBytes() const {
+    std::int64_t bytes = 0;
+    for (const auto &[key, entry] : pack_map) {
+      const auto &pack = std::get<0>(entry);
+      bytes += pack.pack_.size() * sizeof(SparsePackBase::pack_t::value_type) +
+               pack.bounds_.size() * sizeof(int) +
+               pack.coords_.size() * sizeof(SparsePackBase::coords_t::value_type);
+    }
+    return bytes;
+  }
 
   void clear() { pack_map.clear(); }
 
@@ -117,8 +146,12 @@ class SparsePackCache {
   SparsePackBase &BuildAndAdd(T *pmd, const impl::PackDescriptor &desc,
                               const std::vector<bool> &include_block);
 
-  std::unordered_map<std::string, std::tuple<SparsePackBase, SparsePackBase::alloc_t,
-                                             SparsePackBase::include_t>>
+  // Packs by PackDescriptor::key. The PackDescriptor::check of the descriptor is kept to
+  // guard against collisions of the keys without comparing identifiers.
+  std::unordered_map<std::size_t,
+                     std::tuple<SparsePackBase, SparsePackBase::alloc_t,
+                                SparsePackBase::include_t, SparsePackBase::epoch_t,
+                                std::size_t>>
       pack_map;
 
   friend class SparsePackBase;
@@ -135,7 +168,8 @@ struct PackDescriptor {
   // default constructor needed for certain use cases
   PackDescriptor()
       : nvar_groups(0), var_group_names({}), var_groups({}), with_fluxes(false),
-        coarse(false), flat(false), identifier("") {}
+        coarse(false), flat(false), read_only(false), identifier(""), key(0),
+        check(0) {}
 
   template <class GROUP_t, class SELECTOR_t>
   PackDescriptor(StateDescriptor *psd, const std::vector<GROUP_t> &var_groups_in,
@@ -144,7 +178,8 @@ struct PackDescriptor {
         var_groups(BuildUids(var_groups_in.size(), psd, selector)),
         with_fluxes(options.count(PDOpt::WithFluxes)),
         coarse(options.count(PDOpt::Coarse)), flat(options.count(PDOpt::Flatten)),
-        identifier(GetIdentifier()) {
+        read_only(options.count(PDOpt::ReadOnly)), identifier(GetIdentifier()),
+        key(GetKey()), check(std::hash<std::string>()(identifier)) {
     PARTHENON_REQUIRE(!(with_fluxes && coarse),
                       "Probably shouldn't be making a coarse pack with fine fluxes.");
   }
@@ -155,7 +190,16 @@ struct PackDescriptor {
   const bool with_fluxes;
   const bool coarse;
   const bool flat;
+  // does not change the pack, so it is not part of the identifier and key
+  const bool read_only;
   const std::string identifier;
+  // Hash of the variables and options, computed once so that looking up a pack in the
+  // cache does not hash the identifier
+  const std::size_t key;
+  // Independent hash of the identifier, which the cache compares instead of the
+  // identifier on a hit. Two different descriptors would need to collide in both key
+  // and check to share a pack.
+  const std::size_t check;
 
  private:
   std::string GetIdentifier() {
@@ -171,6 +215,19 @@ struct PackDescriptor {
     ident += std::to_string(flat);
     return ident;
   }
+  std::size_t GetKey() {
+    std::size_t seed = 0;
+    for (const auto &vgroup : var_groups) {
+      for (const auto &[vid, uid] : vgroup) {
+        seed = impl::hash_combine(seed, uid);
+      }
+      // separate the groups, so that moving variables between groups changes the key
+      seed = impl::hash_combine(seed, vgroup.size());
+    }
+    seed = impl::hash_combine(seed, with_fluxes);
+    seed = impl::hash_combine(seed, coarse);
+    return impl::hash_combine(seed, flat);
+  }
   template <class FUNC_t>
   std::vector<PackDescriptor::VariableGroup_t>
   BuildUids(int nvgs, const StateDescriptor *const psd, const FUNC_t &selector) {
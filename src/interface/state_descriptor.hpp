@@ -145,6 +145,11 @@ class StateDescriptor {
     return params_.GetMutable<T>(key);
   }
 
+  template <typename T>
+  Params::Handle<T> ParamHandle(const std::string &key) const {
+    return params_.GetHandle<T>(key);
+  }
+
   // Set (if not set) and get simultaneously.
   // infers type correctly.
   template <typename T>
@@ -409,6 +414,9 @@ class StateDescriptor {
     if (CheckRefinementBlock != nullptr) return CheckRefinementBlock(rc);
     return AmrTag::derefine;
   }
+  void CheckRefinement(MeshData<Real> *rc, ParArray1D<AmrTag> &tags) const {
+    if (CheckRefinementMesh != nullptr) CheckRefinementMesh(rc, tags);
+  }
 
   void InitNewlyAllocatedVars(MeshData<Real> *rc) const {
     if (InitNewlyAllocatedVarsMesh != nullptr) return InitNewlyAllocatedVarsMesh(rc);
@@ -444,6 +452,9 @@ class StateDescriptor {
   std::function<Real(MeshData<Real> *rc)> EstimateTimestepMesh = nullptr;
 
   std::function<AmrTag(MeshBlockData<Real> *rc)> CheckRefinementBlock = nullptr;
+  // Raises the tags of the blocks of rc on device, see RegisterRefinementCriteria
+  std::function<void(MeshData<Real> *rc, ParArray1D<AmrTag> &tags)> CheckRefinementMesh =
+      nullptr;
 
   std::function<void(MeshData<Real> *rc)> InitNewlyAllocatedVarsMesh = nullptr;
   std::function<void(MeshBlockData<Real> *rc)> InitNewlyAllocatedVarsBlock = nullptr;
@@ -14,6 +14,8 @@
 #include "interface/update.hpp"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "config.hpp"
 #include "coordinates/coordinates.hpp"
@@ -144,11 +146,19 @@ TaskStatus SparseDealloc(MeshData<Real> *md) {
     return TaskStatus::complete;
   }
 
+  auto &state = md->GetSparseDeallocState();
+  if (state.ncalls++ % Globals::sparse_config.deallocation_interval != 0) {
+    return TaskStatus::complete;
+  }
+
   Kokkos::Profiling::pushRegion("Task_SparseDealloc");
 
-  const IndexRange ib = md->GetBoundsI(IndexDomain::entire);
-  const IndexRange jb = md->GetBoundsJ(IndexDomain::entire);
-  const IndexRange kb = md->GetBoundsK(IndexDomain::entire);
+  const IndexDomain domain = Globals::sparse_config.deallocation_interior_only
+                                 ? IndexDomain::interior
+                                 : IndexDomain::entire;
+  const IndexRange ib = md->GetBoundsI(domain);
+  const IndexRange jb = md->GetBoundsJ(domain);
+  const IndexRange kb = md->GetBoundsK(domain);
 
   auto control_vars = md->GetMeshPointer()->resolved_packages->GetControlVariables();
   auto desc = MakePackDescriptor(md->GetMeshPointer()->resolved_packages.get(),
@@ -156,7 +166,13 @@ TaskStatus SparseDealloc(MeshData<Real> *md) {
   auto pack = desc.GetPack(md);
   auto packIdx = desc.GetMap();
 
-  ParArray2D<bool> is_zero("IsZero", pack.GetNBlocks(), pack.GetMaxNumberOfVars());
+  if (state.is_zero.GetDim(2) < pack.GetNBlocks() ||
+      state.is_zero.GetDim(1) < pack.GetMaxNumberOfVars()) {
+    state.is_zero =
+        ParArray2D<bool>("IsZero", pack.GetNBlocks(), pack.GetMaxNumberOfVars());
+    state.is_zero_h = Kokkos::create_mirror_view(state.is_zero);
+  }
+  auto is_zero = state.is_zero;
   const int Ni = ib.e + 1 - ib.s;
   const int Nj = jb.e + 1 - jb.s;
   const int Nk = kb.e + 1 - kb.s;
@@ -192,7 +208,8 @@ TaskStatus SparseDealloc(MeshData<Real> *md) {
         }
       });
 
-  auto is_zero_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), is_zero);
+  auto &is_zero_h = state.is_zero_h;
+  Kokkos::deep_copy(is_zero_h, is_zero);
 
   for (int b = 0; b < pack.GetNBlocks(); ++b) {
     for (auto &control_var : control_vars) {
@@ -223,6 +240,107 @@ TaskStatus SparseDealloc(MeshData<Real> *md) {
   return TaskStatus::complete;
 }
 
+namespace {
+std::vector<MeshBlockData<Real> *> BlockDataOf(MeshBlockData<Real> *rc) { return {rc}; }
+std::vector<MeshBlockData<Real> *> BlockDataOf(MeshData<Real> *md) {
+  std::vector<MeshBlockData<Real> *> rcs;
+  for (int b = 0; b < md->NumBlocks(); ++b) {
+    rcs.push_back(md->GetBlockData(b).get());
+  }
+  return rcs;
+}
+
+MeshBlockData<Real>::VarList SelectVariables(MeshBlockData<Real> *rc,
+                                             const std::vector<MetadataFlag> &flags) {
+  return rc->GetVariablesByFlag(Metadata::FlagCollection(flags));
+}
+MeshBlockData<Real>::VarList SelectVariables(MeshBlockData<Real> *rc,
+                                             const std::vector<std::string> &names) {
+  return rc->GetVariablesByName(names);
+}
+} // namespace
+
+template <typename F, typename T>
+bool WeightedSumArenas(const F &flags, T *in1, T *in2, const Real w1, const Real w2,
+                       T *out) {
+  const auto rc1 = BlockDataOf(in1);
+  const auto rc2 = BlockDataOf(in2);
+  const auto rco = BlockDataOf(out);
+  if (rco.empty() || rc1.size() != rco.size() || rc2.size() != rco.size()) return false;
+
+  std::vector<std::string> labels;
+  for (const auto &v : SelectVariables(rco[0], flags).vars()) {
+    labels.push_back(v->label());
+  }
+  if (labels.empty()) return false;
+
+  // every selected variable has to live in the arena of its container at the slot of
+  // the block, which is not the case e.g. for sparse variables or variables that share
+  // the data of another stage
+  auto in_arena = [&](MeshBlockData<Real> *rc) {
+    const auto &arena = rc->GetArena();
+    if (arena == nullptr) return false;
+    for (const auto &label : labels) {
+      if (!rc->HasVariable(label)) return false;
+      const auto &v = *rc->GetVarPtr(label);
+      if (!v.IsAllocated() || v.data.data() != arena->Data(label, rc->GetArenaBlock())) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // blocks [begin, end) of out whose data are the consecutive slots of the same arenas
+  struct Run {
+    int begin, end;
+  };
+  std::vector<Run> runs;
+  for (int b = 0; b < rco.size(); ++b) {
+    if (!in_arena(rc1[b]) || !in_arena(rc2[b]) || !in_arena(rco[b])) return false;
+    const int slot = rco[b]->GetArenaBlock();
+    if (rc1[b]->GetArenaBlock() != slot || rc2[b]->GetArenaBlock() != slot ||
+        !rco[b]->GetArena()->SameLayout(*rc1[b]->GetArena()) ||
+        !rco[b]->GetArena()->SameLayout(*rc2[b]->GetArena())) {
+      return false;
+    }
+    if (!runs.empty()) {
+      const int p = runs.back().end - 1;
+      if (rco[p]->GetArena() == rco[b]->GetArena() &&
+          rc1[p]->GetArena() == rc1[b]->GetArena() &&
+          rc2[p]->GetArena() == rc2[b]->GetArena() &&
+          rco[p]->GetArenaBlock() + 1 == slot) {
+        runs.back().end = b + 1;
+        continue;
+      }
+    }
+    runs.push_back({b, b + 1});
+  }
+
+  for (const auto &run : runs) {
+    const int slot = rco[run.begin]->GetArenaBlock();
+    const int nslots = run.end - run.begin;
+    const auto &x = rc1[run.begin]->GetArena()->Storage();
+    const auto &y = rc2[run.begin]->GetArena()->Storage();
+    const auto &z = rco[run.begin]->GetArena()->Storage();
+    for (const auto &[first, last] :
+         rco[run.begin]->GetArena()->Ranges(labels, slot, slot + nslots)) {
+      parthenon::par_for(
+          loop_pattern_flatrange_tag, "WeightedSumData", DevExecSpace(), first, last - 1,
+          KOKKOS_LAMBDA(const int i) { z(i) = w1 * x(i) + w2 * y(i); });
+    }
+  }
+  return true;
+}
+
+template bool WeightedSumArenas(const std::vector<MetadataFlag> &, MeshBlockData<Real> *,
+                                MeshBlockData<Real> *, Real, Real, MeshBlockData<Real> *);
+template bool WeightedSumArenas(const std::vector<std::string> &, MeshBlockData<Real> *,
+                                MeshBlockData<Real> *, Real, Real, MeshBlockData<Real> *);
+template bool WeightedSumArenas(const std::vector<MetadataFlag> &, MeshData<Real> *,
+                                MeshData<Real> *, Real, Real, MeshData<Real> *);
+template bool WeightedSumArenas(const std::vector<std::string> &, MeshData<Real> *,
+                                MeshData<Real> *, Real, Real, MeshData<Real> *);
+
 } // namespace Update
 
 } // namespace parthenon
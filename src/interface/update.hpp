@@ -33,6 +33,7 @@
 
 #include "kokkos_abstraction.hpp"
 #include "mesh/domain.hpp"
+#include "utils/error_checking.hpp"
 
 namespace parthenon {
 
@@ -67,13 +68,32 @@ template <typename T>
 TaskStatus UpdateWithFluxDivergence(T *data_u0, T *data_u1, const Real gam0,
                                     const Real gam1, const Real beta_dt);
 
+// out = w1 * in1 + w2 * in2 as one flat loop per contiguous range of the variable arenas
+// of the containers, which includes the padding between the variables. Returns false
+// without doing anything unless all selected variables of the three containers are in
+// arenas of the same layout (see parthenon/mesh/variable_arena).
+template <typename F, typename T>
+bool WeightedSumArenas(const F &flags, T *in1, T *in2, const Real w1, const Real w2,
+                       T *out);
+
 template <typename F, typename T>
 TaskStatus WeightedSumData(const F &flags, T *in1, T *in2, const Real w1, const Real w2,
                            T *out) {
   Kokkos::Profiling::pushRegion("Task_WeightedSumData");
-  const auto &x = in1->PackVariables(flags);
-  const auto &y = in2->PackVariables(flags);
+  constexpr bool arena_flags = std::is_same_v<F, std::vector<MetadataFlag>> ||
+                               std::is_same_v<F, std::vector<std::string>>;
+  constexpr bool arena_data =
+      std::is_same_v<T, MeshBlockData<Real>> || std::is_same_v<T, MeshData<Real>>;
+  if constexpr (arena_flags && arena_data) {
+    if (WeightedSumArenas(flags, in1, in2, w1, w2, out)) {
+      Kokkos::Profiling::popRegion(); // Task_WeightedSumData
+      return TaskStatus::complete;
+    }
+  }
+  // out may be in1 or in2, so it is made writable before the inputs are packed
   const auto &z = out->PackVariables(flags);
+  const auto &x = in1->PackVariablesReadOnly(flags);
+  const auto &y = in2->PackVariablesReadOnly(flags);
   parthenon::par_for(
       DEFAULT_LOOP_PATTERN, "WeightedSumData", DevExecSpace(), 0, x.GetDim(5) - 1, 0,
       x.GetDim(4) - 1, 0, x.GetDim(3) - 1, 0, x.GetDim(2) - 1, 0, x.GetDim(1) - 1,
@@ -185,42 +205,84 @@ TaskStatus Update2SIndependent(T *s0_data, T *s1_data, T *rhs_data,
                   rhs_data, pint, dt, stage, update_s1);
 }
 
-// For integration with Butcher tableaus
-// returns base + dt * sum_{j=0}^{k-1} a_{kj} S_j
-// for stages S_j
-// This can then be used to compute right-hand sides.
+namespace impl {
+// Number of registers read by a single kernel of WeightedSumRegisters. Every register
+// is a pack passed by value as a kernel argument, which bounds how many fit.
+constexpr int max_fused_registers = 8;
+
+template <typename pack_t>
+struct Registers {
+  pack_t pack[max_fused_registers];
+  Real weight[max_fused_registers];
+  int n = 0;
+};
+
+// out = sum_n weight[n] * in[n] over the interior, plus the previous value of out if
+// accumulate is true. The registers are summed in the kernel so that out is written once
+// per max_fused_registers registers rather than once per register. Registers that are
+// not allocated on a block count as zero.
 template <typename F, typename T>
-TaskStatus SumButcher(const F &flags, std::shared_ptr<T> base_data,
-                      std::vector<std::shared_ptr<T>> stage_data,
-                      std::shared_ptr<T> out_data, const ButcherIntegrator *pint, Real dt,
-                      int stage) {
-  Kokkos::Profiling::pushRegion("Task_Butcher_Sum");
+void WeightedSumRegisters(const F &flags, const std::vector<T *> &in,
+                          const std::vector<Real> &weight, T *out_data, bool accumulate,
+                          const std::string &name) {
+  PARTHENON_REQUIRE_THROWS(in.size() == weight.size(),
+                           "Need one weight for every register");
   const auto &out = out_data->PackVariables(flags);
-  const auto &in = base_data->PackVariables(flags);
+  using pack_t = std::decay_t<decltype(out)>;
   const IndexDomain interior = IndexDomain::interior;
   const IndexRange ib = out_data->GetBoundsI(interior);
   const IndexRange jb = out_data->GetBoundsJ(interior);
   const IndexRange kb = out_data->GetBoundsK(interior);
-  parthenon::par_for(
-      DEFAULT_LOOP_PATTERN, "ButcherSumInit", DevExecSpace(), 0, out.GetDim(5) - 1, 0,
-      out.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-      KOKKOS_LAMBDA(const int b, const int l, const int k, const int j, const int i) {
-        if (out.IsAllocated(b, l) && in.IsAllocated(b, l)) {
-          out(b, l, k, j, i) = in(b, l, k, j, i);
-        }
-      });
-  for (int prev = 0; prev < stage; ++prev) {
-    Real a = pint->a[stage - 1][prev];
-    const auto &in = stage_data[stage]->PackVariables(flags);
+  if (in.empty() && accumulate) return;
+
+  // an empty sum still has to zero out
+  const int nin = in.size();
+  for (int start = 0; start < std::max(nin, 1); start += max_fused_registers) {
+    Registers<pack_t> r;
+    r.n = std::min(max_fused_registers, nin - start);
+    for (int m = 0; m < r.n; ++m) {
+      r.pack[m] = in[start + m]->PackVariables(flags);
+      r.weight[m] = weight[start + m];
+    }
+    const bool add_out = accumulate || start > 0;
     parthenon::par_for(
-        DEFAULT_LOOP_PATTERN, "ButcherSum", DevExecSpace(), 0, out.GetDim(5) - 1, 0,
+        DEFAULT_LOOP_PATTERN, name, DevExecSpace(), 0, out.GetDim(5) - 1, 0,
         out.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA(const int b, const int l, const int k, const int j, const int i) {
-          if (out.IsAllocated(b, l) && in.IsAllocated(b, l)) {
-            out(b, l, k, j, i) += dt * a * in(b, l, k, j, i);
+          if (!out.IsAllocated(b, l)) return;
+          Real sum = add_out ? out(b, l, k, j, i) : 0.0;
+          for (int m = 0; m < r.n; ++m) {
+            if (r.pack[m].IsAllocated(b, l)) {
+              sum += r.weight[m] * r.pack[m](b, l, k, j, i);
+            }
           }
+          out(b, l, k, j, i) = sum;
         });
   }
+}
+} // namespace impl
+
+// For integration with Butcher tableaus
+// returns base + dt * sum_{j=0}^{k-1} a_{kj} S_j
+// for stages S_j
+// This can then be used to compute right-hand sides.
+template <typename F, typename T>
+TaskStatus SumButcher(const F &flags, std::shared_ptr<T> base_data,
+                      std::vector<std::shared_ptr<T>> stage_data,
+                      std::shared_ptr<T> out_data, const ButcherIntegrator *pint, Real dt,
+                      int stage) {
+  Kokkos::Profiling::pushRegion("Task_Butcher_Sum");
+  std::vector<T *> in{base_data.get()};
+  std::vector<Real> weight{1.0};
+  for (int prev = 0; prev < stage; ++prev) {
+    // stages with a zero coefficient are skipped, which also skips the current stage
+    // on the diagonal of explicit tableaus
+    const Real a = pint->a[stage - 1][prev];
+    if (a == 0.0) continue;
+    in.push_back(stage_data[prev].get());
+    weight.push_back(dt * a);
+  }
+  impl::WeightedSumRegisters(flags, in, weight, out_data.get(), false, "ButcherSum");
   Kokkos::Profiling::popRegion(); // Task_Butcher_Sum
   return TaskStatus::complete;
 }
@@ -239,35 +301,24 @@ TaskStatus UpdateButcher(const F &flags, std::vector<std::shared_ptr<T>> stage_d
                          std::shared_ptr<T> out_data, const ButcherIntegrator *pint,
                          Real dt) {
   Kokkos::Profiling::pushRegion("Task_Butcher_Update");
-
-  const auto &out = out_data->PackVariables(flags);
-  const IndexDomain interior = IndexDomain::interior;
-  const IndexRange ib = out_data->GetBoundsI(interior);
-  const IndexRange jb = out_data->GetBoundsJ(interior);
-  const IndexRange kb = out_data->GetBoundsK(interior);
-
-  const int nstages = pint->nstages;
-  for (int stage = 0; stage < nstages; ++stage) {
+  std::vector<T *> in;
+  std::vector<Real> weight;
+  for (int stage = 0; stage < pint->nstages; ++stage) {
     const Real butcher_b = pint->b[stage];
-    const auto &in = stage_data[stage]->PackVariables(flags);
-    parthenon::par_for(
-        DEFAULT_LOOP_PATTERN, "ButcherUpdate", DevExecSpace(), 0, out.GetDim(5) - 1, 0,
-        out.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-        KOKKOS_LAMBDA(const int b, const int l, const int k, const int j, const int i) {
-          if (out.IsAllocated(b, l) && in.IsAllocated(b, l)) {
-            out(b, l, k, j, i) += dt * b * in(b, l, k, j, i);
-          }
-        });
+    if (butcher_b == 0.0) continue;
+    in.push_back(stage_data[stage].get());
+    weight.push_back(dt * butcher_b);
   }
+  impl::WeightedSumRegisters(flags, in, weight, out_data.get(), true, "ButcherUpdate");
   Kokkos::Profiling::popRegion(); // Task_Butcher_Update
   return TaskStatus::complete;
 }
-template <typename F, typename T>
+template <typename T>
 TaskStatus UpdateButcherIndependent(std::vector<std::shared_ptr<T>> stage_data,
                                     std::shared_ptr<T> out_data,
                                     const ButcherIntegrator *pint, Real dt) {
-  return UpdateButcherIndependent(std::vector<MetadataFlag>({Metadata::Independent}),
-                                  stage_data, out_data, pint, dt);
+  return UpdateButcher(std::vector<MetadataFlag>({Metadata::Independent}), stage_data,
+                       out_data, pint, dt);
 }
 
 template <typename T>
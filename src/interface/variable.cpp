@@ -90,7 +90,10 @@ void Variable<T>::CopyFluxesAndBdryVar(const Variable<T> *src) {
 }
 
 template <typename T>
-std::shared_ptr<Variable<T>> Variable<T>::AllocateCopy(std::weak_ptr<MeshBlock> wpmb) {
+std::shared_ptr<Variable<T>>
+Variable<T>::AllocateCopy(std::weak_ptr<MeshBlock> wpmb,
+                          const std::shared_ptr<VariableArena<T>> &arena,
+                          int arena_block) {
   // copy the Metadata
   Metadata m = m_;
 
@@ -98,6 +101,10 @@ std::shared_ptr<Variable<T>> Variable<T>::AllocateCopy(std::weak_ptr<MeshBlock>
   auto cv = std::make_shared<Variable<T>>(base_name_, m, sparse_id_, wpmb);
 
   if (is_allocated_) {
+    if (arena != nullptr && arena->Contains(label())) {
+      cv->arena_ = arena;
+      cv->arena_block_ = arena_block;
+    }
     cv->AllocateData(wpmb);
   }
 
@@ -106,6 +113,29 @@ std::shared_ptr<Variable<T>> Variable<T>::AllocateCopy(std::weak_ptr<MeshBlock>
   return cv;
 }
 
+template <typename T>
+std::shared_ptr<Variable<T>> Variable<T>::ShareCopy(std::weak_ptr<MeshBlock> wpmb) {
+  auto cv = std::make_shared<Variable<T>>(base_name_, m_, sparse_id_, wpmb);
+  if (is_allocated_) {
+    cv->data = data;
+    cv->num_alloc_ = num_alloc_;
+    cv->is_allocated_ = true;
+    cv->shared_ = true;
+  }
+  cv->CopyFluxesAndBdryVar(this);
+  return cv;
+}
+
+template <typename T>
+void Variable<T>::MakeWritable(MeshBlock *pmb) {
+  if (!shared_) return;
+  auto shared_data = data;
+  is_allocated_ = false;
+  AllocateData(pmb, !shared_data.initialized);
+  Kokkos::deep_copy(DevExecSpace(), data, shared_data);
+  shared_ = false;
+}
+
 template <typename T>
 void Variable<T>::Allocate(std::weak_ptr<MeshBlock> wpmb, bool flag_uninitialized) {
   if (is_allocated_) {
@@ -121,8 +151,10 @@ void Variable<T>::AllocateData(MeshBlock *pmb, bool flag_uninitialized) {
   PARTHENON_REQUIRE_THROWS(
       !is_allocated_,
       "Tried to allocate data for variable that's already allocated: " + label());
-  data = std::make_from_tuple<ParArrayND<T, VariableState>>(std::tuple_cat(
-      std::make_tuple(label(), MakeVariableState()), ArrayToReverseTuple(dims_)));
+  if (pmb != nullptr && pmb->pmy_mesh != nullptr) {
+    pool_ = pmb->pmy_mesh->GetVariableStoragePool();
+  }
+  data = ParArrayND<T, VariableState>(NewStorage_(label(), dims_), MakeVariableState());
 
   ++num_alloc_;
 
@@ -160,33 +192,86 @@ void Variable<T>::AllocateFluxesAndCoarse(std::weak_ptr<MeshBlock> wpmb) {
     auto dims_flux = dims_;
     // A nodal field is the appropriate flux field for an edge variable
     dims_flux[MAX_VARIABLE_DIMENSION - 1] = n_outer;
-    flux_data_ = std::make_from_tuple<ParArrayND<T, VariableState>>(
-        std::tuple_cat(std::make_tuple(label() + ".flux_data", MakeVariableState()),
-                       ArrayToReverseTuple(dims_flux)));
+    const bool scratch = IsSet(Metadata::ScratchFluxes) && !wpmb.expired();
+    if (scratch) {
+      std::shared_ptr<MeshBlock> pmb = wpmb.lock();
+      // the shared fluxes would be overwritten before the flux correction is sent
+      PARTHENON_REQUIRE_THROWS(pmb->pmy_mesh == nullptr || !pmb->pmy_mesh->multilevel,
+                               "Metadata::ScratchFluxes requires a uniform mesh: " +
+                                   label());
+      flux_data_ = ParArrayND<T>(pmb->GetScratchFluxStorage(dims_flux));
+    } else {
+      flux_data_ = ParArrayND<T>(NewStorage_(label() + ".flux_data", dims_flux));
+    }
     // set up fluxes
     for (int d = X1DIR; d <= n_outer; ++d) {
       flux[d] = flux_data_.Get(std::make_pair(d - 1, d));
     }
     if (wpmb.expired()) return;
     std::shared_ptr<MeshBlock> pmb = wpmb.lock();
-    pmb->LogMemUsage(flux_data_.size() * sizeof(T));
+    // shared fluxes are counted once by the block
+    if (!scratch) pmb->LogMemUsage(flux_data_.size() * sizeof(T));
   }
 
   // Create the boundary object
-  if (IsSet(Metadata::FillGhost) || IsSet(Metadata::Independent) ||
-      IsSet(Metadata::ForceRemeshComm)) {
+  if (HasCoarseBuffer_()) {
     if (wpmb.expired()) return;
     std::shared_ptr<MeshBlock> pmb = wpmb.lock();
 
-    if (pmb->pmy_mesh != nullptr && pmb->pmy_mesh->multilevel) {
-      coarse_s = std::make_from_tuple<ParArrayND<T, VariableState>>(
-          std::tuple_cat(std::make_tuple(label() + ".coarse", MakeVariableState()),
-                         ArrayToReverseTuple(coarse_dims_)));
-      pmb->LogMemUsage(coarse_s.size() * sizeof(T));
+    if (pmb->pmy_mesh != nullptr && pmb->pmy_mesh->multilevel &&
+        pmb->HasCoarseBuffers()) {
+      AllocateCoarse_(pmb.get());
     }
   }
 }
 
+template <typename T>
+void Variable<T>::AllocateCoarse_(MeshBlock *pmb) {
+  coarse_s = ParArrayND<T, VariableState>(NewStorage_(label() + ".coarse", coarse_dims_),
+                                          MakeVariableState());
+  pmb->LogMemUsage(coarse_s.size() * sizeof(T));
+}
+
+template <typename T>
+void Variable<T>::DeallocateCoarse_(MeshBlock *pmb) {
+  pmb->LogMemUsage(-static_cast<std::int64_t>(coarse_s.size() * sizeof(T)));
+  if (pool_ != nullptr) {
+    pool_->Release(StorageKey_(label() + ".coarse"), coarse_s.KokkosView());
+  }
+  coarse_s.Reset();
+}
+
+template <typename T>
+device_view_t<T>
+Variable<T>::NewStorage_(const std::string &label,
+                         const std::array<int, MAX_VARIABLE_DIMENSION> &dims) {
+  if (arena_ != nullptr && arena_->Contains(label)) {
+    return arena_->Get(label, arena_block_);
+  }
+  if (pool_ != nullptr) return pool_->Get(StorageKey_(label), label, dims);
+  return std::make_from_tuple<device_view_t<T>>(
+      std::tuple_cat(std::make_tuple(label), ArrayToReverseTuple(dims)));
+}
+
+template <typename T>
+std::string Variable<T>::StorageKey_(const std::string &label) const {
+  // the storage label of a sparse variable starts with its label
+  return IsSparse() ? base_name_ + label.substr(this->label().size()) : label;
+}
+
+template <typename T>
+void Variable<T>::ReleaseStorage_() {
+  if (pool_ == nullptr) return;
+  // the fluxes are subviews of flux_data_. Views into an arena are unmanaged and the
+  // storage of Metadata::ScratchFluxes is held by the block, so neither is returned to
+  // the pool
+  for (auto &f : flux)
+    f.Reset();
+  pool_->Release(StorageKey_(label()), data.KokkosView());
+  pool_->Release(StorageKey_(label() + ".flux_data"), flux_data_.KokkosView());
+  pool_->Release(StorageKey_(label() + ".coarse"), coarse_s.KokkosView());
+}
+
 template <typename T>
 std::int64_t Variable<T>::Deallocate() {
   std::int64_t mem_size = 0;
@@ -194,12 +279,15 @@ std::int64_t Variable<T>::Deallocate() {
   if (!IsAllocated()) {
     return 0;
   }
+  // keep the storage for the next allocation of this or another sparse id
+  ReleaseStorage_();
 
   mem_size += data.size() * sizeof(T);
   data.Reset();
 
   if (IsSet(Metadata::WithFluxes)) {
-    mem_size += flux_data_.size() * sizeof(T);
+    // shared fluxes stay with the block
+    if (!IsSet(Metadata::ScratchFluxes)) mem_size += flux_data_.size() * sizeof(T);
     flux_data_.Reset();
     int n_outer = 1 + (GetDim(2) > 1) * (1 + (GetDim(3) > 1));
     for (int d = X1DIR; d <= n_outer; ++d) {
@@ -207,8 +295,7 @@ std::int64_t Variable<T>::Deallocate() {
     }
   }
 
-  if (IsSet(Metadata::FillGhost) || IsSet(Metadata::Independent) ||
-      IsSet(Metadata::ForceRemeshComm)) {
+  if (HasCoarseBuffer_()) {
     mem_size += coarse_s.size() * sizeof(T);
     coarse_s.Reset();
   }
@@ -42,6 +42,8 @@
 #include "defs.hpp"
 #include "interface/metadata.hpp"
 #include "interface/var_id.hpp"
+#include "interface/variable_arena.hpp"
+#include "interface/variable_storage_pool.hpp"
 #include "parthenon_arrays.hpp"
 #include "prolong_restrict/prolong_restrict.hpp"
 #include "utils/error_checking.hpp"
@@ -64,12 +66,21 @@ class Variable {
               std::weak_ptr<MeshBlock> wpmb);
 
   Variable() = default;
-  ~Variable() {}
+  ~Variable() { ReleaseStorage_(); }
   // copy fluxes and boundary variable from src Variable (shallow copy)
   void CopyFluxesAndBdryVar(const Variable<T> *src);
 
-  // make a new Variable based on an existing one
-  std::shared_ptr<Variable<T>> AllocateCopy(std::weak_ptr<MeshBlock> wpmb);
+  // make a new Variable based on an existing one, with its data in block arena_block of
+  // arena if the arena contains it
+  std::shared_ptr<Variable<T>>
+  AllocateCopy(std::weak_ptr<MeshBlock> wpmb,
+               const std::shared_ptr<VariableArena<T>> &arena = nullptr,
+               int arena_block = 0);
+  // make a new Variable based on an existing one that shares its data until it is made
+  // writable (see MeshBlockData::MakeWritable)
+  std::shared_ptr<Variable<T>> ShareCopy(std::weak_ptr<MeshBlock> wpmb);
+  // whether the data is shared with the Variable this one was copied from
+  bool IsShared() const { return shared_; }
 
   // accessors
   template <class... Args>
@@ -166,12 +177,33 @@ class Variable {
   // deallocate data, fluxes, and boundary variable
   std::int64_t Deallocate();
 
+  // replace shared data by a private copy
+  void MakeWritable(MeshBlock *pmb);
+
   /// allocate fluxes (if Metadata::WithFluxes is set) and coarse data if
   /// (Metadata::FillGhost is set)
   void AllocateFluxesAndCoarse(std::weak_ptr<MeshBlock> wpmb);
 
+  // whether the variable has a coarse buffer on multilevel meshes
+  bool HasCoarseBuffer_() const {
+    return IsSet(Metadata::FillGhost) || IsSet(Metadata::Independent) ||
+           IsSet(Metadata::ForceRemeshComm);
+  }
+  // allocate or release the coarse buffer, see MeshBlock::SetCoarseBuffers
+  void AllocateCoarse_(MeshBlock *pmb);
+  void DeallocateCoarse_(MeshBlock *pmb);
+
   VariableState MakeVariableState() const { return VariableState(m_, sparse_id_, dims_); }
 
+  // storage for the data, fluxes or coarse buffer, from the arena of the variable if it
+  // contains the label, else from the storage pool of the Mesh if there is one
+  device_view_t<T> NewStorage_(const std::string &label,
+                               const std::array<int, MAX_VARIABLE_DIMENSION> &dims);
+  // return the storage to the pool
+  void ReleaseStorage_();
+  // key of the storage with the given label in the pool, shared by all sparse ids
+  std::string StorageKey_(const std::string &label) const;
+
   Metadata m_;
   const std::string base_name_;
   const int sparse_id_;
@@ -186,7 +218,13 @@ class Variable {
   inline static UniqueIDGenerator<std::string> get_uid_;
 
   bool is_allocated_ = false;
+  bool shared_ = false;
   ParArrayND<T> flux_data_; // unified par array for the fluxes
+  std::shared_ptr<VariableStoragePool<T>> pool_;
+  // the data of dense variables may alias into an arena shared with the other variables
+  // of the block, which is kept alive by the variables using it
+  std::shared_ptr<VariableArena<T>> arena_;
+  int arena_block_ = 0;
 };
 
 template <typename T>
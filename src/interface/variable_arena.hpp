@@ -0,0 +1,180 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef INTERFACE_VARIABLE_ARENA_HPP_
+#define INTERFACE_VARIABLE_ARENA_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+#include "parthenon_arrays.hpp"
+#include "utils/array_to_tuple.hpp"
+#include "utils/error_checking.hpp"
+
+namespace parthenon {
+
+// Layout of VariableArenas, set by parthenon/mesh/variable_arena*
+struct VariableArenaOptions {
+  bool enabled = false;
+  // one arena per stage for all local blocks instead of one per block and stage
+  bool mesh_wide = false;
+  // alignment of the start of every variable in bytes
+  int alignment = 64;
+  // number of unused elements after every variable
+  int padding = 0;
+};
+
+// A single allocation holding the data of several Variables, in the order they were
+// added. Every variable can have copies for several blocks, which are contiguous, i.e.
+// the variable is stored as [nblocks][ncomp][k][j][i]. The data of the Variables are
+// unmanaged views into the arena, so the Variables keep the arena alive.
+template <typename T>
+class VariableArena {
+ public:
+  using view_t = device_view_t<T>;
+  using dims_t = std::array<int, MAX_VARIABLE_DIMENSION>;
+
+  explicit VariableArena(const VariableArenaOptions &options) : options_(options) {
+    PARTHENON_REQUIRE_THROWS(options.alignment > 0 && options.alignment % sizeof(T) == 0,
+                             "Variable arena alignment must be a multiple of the size of "
+                             "the data type");
+    PARTHENON_REQUIRE_THROWS(options.padding >= 0,
+                             "Variable arena padding must be non-negative");
+  }
+
+  // Reserve space for nblocks copies of the variable with the given label and dimensions
+  // (in the order of Variable::GetDim). All variables have to be added before Allocate.
+  void Add(const std::string &label, const dims_t &dims, int nblocks = 1) {
+    PARTHENON_REQUIRE_THROWS(storage_.size() == 0,
+                             "Tried to add " + label + " to an allocated arena");
+    const std::size_t align = options_.alignment / sizeof(T);
+    size_ = ((size_ + align - 1) / align) * align;
+    Entry entry{size_, 1, nblocks, dims};
+    for (auto d : dims)
+      entry.block_size *= d;
+    entries_[label] = entry;
+    size_ += entry.block_size * nblocks + options_.padding;
+  }
+
+  // Allocate the storage of all variables, initialized to zero
+  void Allocate(const std::string &label) {
+    storage_ = Kokkos::View<T *, LayoutWrapper, DevMemSpace>(label, size_);
+  }
+
+  bool Contains(const std::string &label) const { return entries_.count(label) > 0; }
+  int NumBlocks(const std::string &label) const { return entries_.at(label).nblocks; }
+
+  // View of the storage of a variable on a block
+  view_t Get(const std::string &label, int block = 0) const {
+    PARTHENON_REQUIRE_THROWS(storage_.size() > 0, "Variable arena is not allocated");
+    const auto &entry = entries_.at(label);
+    PARTHENON_REQUIRE_THROWS(block >= 0 && block < entry.nblocks,
+                             "Block index out of range for " + label);
+    return std::make_from_tuple<view_t>(
+        std::tuple_cat(std::make_tuple(storage_.data() + entry.offset +
+                                       block * entry.block_size),
+                       ArrayToReverseTuple(entry.dims)));
+  }
+
+  // Start of the storage of a variable on a block, nullptr if the arena does not hold it
+  T *Data(const std::string &label, int block = 0) const {
+    auto it = entries_.find(label);
+    if (it == entries_.end() || storage_.size() == 0) return nullptr;
+    if (block < 0 || block >= it->second.nblocks) return nullptr;
+    return storage_.data() + it->second.offset + block * it->second.block_size;
+  }
+
+  // Whether the other arena stores the same variables at the same offsets, so that a
+  // range of the storage holds the same variables in both
+  bool SameLayout(const VariableArena &other) const {
+    if (size_ != other.size_ || entries_.size() != other.entries_.size()) return false;
+    for (const auto &[label, entry] : entries_) {
+      auto it = other.entries_.find(label);
+      if (it == other.entries_.end() || it->second.offset != entry.offset ||
+          it->second.block_size != entry.block_size ||
+          it->second.nblocks != entry.nblocks) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Ranges [first, second) of the storage holding the given variables on the blocks
+  // [block_begin, block_end). Ranges of variables that follow each other in the arena are
+  // merged, including the padding between them, so that all variables of all blocks are
+  // a single range.
+  std::vector<std::pair<std::size_t, std::size_t>>
+  Ranges(const std::vector<std::string> &labels, int block_begin, int block_end) const {
+    std::unordered_set<std::string> selected(labels.begin(), labels.end());
+    // entries in the order of the storage, with whether they are selected
+    std::vector<std::tuple<std::size_t, bool, const Entry *>> order;
+    for (const auto &[label, entry] : entries_) {
+      order.emplace_back(entry.offset, selected.count(label) > 0, &entry);
+    }
+    std::sort(order.begin(), order.end(), [](const auto &a, const auto &b) {
+      return std::get<0>(a) < std::get<0>(b);
+    });
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+    bool extends = false; // whether the last range reaches the end of its variable
+    for (const auto &[offset, select, pentry] : order) {
+      if (!select) {
+        extends = false;
+        continue;
+      }
+      const std::size_t end = offset + block_end * pentry->block_size;
+      if (extends && block_begin == 0) {
+        ranges.back().second = end;
+      } else {
+        ranges.emplace_back(offset + block_begin * pentry->block_size, end);
+      }
+      extends = (block_end == pentry->nblocks);
+    }
+    return ranges;
+  }
+
+  // Flat view of the storage of a variable on all blocks
+  auto GetAllBlocks(const std::string &label) const {
+    const auto &entry = entries_.at(label);
+    const std::size_t end = entry.offset + entry.block_size * entry.nblocks;
+    return Kokkos::subview(storage_, std::make_pair(entry.offset, end));
+  }
+
+  std::size_t NumVariables() const { return entries_.size(); }
+  std::size_t SizeInBytes() const { return storage_.size() * sizeof(T); }
+  // The whole arena, e.g. to update all of its variables in a single loop
+  const auto &Storage() const { return storage_; }
+
+ private:
+  struct Entry {
+    std::size_t offset, block_size;
+    int nblocks;
+    dims_t dims;
+  };
+
+  VariableArenaOptions options_;
+  std::unordered_map<std::string, Entry> entries_;
+  std::size_t size_ = 0;
+  Kokkos::View<T *, LayoutWrapper, DevMemSpace> storage_;
+};
+
+} // namespace parthenon
+
+#endif // INTERFACE_VARIABLE_ARENA_HPP_
@@ -0,0 +1,141 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef INTERFACE_VARIABLE_STORAGE_POOL_HPP_
+#define INTERFACE_VARIABLE_STORAGE_POOL_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+#include "parthenon_arrays.hpp"
+#include "utils/array_to_tuple.hpp"
+
+namespace parthenon {
+
+// Pool of the device storage of Variables (data, fluxes and coarse buffers) on a rank.
+// The storage of the Variables of destroyed MeshBlocks, e.g. after derefinement or
+// migration during remeshing, and of deallocated sparse Variables is kept and handed to
+// new Variables with the same key and shape instead of being freed and allocated again,
+// which is expensive on GPUs. The key is the label of dense Variables and the base name
+// of sparse Variables, so that all sparse ids of a SparsePool share their storage.
+// The storage of the old MeshBlocks is released after the new ones are built, so it is
+// reused at the next remesh; Trim, called after every remesh and every
+// pool_variable_storage_trim_interval cycles, frees what was not reused within one
+// interval.
+template <typename T>
+class VariableStoragePool {
+ public:
+  using view_t = device_view_t<T>;
+  using dims_t = std::array<int, MAX_VARIABLE_DIMENSION>;
+
+  // At most max_bytes of storage are held for reuse, without limit if negative
+  explicit VariableStoragePool(std::int64_t max_bytes = -1) : max_bytes_(max_bytes) {}
+
+  // Storage with the given key and dimensions (in the order of Variable::GetDim),
+  // zeroed like a new allocation. New storage gets the given label.
+  view_t Get(const std::string &key, const std::string &label, const dims_t &dims) {
+    auto it = available_.find(key);
+    if (it != available_.end()) {
+      auto &views = it->second;
+      for (int n = views.size() - 1; n >= 0; --n) {
+        if (!HasDims_(views[n].view, dims)) continue;
+        view_t view = views[n].view;
+        views.erase(views.begin() + n);
+        bytes_ -= view.size() * sizeof(T);
+        hits_++;
+        Kokkos::deep_copy(DevExecSpace(), view, T());
+        return view;
+      }
+    }
+    misses_++;
+    return std::make_from_tuple<view_t>(
+        std::tuple_cat(std::make_tuple(label), ArrayToReverseTuple(dims)));
+  }
+
+  // Keep the storage for reuse under the given key, unless it is still referenced
+  // elsewhere (e.g. by another stage of the same Variable) or the pool is full
+  void Release(const std::string &key, const view_t &view) {
+    if (!view.is_allocated() || view.use_count() != 1) return;
+    const std::int64_t bytes = view.size() * sizeof(T);
+    if (max_bytes_ >= 0 && bytes_ + bytes > max_bytes_) {
+      dropped_++;
+      return;
+    }
+    available_[key].push_back(Entry{view, generation_});
+    released_++;
+    bytes_ += bytes;
+    peak_bytes_ = std::max(peak_bytes_, bytes_);
+  }
+
+  // Free the storage released before the previous call, i.e. that has not been reused
+  // since then
+  void Trim() {
+    for (auto it = available_.begin(); it != available_.end();) {
+      auto &views = it->second;
+      auto stale = std::stable_partition(views.begin(), views.end(), [&](const Entry &e) {
+        return e.generation == generation_;
+      });
+      for (auto v = stale; v != views.end(); ++v) {
+        bytes_ -= v->view.size() * sizeof(T);
+      }
+      views.erase(stale, views.end());
+      it = views.empty() ? available_.erase(it) : std::next(it);
+    }
+    generation_++;
+  }
+
+  // Free all storage held by the pool
+  void Clear() {
+    available_.clear();
+    bytes_ = 0;
+  }
+
+  std::int64_t Hits() const { return hits_; }
+  std::int64_t Misses() const { return misses_; }
+  // number of views kept for reuse and freed because the pool was full
+  std::int64_t Released() const { return released_; }
+  std::int64_t Dropped() const { return dropped_; }
+  // Bytes of storage currently held for reuse, and their maximum
+  std::int64_t SizeInBytes() const { return bytes_; }
+  std::int64_t PeakSizeInBytes() const { return peak_bytes_; }
+  std::int64_t MaxSizeInBytes() const { return max_bytes_; }
+
+ private:
+  static bool HasDims_(const view_t &view, const dims_t &dims) {
+    for (int d = 0; d < MAX_VARIABLE_DIMENSION; ++d) {
+      if (view.extent_int(MAX_VARIABLE_DIMENSION - 1 - d) != dims[d]) return false;
+    }
+    return true;
+  }
+
+  struct Entry {
+    view_t view;
+    std::int64_t generation; // number of calls of Trim before the release
+  };
+
+  std::unordered_map<std::string, std::vector<Entry>> available_;
+  std::int64_t max_bytes_, generation_ = 0;
+  std::int64_t hits_ = 0, misses_ = 0, released_ = 0, dropped_ = 0;
+  std::int64_t bytes_ = 0, peak_bytes_ = 0;
+};
+
+} // namespace parthenon
+
+#endif // INTERFACE_VARIABLE_STORAGE_POOL_HPP_
@@ -24,11 +24,14 @@
 #include <algorithm>
 #include <cstdint>
 #include <iostream>
+#include <memory>
 #include <numeric>
 #include <sstream>
 #include <string>
 #include <tuple>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "parthenon_mpi.hpp"
 
@@ -36,6 +39,7 @@
 #include "defs.hpp"
 #include "globals.hpp"
 #include "interface/update.hpp"
+#include "mesh/load_balance.hpp"
 #include "mesh/mesh.hpp"
 #include "mesh/mesh_refinement.hpp"
 #include "mesh/meshblock.hpp"
@@ -46,271 +50,390 @@
 
 namespace parthenon {
 
-#ifdef MPI_PARALLEL
-//----------------------------------------------------------------------------------------
-//! \fn int CreateAMRMPITag(int lid, int ox1, int ox2, int ox3)
-//  \brief calculate an MPI tag for AMR block transfer
-// tag = local id of destination (remaining bits) + ox1(1 bit) + ox2(1 bit) + ox3(1 bit)
-//       + physics(5 bits)
-
-// See comments on BoundaryBase::CreateBvalsMPITag()
+namespace {
+// Which kind of transfer a new block is receiving (or an old block is sending)
+enum class AMRTransfer { SameToSame, CoarseToFine, FineToCoarse };
 
-int CreateAMRMPITag(int lid, int ox1, int ox2, int ox3) {
-  // the trailing zero is used as "id" to indicate an AMR related tag
-  return (lid << 8) | (ox1 << 7) | (ox2 << 6) | (ox3 << 5) | 0;
+void LocationOffsets(const LogicalLocation &fine_loc, int &ox1, int &ox2, int &ox3) {
+  ox1 = ((fine_loc.lx1() & 1LL) == 1LL);
+  ox2 = ((fine_loc.lx2() & 1LL) == 1LL);
+  ox3 = ((fine_loc.lx3() & 1LL) == 1LL);
 }
 
-MPI_Request SendCoarseToFine(int lid_recv, int dest_rank, const LogicalLocation &fine_loc,
-                             Variable<Real> *var, Mesh *pmesh) {
-  MPI_Request req;
-  MPI_Comm comm = pmesh->GetMPIComm(var->label());
-
-  const int ox1 = ((fine_loc.lx1() & 1LL) == 1LL);
-  const int ox2 = ((fine_loc.lx2() & 1LL) == 1LL);
-  const int ox3 = ((fine_loc.lx3() & 1LL) == 1LL);
+template <class View>
+void UnpackCoarseToFine(const View &fb, const LogicalLocation &fine_loc,
+                        Variable<Real> *var, MeshBlock *pmb) {
+  int ox1, ox2, ox3;
+  LocationOffsets(fine_loc, ox1, ox2, ox3);
+  auto cb = var->coarse_s;
+  const int nt = var->GetDim(6) - 1;
+  const int nu = var->GetDim(5) - 1;
+  const int nv = var->GetDim(4) - 1;
+
+  for (auto te : var->GetTopologicalElements()) {
+    IndexRange ib = pmb->c_cellbounds.GetBoundsI(IndexDomain::entire, te);
+    IndexRange jb = pmb->c_cellbounds.GetBoundsJ(IndexDomain::entire, te);
+    IndexRange kb = pmb->c_cellbounds.GetBoundsK(IndexDomain::entire, te);
+
+    IndexRange ib_int = pmb->cellbounds.GetBoundsI(IndexDomain::interior, te);
+    IndexRange jb_int = pmb->cellbounds.GetBoundsJ(IndexDomain::interior, te);
+    IndexRange kb_int = pmb->cellbounds.GetBoundsK(IndexDomain::interior, te);
+
+    const int ks = (ox3 == 0) ? 0 : (kb_int.e - kb_int.s + 1) / 2;
+    const int js = (ox2 == 0) ? 0 : (jb_int.e - jb_int.s + 1) / 2;
+    const int is = (ox1 == 0) ? 0 : (ib_int.e - ib_int.s + 1) / 2;
+    const int idx_te = static_cast<int>(te) % 3;
+    parthenon::par_for(
+        DEFAULT_LOOP_PATTERN, "ReceiveCoarseToFineAMR", DevExecSpace(), 0, nt, 0, nu, 0,
+        nv, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int t, const int u, const int v, const int k, const int j,
+                      const int i) {
+          cb(idx_te, t, u, v, k, j, i) = fb(idx_te, t, u, v, k + ks, j + js, i + is);
+        });
+  }
+}
 
-  int tag = CreateAMRMPITag(lid_recv, ox1, ox2, ox3);
-  if (var->IsAllocated()) {
-    PARTHENON_MPI_CHECK(MPI_Isend(var->data.data(), var->data.size(), MPI_PARTHENON_REAL,
-                                  dest_rank, tag, comm, &req));
-  } else {
-    PARTHENON_MPI_CHECK(
-        MPI_Isend(var->data.data(), 0, MPI_PARTHENON_REAL, dest_rank, tag, comm, &req));
+template <class View>
+void UnpackFineToCoarse(const View &cb, const LogicalLocation &fine_loc,
+                        Variable<Real> *var, MeshBlock *pmb) {
+  int ox1, ox2, ox3;
+  LocationOffsets(fine_loc, ox1, ox2, ox3);
+  auto fb = var->data;
+  const int nt = var->GetDim(6) - 1;
+  const int nu = var->GetDim(5) - 1;
+  const int nv = var->GetDim(4) - 1;
+
+  for (auto te : var->GetTopologicalElements()) {
+    IndexRange ib = pmb->c_cellbounds.GetBoundsI(IndexDomain::interior, te);
+    IndexRange jb = pmb->c_cellbounds.GetBoundsJ(IndexDomain::interior, te);
+    IndexRange kb = pmb->c_cellbounds.GetBoundsK(IndexDomain::interior, te);
+    // Deal with ownership of shared elements by removing right side of index
+    // space if fine block is on the left side of a direction. I think this
+    // should work fine even if the ownership model is changed elsewhere, since
+    // the fine blocks should be consistent in their shared elements at this point
+    if (ox3 == 0) kb.e -= TopologicalOffsetK(te);
+    if (ox2 == 0) jb.e -= TopologicalOffsetJ(te);
+    if (ox1 == 0) ib.e -= TopologicalOffsetI(te);
+    const int ks = (ox3 == 0) ? 0 : (kb.e - kb.s + 1 - TopologicalOffsetK(te));
+    const int js = (ox2 == 0) ? 0 : (jb.e - jb.s + 1 - TopologicalOffsetJ(te));
+    const int is = (ox1 == 0) ? 0 : (ib.e - ib.s + 1 - TopologicalOffsetI(te));
+    const int idx_te = static_cast<int>(te) % 3;
+    parthenon::par_for(
+        DEFAULT_LOOP_PATTERN, "ReceiveFineToCoarseAMR", DevExecSpace(), 0, nt, 0, nu, 0,
+        nv, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int t, const int u, const int v, const int k, const int j,
+                      const int i) {
+          fb(idx_te, t, u, v, k + ks, j + js, i + is) = cb(idx_te, t, u, v, k, j, i);
+        });
   }
-  return req;
 }
-#endif
 
-bool TryRecvCoarseToFine(int lid_recv, int send_rank, const LogicalLocation &fine_loc,
-                         Variable<Real> *var_in, Variable<Real> *var, MeshBlock *pmb,
-                         Mesh *pmesh) {
-  const int ox1 = ((fine_loc.lx1() & 1LL) == 1LL);
-  const int ox2 = ((fine_loc.lx2() & 1LL) == 1LL);
-  const int ox3 = ((fine_loc.lx3() & 1LL) == 1LL);
+// Sparse variables that are unallocated on the sending side are deallocated on the
+// receiving block unless they are always allocated on new blocks
+void DeallocateIfAllowed(Variable<Real> *var, MeshBlock *pmb) {
+  if (pmb->IsAllocated(var->label()) &&
+      !var->metadata().IsSet(Metadata::ForceAllocOnNewBlocks))
+    pmb->DeallocateSparse(var->label());
+}
 
-  int test = 1;
-#ifdef MPI_PARALLEL
-  MPI_Comm comm = pmesh->GetMPIComm(var->label());
-  int tag = CreateAMRMPITag(lid_recv, ox1, ox2, ox3);
-  MPI_Status status;
-  PARTHENON_MPI_CHECK(MPI_Iprobe(send_rank, tag, comm, &test, &status));
-#endif
-  if (test) {
-    int size = var_in->IsAllocated();
-#ifdef MPI_PARALLEL
-    PARTHENON_MPI_CHECK(MPI_Get_count(&status, MPI_PARTHENON_REAL, &size));
-#endif
-    if (size > 0) {
+//----------------------------------------------------------------------------------------
+//! \fn void CopyLocalBlockData(AMRTransfer transfer, const LogicalLocation &fine_loc,
+//                              MeshBlock *pob, const VariableVector<Real> &vars,
+//                              MeshBlock *pmb)
+//  \brief fill the variables vars of a new block from an old block that lives on the
+//  same rank
+
+void CopyLocalBlockData(AMRTransfer transfer, const LogicalLocation &fine_loc,
+                        MeshBlock *pob, const VariableVector<Real> &vars,
+                        MeshBlock *pmb) {
+  for (auto &var : vars) {
+    auto var_in = pob->meshblock_data.Get()->GetVarPtr(var->label());
+    if (var_in->IsAllocated()) {
       if (!pmb->IsAllocated(var->label())) pmb->AllocateSparse(var->label());
-      auto fb = var_in->data;
-#ifdef MPI_PARALLEL
-      PARTHENON_MPI_CHECK(MPI_Recv(var->data.data(), var->data.size(), MPI_PARTHENON_REAL,
-                                   send_rank, tag, comm, MPI_STATUS_IGNORE));
-      fb = var->data;
-#endif
-      auto cb = var->coarse_s;
-      const int nt = fb.GetDim(6) - 1;
-      const int nu = fb.GetDim(5) - 1;
-      const int nv = fb.GetDim(4) - 1;
-
-      for (auto te : var->GetTopologicalElements()) {
-        IndexRange ib = pmb->c_cellbounds.GetBoundsI(IndexDomain::entire, te);
-        IndexRange jb = pmb->c_cellbounds.GetBoundsJ(IndexDomain::entire, te);
-        IndexRange kb = pmb->c_cellbounds.GetBoundsK(IndexDomain::entire, te);
-
-        IndexRange ib_int = pmb->cellbounds.GetBoundsI(IndexDomain::interior, te);
-        IndexRange jb_int = pmb->cellbounds.GetBoundsJ(IndexDomain::interior, te);
-        IndexRange kb_int = pmb->cellbounds.GetBoundsK(IndexDomain::interior, te);
-
-        const int ks = (ox3 == 0) ? 0 : (kb_int.e - kb_int.s + 1) / 2;
-        const int js = (ox2 == 0) ? 0 : (jb_int.e - jb_int.s + 1) / 2;
-        const int is = (ox1 == 0) ? 0 : (ib_int.e - ib_int.s + 1) / 2;
-        const int idx_te = static_cast<int>(te) % 3;
-        parthenon::par_for(
-            DEFAULT_LOOP_PATTERN, "ReceiveCoarseToFineAMR", DevExecSpace(), 0, nt, 0, nu,
-            0, nv, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-            KOKKOS_LAMBDA(const int t, const int u, const int v, const int k, const int j,
-                          const int i) {
-              cb(idx_te, t, u, v, k, j, i) = fb(idx_te, t, u, v, k + ks, j + js, i + is);
-            });
+      if (transfer == AMRTransfer::CoarseToFine) {
+        UnpackCoarseToFine(var_in->data, fine_loc, var.get(), pmb);
+      } else {
+        UnpackFineToCoarse(var_in->coarse_s, fine_loc, var.get(), pmb);
       }
-    } else {
-      if (pmb->IsAllocated(var->label()) &&
-          !var->metadata().IsSet(Metadata::ForceAllocOnNewBlocks))
-        pmb->DeallocateSparse(var->label());
-#ifdef MPI_PARALLEL
-      PARTHENON_MPI_CHECK(MPI_Recv(var->data.data(), 0, MPI_PARTHENON_REAL, send_rank,
-                                   tag, comm, MPI_STATUS_IGNORE));
-#endif
+    } else if (transfer == AMRTransfer::CoarseToFine) {
+      DeallocateIfAllowed(var.get(), pmb);
     }
   }
-
-  return test;
 }
 
 #ifdef MPI_PARALLEL
-MPI_Request SendFineToCoarse(int lid_recv, int dest_rank, const LogicalLocation &fine_loc,
-                             Variable<Real> *var, Mesh *pmesh) {
-  MPI_Request req;
-  MPI_Comm comm = pmesh->GetMPIComm(var->label());
-
-  const int ox1 = ((fine_loc.lx1() & 1LL) == 1LL);
-  const int ox2 = ((fine_loc.lx2() & 1LL) == 1LL);
-  const int ox3 = ((fine_loc.lx3() & 1LL) == 1LL);
-
-  int tag = CreateAMRMPITag(lid_recv, ox1, ox2, ox3);
-  if (var->IsAllocated()) {
-    PARTHENON_MPI_CHECK(MPI_Isend(var->coarse_s.data(), var->coarse_s.size(),
-                                  MPI_PARTHENON_REAL, dest_rank, tag, comm, &req));
-  } else {
-    PARTHENON_MPI_CHECK(MPI_Isend(var->coarse_s.data(), 0, MPI_PARTHENON_REAL, dest_rank,
-                                  tag, comm, &req));
+// Unmanaged view onto the section of an aggregated AMR transfer buffer that holds the
+// payload of a single variable
+using AMRBufView_t = Kokkos::View<multi_pointer_t<Real, MAX_VARIABLE_DIMENSION>,
+                                  LayoutWrapper, BufMemSpace, MemUnmanaged>;
+
+// Fine to coarse transfers carry the restricted coarse buffer, everything else carries
+// the full variable data
+bool SendsCoarse(AMRTransfer transfer) { return transfer == AMRTransfer::FineToCoarse; }
+
+std::size_t AMRVarSize(const Variable<Real> *var, bool coarse) {
+  std::size_t size = 1;
+  for (int i = 1; i <= MAX_VARIABLE_DIMENSION; ++i)
+    size *= coarse ? var->GetCoarseDim(i) : var->GetDim(i);
+  return size;
+}
+
+AMRBufView_t MakeAMRBufView(Real *ptr, const Variable<Real> *var, bool coarse) {
+  auto dim = [&](int i) { return coarse ? var->GetCoarseDim(i) : var->GetDim(i); };
+  return AMRBufView_t(ptr, dim(7), dim(6), dim(5), dim(4), dim(3), dim(2), dim(1));
+}
+
+// Every block transfer is a single message of Reals laid out as
+//   [deref count, cost, (is allocated, dealloc count) for each var in vars_cc_,
+//    payload...]
+// where the payload contains the data (or coarse buffer) of every allocated variable in
+// the order of vars_cc_. This way the sparse allocation state, the counters and the
+// cost of the block (its share of the new block for fine to coarse transfers) travel
+// with the data of the block.
+int AMRHeaderSize(const VariableVector<Real> &vars) { return 2 + 2 * vars.size(); }
+
+std::size_t AMRMaxMessageSize(const VariableVector<Real> &vars, AMRTransfer transfer) {
+  std::size_t size = AMRHeaderSize(vars);
+  for (auto &var : vars)
+    size += AMRVarSize(var.get(), SendsCoarse(transfer));
+  return size;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn BufArray1D<Real> PackAMRBlockMessage(const VariableVector<Real> &vars,
+//                                            MeshBlock *pmb, AMRTransfer transfer,
+//                                            double cost)
+//  \brief serialize all variables of a block (and their allocation state) into a
+//  single communication buffer
+
+BufArray1D<Real> PackAMRBlockMessage(const VariableVector<Real> &vars, MeshBlock *pmb,
+                                     AMRTransfer transfer, double cost) {
+  const bool coarse = SendsCoarse(transfer);
+  const int nvar = vars.size();
+  const int nhead = AMRHeaderSize(vars);
+  std::size_t size = nhead;
+  for (auto &var : vars)
+    if (var->IsAllocated()) size += AMRVarSize(var.get(), coarse);
+
+  BufArray1D<Real> buf("AMR send buffer", size);
+  auto header = Kokkos::subview(buf, std::make_pair(0, nhead));
+  auto header_h = Kokkos::create_mirror_view(HostMemSpace(), header);
+  header_h(0) = pmb->pmr->DereferenceCount();
+  header_h(1) = cost;
+  std::size_t offset = nhead;
+  for (int v = 0; v < nvar; ++v) {
+    auto &var = vars[v];
+    header_h(2 + 2 * v) = var->IsAllocated();
+    header_h(3 + 2 * v) = var->dealloc_count;
+    if (var->IsAllocated()) {
+      auto &src = coarse ? var->coarse_s : var->data;
+      Kokkos::deep_copy(DevExecSpace(),
+                        MakeAMRBufView(buf.data() + offset, var.get(), coarse),
+                        src.KokkosView());
+      offset += AMRVarSize(var.get(), coarse);
+    }
   }
-  return req;
+  // Blocking copy, so the header and all payload copies are done when we return
+  Kokkos::deep_copy(header, header_h);
+  return buf;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn double UnpackAMRBlockMessage(const BufArray1D<Real> &buf, AMRTransfer transfer,
+//                                   const LogicalLocation &fine_loc,
+//                                   const VariableVector<Real> &vars, MeshBlock *pmb)
+//  \brief unpack an aggregated block message into the variables of a new block and
+//  return the cost it carries
+
+double UnpackAMRBlockMessage(const BufArray1D<Real> &buf, AMRTransfer transfer,
+                             const LogicalLocation &fine_loc,
+                             const VariableVector<Real> &vars, MeshBlock *pmb) {
+  const bool coarse = SendsCoarse(transfer);
+  const int nvar = vars.size();
+  const int nhead = AMRHeaderSize(vars);
+  auto header_h = Kokkos::create_mirror_view_and_copy(
+      HostMemSpace(), Kokkos::subview(buf, std::make_pair(0, nhead)));
+
+  if (transfer == AMRTransfer::SameToSame)
+    pmb->pmr->DereferenceCount() = static_cast<int>(header_h(0));
+  std::size_t offset = nhead;
+  for (int v = 0; v < nvar; ++v) {
+    auto var = vars[v].get();
+    const bool allocated = header_h(2 + 2 * v) > 0;
+    if (allocated) {
+      if (!pmb->IsAllocated(var->label())) pmb->AllocateSparse(var->label());
+      auto src = MakeAMRBufView(buf.data() + offset, var, coarse);
+      if (transfer == AMRTransfer::SameToSame) {
+        Kokkos::deep_copy(DevExecSpace(), var->data.KokkosView(), src);
+      } else if (transfer == AMRTransfer::CoarseToFine) {
+        UnpackCoarseToFine(src, fine_loc, var, pmb);
+      } else {
+        UnpackFineToCoarse(src, fine_loc, var, pmb);
+      }
+      offset += AMRVarSize(var, coarse);
+    } else if (transfer != AMRTransfer::FineToCoarse) {
+      DeallocateIfAllowed(var, pmb);
+    }
+    if (transfer == AMRTransfer::SameToSame)
+      var->dealloc_count = static_cast<int>(header_h(3 + 2 * v));
+  }
+  return header_h(1);
 }
-#endif
 
-bool TryRecvFineToCoarse(int lid_recv, int send_rank, const LogicalLocation &fine_loc,
-                         Variable<Real> *var_in, Variable<Real> *var, MeshBlock *pmb,
-                         Mesh *pmesh) {
-  const int ox1 = ((fine_loc.lx1() & 1LL) == 1LL);
-  const int ox2 = ((fine_loc.lx2() & 1LL) == 1LL);
-  const int ox3 = ((fine_loc.lx3() & 1LL) == 1LL);
+// A pending block transfer from another rank into a block on this rank
+struct AMRBlockRecv {
+  AMRTransfer transfer;
+  LogicalLocation fine_loc;
+  std::shared_ptr<MeshBlock> pmb;
+  BufArray1D<Real> buf;
+};
+#endif // MPI_PARALLEL
+} // namespace
 
-  int test = 1;
 #ifdef MPI_PARALLEL
-  MPI_Comm comm = pmesh->GetMPIComm(var->label());
-  int tag = CreateAMRMPITag(lid_recv, ox1, ox2, ox3);
-  MPI_Status status;
-  PARTHENON_MPI_CHECK(MPI_Iprobe(send_rank, tag, comm, &test, &status));
+//----------------------------------------------------------------------------------------
+//! \fn int CreateAMRMPITag(int lid, int ox1, int ox2, int ox3)
+//  \brief calculate an MPI tag for AMR block transfer
+// tag = local id of destination (remaining bits) + ox1(1 bit) + ox2(1 bit) + ox3(1 bit)
+//       + physics(5 bits)
+
+// See comments on BoundaryBase::CreateBvalsMPITag()
+
+int CreateAMRMPITag(int lid, int ox1, int ox2, int ox3) {
+  // the trailing zero is used as "id" to indicate an AMR related tag
+  return (lid << 8) | (ox1 << 7) | (ox2 << 6) | (ox3 << 5) | 0;
+}
+
+int CreateAMRMPITag(int lid, const LogicalLocation &fine_loc) {
+  int ox1, ox2, ox3;
+  LocationOffsets(fine_loc, ox1, ox2, ox3);
+  return CreateAMRMPITag(lid, ox1, ox2, ox3);
+}
 #endif
-  if (test) {
-    int size = var_in->IsAllocated();
+
+//----------------------------------------------------------------------------------------
+// \!fn TaskStatus Mesh::StartRemeshExchange()
+// \brief start exchanging the refinement flags and costs of all ranks, which is
+//        completed in LoadBalancingAndAdaptiveMeshRefinement. Adding this as a task once
+//        all blocks are tagged overlaps the exchange with the rest of the step. The task
+//        is incomplete until the counts of flagged blocks have arrived and the gather of
+//        their locations is posted.
+
+TaskStatus Mesh::StartRemeshExchange() {
+  return ExchangeRemeshFlags(false) ? TaskStatus::complete : TaskStatus::incomplete;
+}
+
+//----------------------------------------------------------------------------------------
+// \!fn bool Mesh::ExchangeRemeshFlags(bool wait)
+// \brief advance the exchange of refinement flags and costs. Every rank first gathers the
+//        cost and the number of flagged blocks of every rank, then the locations of the
+//        flagged blocks if a remesh can happen. Returns true once the locations are
+//        posted, or received if wait is set.
+
+bool Mesh::ExchangeRemeshFlags(bool wait) {
+  // static meshes without load balancing have nothing to exchange
+  if (!adaptive && !lb_manual_ && !lb_automatic_) return true;
+  auto phase_timer = remesh_stats.Time(RemeshStats::Phase::flag_gather);
+  const int my_rank = Globals::my_rank, nranks = Globals::nranks;
+
+  if (remesh_exchange_ == RemeshExchange::idle) {
+    lb_flag_ |= lb_automatic_ || lb_model_;
+    UpdateCostList();
+    // cost, number of blocks flagged for refinement and for derefinement of every rank
+    remesh_counts_.assign(3 * nranks, 0.0);
+    double *counts = &remesh_counts_[3 * my_rank];
+    for (auto const &pmb : block_list) {
+      counts[0] += costlist[pmb->gid];
+      if (adaptive && pmb->pmr->refine_flag_ == 1) counts[1] += 1.0;
+      if (adaptive && pmb->pmr->refine_flag_ == -1) counts[2] += 1.0;
+    }
 #ifdef MPI_PARALLEL
-    PARTHENON_MPI_CHECK(MPI_Get_count(&status, MPI_PARTHENON_REAL, &size));
+    PARTHENON_MPI_CHECK(MPI_Iallgather(MPI_IN_PLACE, 3, MPI_DOUBLE, remesh_counts_.data(),
+                                       3, MPI_DOUBLE, MPI_COMM_WORLD,
+                                       &remesh_counts_request_));
 #endif
-    if (size > 0) {
-      if (!pmb->IsAllocated(var->label())) pmb->AllocateSparse(var->label());
-      auto cb = var_in->coarse_s;
+    remesh_stats.AddVolume(RemeshStats::Phase::flag_gather, nblist[my_rank],
+                           3 * sizeof(double));
+    remesh_exchange_ = RemeshExchange::counts;
+  }
+
+  if (remesh_exchange_ == RemeshExchange::counts) {
 #ifdef MPI_PARALLEL
-      // This has to be an MPI_Recv w/o buffering
-      PARTHENON_MPI_CHECK(MPI_Recv(var->coarse_s.data(), var->coarse_s.size(),
-                                   MPI_PARTHENON_REAL, send_rank, tag, comm,
-                                   MPI_STATUS_IGNORE));
-      cb = var->coarse_s;
+    if (wait) {
+      PARTHENON_MPI_CHECK(MPI_Wait(&remesh_counts_request_, MPI_STATUS_IGNORE));
+    } else {
+      int done;
+      PARTHENON_MPI_CHECK(MPI_Test(&remesh_counts_request_, &done, MPI_STATUS_IGNORE));
+      if (!done) return false;
+    }
 #endif
-      auto fb = var->data;
-      const int nt = fb.GetDim(6) - 1;
-      const int nu = fb.GetDim(5) - 1;
-      const int nv = fb.GetDim(4) - 1;
-
-      for (auto te : var->GetTopologicalElements()) {
-        IndexRange ib = pmb->c_cellbounds.GetBoundsI(IndexDomain::interior, te);
-        IndexRange jb = pmb->c_cellbounds.GetBoundsJ(IndexDomain::interior, te);
-        IndexRange kb = pmb->c_cellbounds.GetBoundsK(IndexDomain::interior, te);
-        // Deal with ownership of shared elements by removing right side of index
-        // space if fine block is on the left side of a direction. I think this
-        // should work fine even if the ownership model is changed elsewhere, since
-        // the fine blocks should be consistent in their shared elements at this point
-        if (ox3 == 0) kb.e -= TopologicalOffsetK(te);
-        if (ox2 == 0) jb.e -= TopologicalOffsetJ(te);
-        if (ox1 == 0) ib.e -= TopologicalOffsetI(te);
-        const int ks = (ox3 == 0) ? 0 : (kb.e - kb.s + 1 - TopologicalOffsetK(te));
-        const int js = (ox2 == 0) ? 0 : (jb.e - jb.s + 1 - TopologicalOffsetJ(te));
-        const int is = (ox1 == 0) ? 0 : (ib.e - ib.s + 1 - TopologicalOffsetI(te));
-        const int idx_te = static_cast<int>(te) % 3;
-        parthenon::par_for(
-            DEFAULT_LOOP_PATTERN, "ReceiveFineToCoarseAMR", DevExecSpace(), 0, nt, 0, nu,
-            0, nv, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-            KOKKOS_LAMBDA(const int t, const int u, const int v, const int k, const int j,
-                          const int i) {
-              fb(idx_te, t, u, v, k + ks, j + js, i + is) = cb(idx_te, t, u, v, k, j, i);
-            });
+    int tnref = 0, tnderef = 0;
+    for (int n = 0; n < nranks; n++) {
+      tnref += remesh_counts_[3 * n + 1];
+      tnderef += remesh_counts_[3 * n + 2];
+    }
+    // the locations of blocks flagged for derefinement are only needed if at least one
+    // block can be derefined
+    int nleaf = 2;
+    if (!mesh_size.symmetry(X2DIR)) nleaf = 4;
+    if (!mesh_size.symmetry(X3DIR)) nleaf = 8;
+    const bool gather_deref = (tnderef >= nleaf);
+    remesh_locs_.clear();
+    if (tnref > 0 || gather_deref) {
+      // every rank sends the locations of its blocks flagged for refinement followed by
+      // those flagged for derefinement, in the order of their global IDs
+      remesh_loc_bytes_.resize(nranks);
+      remesh_loc_disp_.resize(nranks);
+      int nlocs = 0, my_disp = 0;
+      for (int n = 0; n < nranks; n++) {
+        const int count = remesh_counts_[3 * n + 1] +
+                          (gather_deref ? remesh_counts_[3 * n + 2] : 0.0);
+        if (n == my_rank) my_disp = nlocs;
+        // MPI counts and displacements are ints
+        remesh_loc_bytes_[n] = static_cast<int>(count * sizeof(LogicalLocation));
+        remesh_loc_disp_[n] = static_cast<int>(nlocs * sizeof(LogicalLocation));
+        nlocs += count;
+      }
+      remesh_locs_.resize(nlocs);
+      int iref = my_disp, ideref = my_disp + remesh_counts_[3 * my_rank + 1];
+      for (auto const &pmb : block_list) {
+        if (pmb->pmr->refine_flag_ == 1) remesh_locs_[iref++] = pmb->loc;
+        if (pmb->pmr->refine_flag_ == -1 && gather_deref)
+          remesh_locs_[ideref++] = pmb->loc;
       }
-      // We have to block here w/o buffering so that the write is guaranteed to be
-      // finished before another fine block that is restricted to a sub-region of
-      // this coarse block makes an MPI call and overwrites the coarse buffer.
-      Kokkos::fence();
-    } else {
 #ifdef MPI_PARALLEL
-      PARTHENON_MPI_CHECK(MPI_Recv(var->data.data(), 0, MPI_PARTHENON_REAL, send_rank,
-                                   tag, comm, MPI_STATUS_IGNORE));
+      PARTHENON_MPI_CHECK(MPI_Iallgatherv(
+          MPI_IN_PLACE, remesh_loc_bytes_[my_rank], MPI_BYTE, remesh_locs_.data(),
+          remesh_loc_bytes_.data(), remesh_loc_disp_.data(), MPI_BYTE, MPI_COMM_WORLD,
+          &remesh_locs_request_));
 #endif
+      remesh_stats.AddVolume(RemeshStats::Phase::flag_gather, 0,
+                             remesh_loc_bytes_[my_rank]);
     }
+    remesh_exchange_ = RemeshExchange::locations;
   }
 
-  return test;
-}
-
 #ifdef MPI_PARALLEL
-MPI_Request SendSameToSame(int lid_recv, int dest_rank, Variable<Real> *var,
-                           MeshBlock *pmb, Mesh *pmesh) {
-  MPI_Request req;
-  MPI_Comm comm = pmesh->GetMPIComm(var->label());
-  int tag = CreateAMRMPITag(lid_recv, 0, 0, 0);
-  if (var->IsAllocated()) {
-    // Metadata about this field also needs to be copied from this rank to the
-    // receiving rank (namely the dereference count and the dealloc_count). Not
-    // doing this can cause some subtle differences between runs of the same
-    // problem on different numbers of ranks. Rather than send individual messages,
-    // we just package these in the first two ghost zones of the block. This is ok
-    // because the AMR communication is only required to communicate the interior
-    // zones. The ghosts are communicated to prevent the need to allocate buffers,
-    // but the data in them is not required to be valid. This requires that we have
-    // at least two ghost zones.
-    PARTHENON_REQUIRE(
-        Globals::nghost > 1,
-        "AMR SameToSame communication requires blocks to have at least two ghost zones");
-    auto counter_subview = Kokkos::subview(var->data, std::make_pair(0, 2));
-    auto counter_subview_h = Kokkos::create_mirror_view(HostMemSpace(), counter_subview);
-    counter_subview_h(0) = pmb->pmr->DereferenceCount();
-    counter_subview_h(1) = var->dealloc_count;
-    Kokkos::deep_copy(counter_subview, counter_subview_h);
-
-    PARTHENON_MPI_CHECK(MPI_Isend(var->data.data(), var->data.size(), MPI_PARTHENON_REAL,
-                                  dest_rank, tag, comm, &req));
-  } else {
-    var->com_state[0] = pmb->pmr->DereferenceCount();
-    var->com_state[1] = var->dealloc_count;
-    PARTHENON_MPI_CHECK(
-        MPI_Isend(var->com_state, 2, MPI_INT, dest_rank, tag, comm, &req));
-  }
-  return req;
+  // a no-op if no locations were gathered
+  if (wait) PARTHENON_MPI_CHECK(MPI_Wait(&remesh_locs_request_, MPI_STATUS_IGNORE));
+#endif
+  return true;
 }
 
-bool TryRecvSameToSame(int lid_recv, int send_rank, Variable<Real> *var, MeshBlock *pmb,
-                       Mesh *pmesh) {
-  MPI_Comm comm = pmesh->GetMPIComm(var->label());
-  int tag = CreateAMRMPITag(lid_recv, 0, 0, 0);
-
-  int test;
-  MPI_Status status;
-  PARTHENON_MPI_CHECK(MPI_Iprobe(send_rank, tag, comm, &test, &status));
-  if (test) {
-    int size;
-    PARTHENON_MPI_CHECK(MPI_Get_count(&status, MPI_PARTHENON_REAL, &size));
-    if (size > 2) {
-      if (!pmb->IsAllocated(var->label())) pmb->AllocateSparse(var->label());
-      PARTHENON_MPI_CHECK(MPI_Recv(var->data.data(), var->data.size(), MPI_PARTHENON_REAL,
-                                   send_rank, tag, comm, MPI_STATUS_IGNORE));
-      auto counter_subview = Kokkos::subview(var->data, std::make_pair(0, 2));
-      auto counter_subview_h =
-          Kokkos::create_mirror_view_and_copy(HostMemSpace(), counter_subview);
-      pmb->pmr->DereferenceCount() = counter_subview_h(0);
-      var->dealloc_count = counter_subview_h(1);
-    } else {
-      if (pmb->IsAllocated(var->label()) &&
-          !var->metadata().IsSet(Metadata::ForceAllocOnNewBlocks))
-        pmb->DeallocateSparse(var->label());
-      PARTHENON_MPI_CHECK(
-          MPI_Recv(var->com_state, 2, MPI_INT, send_rank, tag, comm, MPI_STATUS_IGNORE));
-      pmb->pmr->DereferenceCount() = var->com_state[0];
-      var->dealloc_count = var->com_state[1];
-    }
+//----------------------------------------------------------------------------------------
+// \!fn void Mesh::GatherCostList()
+// \brief collect the cost from the MeshBlocks of all ranks
+
+void Mesh::GatherCostList() {
+#ifdef MPI_PARALLEL
+  // with distributed costs every rank only keeps the costs of its own blocks
+  if ((lb_manual_ || lb_automatic_) && !lb_distributed_) {
+    PARTHENON_MPI_CHECK(MPI_Allgatherv(MPI_IN_PLACE, nblist[Globals::my_rank], MPI_DOUBLE,
+                                       costlist.data(), nblist.data(), nslist.data(),
+                                       MPI_DOUBLE, MPI_COMM_WORLD));
   }
-  return test;
-}
 #endif
+}
 
 //----------------------------------------------------------------------------------------
 // \!fn void Mesh::LoadBalancingAndAdaptiveMeshRefinement(ParameterInput *pin)
@@ -318,8 +441,24 @@ bool TryRecvSameToSame(int lid_recv, int send_rank, Variable<Real> *var, MeshBlo
 
 void Mesh::LoadBalancingAndAdaptiveMeshRefinement(ParameterInput *pin,
                                                   ApplicationInput *app_in) {
+  modified = false;
+  // storage released by sparse deallocations is also freed on meshes that never remesh
+  if (variable_storage_pool_ != nullptr && pool_trim_interval_ > 0 &&
+      ++cycles_since_pool_trim_ >= pool_trim_interval_) {
+    variable_storage_pool_->Trim();
+    cycles_since_pool_trim_ = 0;
+  }
+  // static meshes without load balancing never remesh
+  if (!adaptive && !lb_manual_ && !lb_automatic_) return;
+
   Kokkos::Profiling::pushRegion("LoadBalancingAndAdaptiveMeshRefinement");
+  Kokkos::Timer timer;
   int nnew = 0, ndel = 0;
+  remesh_stats.AddCheck();
+
+  // completes the exchange if it was already started by a task during the step
+  ExchangeRemeshFlags(true);
+  remesh_exchange_ = RemeshExchange::idle;
 
   if (adaptive) {
     UpdateMeshBlockTree(nnew, ndel);
@@ -327,22 +466,33 @@ void Mesh::LoadBalancingAndAdaptiveMeshRefinement(ParameterInput *pin,
     nbdel += ndel;
   }
 
-  lb_flag_ |= lb_automatic_;
-
-  UpdateCostList();
-
-  modified = false;
   if (nnew != 0 || ndel != 0) { // at least one (de)refinement happened
-    GatherCostListAndCheckBalance();
+    GatherCostList();
     RedistributeAndRefineMeshBlocks(pin, app_in, nbtotal + nnew - ndel);
     modified = true;
   } else if (lb_flag_ && step_since_lb >= lb_interval_) {
-    if (!GatherCostListAndCheckBalance()) { // load imbalance detected
+    auto phase_timer = remesh_stats.Time(RemeshStats::Phase::balance);
+    const bool balanced = CheckLoadBalance();
+    phase_timer.Stop();
+    if (!balanced) { // load imbalance detected
+      GatherCostList();
       RedistributeAndRefineMeshBlocks(pin, app_in, nbtotal);
       modified = true;
     }
     lb_flag_ = false;
   }
+  if (modified) {
+    nremesh++;
+    remesh_time += timer.seconds();
+    remesh_stats.Write(nremesh, nbtotal, nnew, ndel);
+    // free the pooled storage that was not reused since the previous remesh
+    if (variable_storage_pool_ != nullptr) {
+      variable_storage_pool_->Trim();
+      cycles_since_pool_trim_ = 0;
+    }
+    // the memory changes most around remeshing, so sample the new high-water marks
+    if (memory_usage.IsEnabled()) memory_usage.Sample(this);
+  }
   Kokkos::Profiling::popRegion(); // LoadBalancingAndAdaptiveMeshRefinement
 }
 
@@ -456,6 +606,48 @@ void Mesh::CalculateLoadBalance(std::vector<double> const &costlist,
   Kokkos::Profiling::popRegion(); // CalculateLoadBalance
 }
 
+//----------------------------------------------------------------------------------------
+// \brief Calculate the distribution of MeshBlocks from the costs of the new blocks
+// [nfirst, nlast] that the blocks of this rank contribute to, without gathering the
+// costs of all blocks. The cost of the blocks before nfirst is found with a prefix sum
+// over the ranks and the first block of every rank with a reduction of nranks ints.
+void Mesh::CalculateDistributedLoadBalance(std::vector<double> const &newcost, int nfirst,
+                                           int nlast, bool decide_first,
+                                           std::vector<int> &ranklist,
+                                           std::vector<int> &nslist,
+                                           std::vector<int> &nblist) {
+  Kokkos::Profiling::pushRegion("CalculateDistributedLoadBalance");
+  const int ntot = newcost.size();
+  const int nranks = Globals::nranks;
+  const std::vector<double> costs(newcost.begin() + nfirst, newcost.begin() + nlast + 1);
+  const double my_cost = std::accumulate(costs.begin(), costs.end(), 0.0);
+  double offset = 0.0, total = my_cost;
+#ifdef MPI_PARALLEL
+  PARTHENON_MPI_CHECK(
+      MPI_Exscan(&my_cost, &offset, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD));
+  // the result of MPI_Exscan is undefined on the first rank
+  if (Globals::my_rank == 0) offset = 0.0;
+  PARTHENON_MPI_CHECK(
+      MPI_Allreduce(&my_cost, &total, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD));
+#endif
+  nslist = load_balance::RankStarts(costs, nfirst, decide_first, offset, total, nranks,
+                                    ntot);
+#ifdef MPI_PARALLEL
+  PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, nslist.data(), nranks, MPI_INT,
+                                    MPI_MIN, MPI_COMM_WORLD));
+#endif
+  load_balance::CompleteRankStarts(nslist, ntot);
+
+  nblist.resize(nranks);
+  ranklist.resize(ntot);
+  for (int rank = 0; rank < nranks; ++rank) {
+    nblist[rank] = (rank < nranks - 1 ? nslist[rank + 1] : ntot) - nslist[rank];
+    auto first = ranklist.begin() + nslist[rank];
+    std::fill(first, first + nblist[rank], rank);
+  }
+  Kokkos::Profiling::popRegion(); // CalculateDistributedLoadBalance
+}
+
 //----------------------------------------------------------------------------------------
 // \!fn void Mesh::ResetLoadBalanceVariables()
 // \brief reset counters and flags for load balancing
@@ -476,7 +668,17 @@ void Mesh::ResetLoadBalanceVariables() {
 // \brief update the cost list
 
 void Mesh::UpdateCostList() {
-  if (lb_automatic_) {
+  if (lb_model_) {
+    for (auto &pmb : block_list) {
+      const auto &cb = pmb->cellbounds;
+      double cost = lb_cell_weight_ * cb.GetTotal(IndexDomain::interior);
+      for (auto &swarm : pmb->swarm_data.Get()->allSwarms()) {
+        auto it = lb_swarm_weights_.find(swarm->label());
+        if (it != lb_swarm_weights_.end()) cost += it->second * swarm->GetNumActive();
+      }
+      costlist[pmb->gid] = cost;
+    }
+  } else if (lb_automatic_) {
     double w = static_cast<double>(lb_interval_ - 1) / static_cast<double>(lb_interval_);
     for (auto &pmb : block_list) {
       costlist[pmb->gid] = costlist[pmb->gid] * w + pmb->cost_;
@@ -494,82 +696,64 @@ void Mesh::UpdateCostList() {
 
 void Mesh::UpdateMeshBlockTree(int &nnew, int &ndel) {
   Kokkos::Profiling::pushRegion("UpdateMeshBlockTree");
+  auto phase_timer = remesh_stats.Time(RemeshStats::Phase::tree_update);
   // compute nleaf= number of leaf MeshBlocks per refined block
   int nleaf = 2;
   if (!mesh_size.symmetry(X2DIR)) nleaf = 4;
   if (!mesh_size.symmetry(X3DIR)) nleaf = 8;
 
-  // collect refinement flags from all the meshblocks
-  // count the number of the blocks to be (de)refined
-  nref[Globals::my_rank] = 0;
-  nderef[Globals::my_rank] = 0;
-  for (auto const &pmb : block_list) {
-    if (pmb->pmr->refine_flag_ == 1) nref[Globals::my_rank]++;
-    if (pmb->pmr->refine_flag_ == -1) nderef[Globals::my_rank]++;
-  }
-#ifdef MPI_PARALLEL
-  PARTHENON_MPI_CHECK(
-      MPI_Allgather(MPI_IN_PLACE, 1, MPI_INT, nref.data(), 1, MPI_INT, MPI_COMM_WORLD));
-  PARTHENON_MPI_CHECK(
-      MPI_Allgather(MPI_IN_PLACE, 1, MPI_INT, nderef.data(), 1, MPI_INT, MPI_COMM_WORLD));
-#endif
-
-  // count the number of the blocks to be (de)refined and displacement
+  // the number of blocks to be (de)refined of every rank was gathered in
+  // ExchangeRemeshFlags
   int tnref = 0, tnderef = 0;
   for (int n = 0; n < Globals::nranks; n++) {
-    tnref += nref[n];
-    tnderef += nderef[n];
+    tnref += remesh_counts_[3 * n + 1];
+    tnderef += remesh_counts_[3 * n + 2];
   }
   if (tnref == 0 && tnderef < nleaf) { // nothing to do
     Kokkos::Profiling::popRegion();    // UpdateMeshBlockTree
     return;
   }
 
-  int rd = 0, dd = 0;
+  // split the gathered locations into the blocks to be refined and derefined, each in
+  // the order of their global IDs
+  std::vector<LogicalLocation> lref, lderef;
+  lref.reserve(tnref);
+  if (tnderef >= nleaf) lderef.reserve(tnderef);
+  auto loc = remesh_locs_.begin();
   for (int n = 0; n < Globals::nranks; n++) {
-    rdisp[n] = rd;
-    ddisp[n] = dd;
-    // technically could overflow, since sizeof() operator returns
-    // std::size_t = long unsigned int > int
-    // on many platforms (LP64). However, these are used below in MPI calls for
-    // integer arguments (recvcounts, displs). MPI does not support > 64-bit count ranges
-    bnref[n] = static_cast<int>(nref[n] * sizeof(LogicalLocation));
-    bnderef[n] = static_cast<int>(nderef[n] * sizeof(LogicalLocation));
-    brdisp[n] = static_cast<int>(rd * sizeof(LogicalLocation));
-    bddisp[n] = static_cast<int>(dd * sizeof(LogicalLocation));
-    rd += nref[n];
-    dd += nderef[n];
-  }
-
-  // allocate memory for the location arrays
-  LogicalLocation *lref{}, *lderef{}, *clderef{};
-  if (tnref > 0) lref = new LogicalLocation[tnref];
-  if (tnderef >= nleaf) {
-    lderef = new LogicalLocation[tnderef];
-    clderef = new LogicalLocation[tnderef / nleaf];
+    const int nref = remesh_counts_[3 * n + 1], nderef = remesh_counts_[3 * n + 2];
+    lref.insert(lref.end(), loc, loc + nref);
+    loc += nref;
+    if (tnderef >= nleaf) {
+      lderef.insert(lderef.end(), loc, loc + nderef);
+      loc += nderef;
+    }
   }
 
-  // collect the locations and costs
-  int iref = rdisp[Globals::my_rank], ideref = ddisp[Globals::my_rank];
-  for (auto const &pmb : block_list) {
-    if (pmb->pmr->refine_flag_ == 1) lref[iref++] = pmb->loc;
-    if (pmb->pmr->refine_flag_ == -1 && tnderef >= nleaf) lderef[ideref++] = pmb->loc;
+  // Extend the refinement by a buffer of blocks around the blocks to be refined, so that
+  // features moving into coarser regions do not trigger a remesh every few cycles. Blocks
+  // inside the buffer are not derefined and their derefinement counters are reset, so a
+  // block only derefines once it has been outside of the buffer for deref_threshold_
+  // cycles.
+  std::vector<LogicalLocation> buffer_region, buffer_lref;
+  if (refinement_buffer_ > 0 && tnref > 0) {
+    tree.GetRefinementBuffer(lref, refinement_buffer_, buffer_region, buffer_lref);
   }
-#ifdef MPI_PARALLEL
-  if (tnref > 0) {
-    PARTHENON_MPI_CHECK(MPI_Allgatherv(MPI_IN_PLACE, bnref[Globals::my_rank], MPI_BYTE,
-                                       lref, bnref.data(), brdisp.data(), MPI_BYTE,
-                                       MPI_COMM_WORLD));
-  }
-  if (tnderef >= nleaf) {
-    PARTHENON_MPI_CHECK(MPI_Allgatherv(MPI_IN_PLACE, bnderef[Globals::my_rank], MPI_BYTE,
-                                       lderef, bnderef.data(), bddisp.data(), MPI_BYTE,
-                                       MPI_COMM_WORLD));
+  auto in_buffer = [&buffer_region, this](LogicalLocation loc) {
+    if (buffer_region.empty()) return false;
+    while (true) {
+      if (std::binary_search(buffer_region.begin(), buffer_region.end(), loc))
+        return true;
+      if (loc.level() <= root_level) return false;
+      loc = loc.GetParent();
+    }
+  };
+  for (auto const &pmb : block_list) {
+    if (in_buffer(pmb->loc)) pmb->pmr->deref_count_ = 0;
   }
-#endif
 
   // calculate the list of the newly derefined blocks
-  int ctnd = 0;
+  std::vector<LogicalLocation> clderef;
   if (tnderef >= nleaf) {
     int lk = 0, lj = 0;
     if (!mesh_size.symmetry(X2DIR)) lj = 1;
@@ -585,70 +769,48 @@ void Mesh::UpdateMeshBlockTree(int &nnew, int &ndel) {
                 if ((lderef[n].lx1() + i) == lderef[r].lx1() &&
                     (lderef[n].lx2() + j) == lderef[r].lx2() &&
                     (lderef[n].lx3() + k) == lderef[r].lx3() &&
-                    lderef[n].level() == lderef[r].level())
+                    lderef[n].level() == lderef[r].level() &&
+                    !in_buffer(lderef[r]))
                   rr++;
                 r++;
               }
             }
           }
         }
-        if (rr == nleaf) {
-          clderef[ctnd] = lderef[n].GetParent();
-          ctnd++;
-        }
+        if (rr == nleaf) clderef.push_back(lderef[n].GetParent());
       }
     }
   }
-  // sort the lists by level
-  if (ctnd > 1) {
-    std::sort(clderef, &(clderef[ctnd - 1]),
-              [](const LogicalLocation &left, const LogicalLocation &right) {
-                return left.level() > right.level();
-              });
-  }
-  if (tnderef >= nleaf) delete[] lderef;
+  // MeshBlockTree::Derefine processes the list level by level, so no sorting is needed
 
   // Now the lists of the blocks to be refined and derefined are completed
   // Start tree manipulation
   // Step 1. perform refinement
-  for (int n = 0; n < tnref; n++) {
-    MeshBlockTree *bt = tree.FindMeshBlock(lref[n]);
-    bt->Refine(nnew);
+  if (tnref != 0) {
+    lref.insert(lref.end(), buffer_lref.begin(), buffer_lref.end());
+    tree.Refine(lref, nnew);
   }
-  if (tnref != 0) delete[] lref;
 
   // Step 2. perform derefinement
-  for (int n = 0; n < ctnd; n++) {
-    MeshBlockTree *bt = tree.FindMeshBlock(clderef[n]);
-    bt->Derefine(ndel);
-  }
-  if (tnderef >= nleaf) delete[] clderef;
+  if (!clderef.empty()) tree.Derefine(clderef, ndel);
 
   Kokkos::Profiling::popRegion(); // UpdateMeshBlockTree
 }
 
 //----------------------------------------------------------------------------------------
-// \!fn bool Mesh::GatherCostListAndCheckBalance()
-// \brief collect the cost from MeshBlocks and check the load balance
+// \!fn bool Mesh::CheckLoadBalance()
+// \brief check the load balance using the costs of the ranks gathered in
+//        ExchangeRemeshFlags, the cost list of the other ranks is only gathered if
+//        rebalancing is needed
 
-bool Mesh::GatherCostListAndCheckBalance() {
+bool Mesh::CheckLoadBalance() {
   if (lb_manual_ || lb_automatic_) {
-#ifdef MPI_PARALLEL
-    PARTHENON_MPI_CHECK(MPI_Allgatherv(MPI_IN_PLACE, nblist[Globals::my_rank], MPI_DOUBLE,
-                                       costlist.data(), nblist.data(), nslist.data(),
-                                       MPI_DOUBLE, MPI_COMM_WORLD));
-#endif
-    double maxcost = 0.0, avecost = 0.0;
-    for (int rank = 0; rank < Globals::nranks; rank++) {
-      double rcost = 0.0;
-      int ns = nslist[rank];
-      int ne = ns + nblist[rank];
-      for (int n = ns; n < ne; ++n)
-        rcost += costlist[n];
-      maxcost = std::max(maxcost, rcost);
-      avecost += rcost;
-    }
-    avecost /= Globals::nranks;
+    double maxcost = 0.0, totalcost = 0.0;
+    for (int n = 0; n < Globals::nranks; n++) {
+      maxcost = std::max(maxcost, remesh_counts_[3 * n]);
+      totalcost += remesh_counts_[3 * n];
+    }
+    const double avecost = totalcost / Globals::nranks;
 
     if (adaptive)
       lb_tolerance_ =
@@ -677,6 +839,7 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
 
   // construct new lists
   Kokkos::Profiling::pushRegion("Construct new list");
+  auto balance_timer = remesh_stats.Time(RemeshStats::Phase::balance);
   std::vector<LogicalLocation> newloc(ntot);
   std::vector<int> newrank(ntot);
   std::vector<double> newcost(ntot);
@@ -704,13 +867,27 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
 
   current_level = 0;
   std::unordered_set<LogicalLocation> newly_refined;
+  // Blocks whose neighbors may have changed, i.e. all refined or derefined blocks and
+  // their possible neighbors. Any other block keeps its neighbors.
+  std::unordered_set<LogicalLocation> changed_neighborhood;
+  const RootGridInfo rg_info = GetRootGridInfo();
+  // with distributed costs only the costs of the old blocks of this rank are known, so
+  // newcost only holds their contributions until the migrated blocks bring their costs
+  auto known_cost = [&](int gid) {
+    return (!lb_distributed_ || ranklist[gid] == Globals::my_rank) ? costlist[gid] : 0.0;
+  };
   for (int n = 0; n < ntot; n++) {
     // "on" = "old n" = "old gid" = "old global MeshBlock ID"
     int on = newtoold[n];
     if (newloc[n].level() > current_level) // set the current max level
       current_level = newloc[n].level();
+    if (newloc[n].level() != loclist[on].level()) {
+      changed_neighborhood.insert(newloc[n]);
+      auto possible_neighbors = newloc[n].GetPossibleNeighbors(rg_info);
+      changed_neighborhood.insert(possible_neighbors.begin(), possible_neighbors.end());
+    }
     if (newloc[n].level() >= loclist[on].level()) { // same or refined
-      newcost[n] = costlist[on];
+      newcost[n] = known_cost(on);
       // Keep a list of all blocks refined for below
       if (newloc[n].level() > loclist[on].level()) {
         newly_refined.insert(newloc[n]);
@@ -718,7 +895,7 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
     } else {
       double acost = 0.0;
       for (int l = 0; l < nleaf; l++)
-        acost += costlist[on + l];
+        acost += known_cost(on + l);
       newcost[n] = acost / nleaf;
     }
   }
@@ -730,18 +907,33 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
   Kokkos::Profiling::popRegion(); // Construct new list
 
   // Calculate new load balance
-  CalculateLoadBalance(newcost, newrank, nslist, nblist);
+  if (lb_distributed_) {
+    // the new blocks that the old blocks of this rank contribute to
+    const int nfirst = oldtonew[onbs];
+    int nlast = oldtonew[onbe];
+    if (newloc[nlast].level() > loclist[onbe].level()) nlast += nleaf - 1;
+    // a coarse block whose first child is on a lower rank is decided by that rank
+    CalculateDistributedLoadBalance(newcost, nfirst, nlast, newtoold[nfirst] >= onbs,
+                                    newrank, nslist, nblist);
+  } else {
+    CalculateLoadBalance(newcost, newrank, nslist, nblist);
+  }
+  balance_timer.Stop();
 
   int nbs = nslist[Globals::my_rank];
   int nbe = nbs + nblist[Globals::my_rank] - 1;
 
   // Restrict fine to coarse buffers
+  auto restriction_timer = remesh_stats.Time(RemeshStats::Phase::restriction);
   ProResCache_t restriction_cache;
-  int nrestrict = 0;
+  int nrestrict = 0, nrestrict_blocks = 0;
   for (int on = onbs; on <= onbe; on++) {
     int nn = oldtonew[on];
     auto pmb = FindMeshBlock(on);
-    if (newloc[nn].level() < loclist[on].level()) nrestrict += pmb->vars_cc_.size();
+    if (newloc[nn].level() < loclist[on].level()) {
+      nrestrict += pmb->vars_cc_.size();
+      nrestrict_blocks++;
+    }
   }
   restriction_cache.Initialize(nrestrict, resolved_packages.get());
   int irestrict = 0;
@@ -749,6 +941,8 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
     int nn = oldtonew[on];
     if (newloc[nn].level() < loclist[on].level()) {
       auto pmb = FindMeshBlock(on);
+      // blocks that are derefined are restricted into their coarse buffers
+      pmb->SetCoarseBuffers(true);
       for (auto &var : pmb->vars_cc_) {
         restriction_cache.RegisterRegionHost(
             irestrict++, ProResInfo::GetInteriorRestrict(pmb.get(), NeighborBlock(), var),
@@ -761,11 +955,19 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
                        block_list[0]->cellbounds, block_list[0]->c_cellbounds);
 
   Kokkos::fence();
+  remesh_stats.AddVolume(RemeshStats::Phase::restriction, nrestrict_blocks, 0);
+  restriction_timer.Stop();
 
 #ifdef MPI_PARALLEL
-  // Send data from old to new blocks
+  // Send data from old to new blocks. Every block transfer to another rank is a single
+  // message containing all variables of the block, see PackAMRBlockMessage. Transfers
+  // within this rank are copied directly from the old blocks below.
   Kokkos::Profiling::pushRegion("AMR: Send");
-  std::vector<MPI_Request> send_reqs;
+  auto send_timer = remesh_stats.Time(RemeshStats::Phase::migration_send);
+  MPI_Comm amr_comm = GetMPIComm(amr_comm_label_);
+  std::vector<BufArray1D<Real>> send_bufs;
+  // (index into send_bufs, destination rank, tag) of every message
+  std::vector<std::tuple<int, int, int>> send_msgs;
   for (int n = onbs; n <= onbe; n++) {
     int nn = oldtonew[n];
     LogicalLocation &oloc = loclist[n];
@@ -773,44 +975,76 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
     auto pb = FindMeshBlock(n);
     if (nloc.level() == oloc.level() &&
         newrank[nn] != Globals::my_rank) { // same level, different rank
-      for (auto &var : pb->vars_cc_)
-        send_reqs.emplace_back(SendSameToSame(nn - nslist[newrank[nn]], newrank[nn],
-                                              var.get(), pb.get(), this));
+      send_bufs.emplace_back(
+          PackAMRBlockMessage(pb->vars_cc_, pb.get(), AMRTransfer::SameToSame,
+                              costlist[n]));
+      send_msgs.emplace_back(send_bufs.size() - 1, newrank[nn],
+                             CreateAMRMPITag(nn - nslist[newrank[nn]], 0, 0, 0));
     } else if (nloc.level() > oloc.level()) { // c2f
-      // c2f must communicate to multiple leaf blocks (unlike f2c, same2same)
+      // c2f must communicate to multiple leaf blocks (unlike f2c, same2same), but the
+      // message is the same for all of them so it is only packed once
+      int ibuf = -1;
       for (int l = 0; l < nleaf; l++) {
         const int nl = nn + l; // Leaf block index in new global block list
-        LogicalLocation &nloc = newloc[nl];
-        for (auto &var : pb->vars_cc_)
-          send_reqs.emplace_back(SendCoarseToFine(nl - nslist[newrank[nl]], newrank[nl],
-                                                  nloc, var.get(), this));
+        if (newrank[nl] == Globals::my_rank) continue;
+        if (ibuf < 0) {
+          send_bufs.emplace_back(
+              PackAMRBlockMessage(pb->vars_cc_, pb.get(), AMRTransfer::CoarseToFine,
+                                  costlist[n]));
+          ibuf = send_bufs.size() - 1;
+        }
+        send_msgs.emplace_back(ibuf, newrank[nl],
+                               CreateAMRMPITag(nl - nslist[newrank[nl]], newloc[nl]));
       } // end loop over nleaf (unique to c2f branch in this step 6)
-    } else if (nloc.level() < oloc.level()) { // f2c: restrict + pack + send
-      for (auto &var : pb->vars_cc_)
-        send_reqs.emplace_back(SendFineToCoarse(nn - nslist[newrank[nn]], newrank[nn],
-                                                oloc, var.get(), this));
+    } else if (nloc.level() < oloc.level() &&
+               newrank[nn] != Globals::my_rank) { // f2c: restrict + pack + send
+      send_bufs.emplace_back(
+          PackAMRBlockMessage(pb->vars_cc_, pb.get(), AMRTransfer::FineToCoarse,
+                              costlist[n] / nleaf));
+      send_msgs.emplace_back(send_bufs.size() - 1, newrank[nn],
+                             CreateAMRMPITag(nn - nslist[newrank[nn]], oloc));
     }
   }
+  std::vector<MPI_Request> send_reqs(send_msgs.size());
+  std::int64_t send_bytes = 0;
+  for (int i = 0; i < send_msgs.size(); ++i) {
+    auto [ibuf, dest_rank, tag] = send_msgs[i];
+    auto &buf = send_bufs[ibuf];
+    PARTHENON_MPI_CHECK(MPI_Isend(buf.data(), buf.size(), MPI_PARTHENON_REAL, dest_rank,
+                                  tag, amr_comm, &send_reqs[i]));
+    send_bytes += buf.size() * sizeof(Real);
+  }
+  remesh_stats.AddVolume(RemeshStats::Phase::migration_send, send_msgs.size(),
+                         send_bytes);
+  send_timer.Stop();
   Kokkos::Profiling::popRegion(); // AMR: Send
 #endif                            // MPI_PARALLEL
 
   // Construct a new MeshBlock list (moving the data within the MPI rank)
   Kokkos::Profiling::pushRegion("AMR: Construct new MeshBlockList");
+  auto construction_timer = remesh_stats.Time(RemeshStats::Phase::block_construction);
   RegionSize block_size = GetBlockSize();
+  int nconstructed = 0;
 
   BlockList_t new_block_list(nbe - nbs + 1);
+  // Blocks that need a full neighbor search, the neighbor lists of the other blocks
+  // only need updated ids
+  std::vector<bool> search_neighbors(nbe - nbs + 1, true);
   for (int n = nbs; n <= nbe; n++) {
     int on = newtoold[n];
     if ((ranklist[on] == Globals::my_rank) &&
         (loclist[on].level() == newloc[n].level())) {
       // on the same MPI rank and same level -> just move it
       new_block_list[n - nbs] = FindMeshBlock(on);
+      search_neighbors[n - nbs] = (changed_neighborhood.count(newloc[n]) > 0);
       if (!new_block_list[n - nbs]) {
+        search_neighbors[n - nbs] = true;
         BoundaryFlag block_bcs[6];
         SetBlockSizeAndBoundaries(newloc[n], block_size, block_bcs);
         new_block_list[n - nbs] =
             MeshBlock::Make(n, n - nbs, newloc[n], block_size, block_bcs, this, pin,
                             app_in, packages, resolved_packages, gflag);
+        nconstructed++;
       }
     } else {
       // on a different refinement level or MPI rank - create a new block
@@ -820,6 +1054,7 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
       new_block_list[n - nbs] =
           MeshBlock::Make(n, n - nbs, newloc[n], block_size, block_bcs, this, pin, app_in,
                           packages, resolved_packages, gflag);
+      nconstructed++;
     }
   }
 
@@ -832,82 +1067,124 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
     block_list[n - nbs]->gid = n;
     block_list[n - nbs]->lid = n - nbs;
   }
+  remesh_stats.AddVolume(RemeshStats::Phase::block_construction, nconstructed, 0);
+  construction_timer.Stop();
 
   Kokkos::Profiling::popRegion(); // AMR: Construct new MeshBlockList
 
   // Receive the data and load into MeshBlocks
   Kokkos::Profiling::pushRegion("AMR: Recv data and unpack");
-  bool all_received;
-  int niter = 0;
-  if (block_list.size() > 0) {
-    // Create a vector for holding the status of all communications, it is sized to fit
-    // the maximal number of calculations that this rank could receive: the number of
-    // blocks on the rank x the number of variables x times the number of fine blocks
-    // that would communicate if every block had been coarsened (8 in 3D)
-    std::vector<bool> finished(
-        std::max((nbe - nbs + 1), 1) * FindMeshBlock(nbs)->vars_cc_.size() * 8, false);
-    do {
-      all_received = true;
-      niter++;
-      int idx = 0;
-      for (int n = nbs; n <= nbe; n++) {
-        int on = newtoold[n];
-        LogicalLocation &oloc = loclist[on];
-        LogicalLocation &nloc = newloc[n];
-        auto pb = FindMeshBlock(n);
-        if (oloc.level() == nloc.level() &&
-            ranklist[on] != Globals::my_rank) { // same level, different rank
+  auto recv_timer = remesh_stats.Time(RemeshStats::Phase::migration_recv);
 #ifdef MPI_PARALLEL
-          for (auto &var : pb->vars_cc_) {
-            if (!finished[idx])
-              finished[idx] =
-                  TryRecvSameToSame(n - nbs, ranklist[on], var.get(), pb.get(), this);
-            all_received = finished[idx++] && all_received;
-          }
-#endif
-        } else if (oloc.level() > nloc.level()) { // f2c
-          for (int l = 0; l < nleaf; l++) {
-            auto pob = pb;
-            if (ranklist[on + l] == Globals::my_rank) pob = old_block_list[on + l - onbs];
-            LogicalLocation &oloc = loclist[on + l];
-            for (auto &var : pb->vars_cc_) {
-              if (!finished[idx]) {
-                auto var_in = pob->meshblock_data.Get()->GetVarPtr(var->label());
-                finished[idx] =
-                    TryRecvFineToCoarse(n - nbs, ranklist[on + l], oloc, var_in.get(),
-                                        var.get(), pb.get(), this);
-              }
-              all_received = finished[idx++] && all_received;
-            }
-          }
-        } else if (oloc.level() < nloc.level()) { // c2f
-          for (auto &var : pb->vars_cc_) {
-            if (!finished[idx]) {
-              auto pob = pb;
-              if (ranklist[on] == Globals::my_rank) pob = old_block_list[on - onbs];
-              auto var_in = pob->meshblock_data.Get()->GetVarPtr(var->label());
-              finished[idx] = TryRecvCoarseToFine(
-                  n - nbs, ranklist[on], nloc, var_in.get(), var.get(), pb.get(), this);
-            }
-            all_received = finished[idx++] && all_received;
-          }
-        }
+  // Pre-post a receive for every block transfer from another rank. The allocation state
+  // of sparse variables on the sending block is not known here, so the buffers are sized
+  // for the case of all variables being allocated.
+  std::vector<AMRBlockRecv> recvs;
+  std::vector<std::pair<int, int>> recv_sources; // (sending rank, tag) of each message
+  auto add_recv = [&](AMRTransfer transfer, const LogicalLocation &fine_loc,
+                      const std::shared_ptr<MeshBlock> &pb, int send_rank, int tag) {
+    recvs.push_back(AMRBlockRecv{
+        transfer, fine_loc, pb,
+        BufArray1D<Real>("AMR recv buffer", AMRMaxMessageSize(pb->vars_cc_, transfer))});
+    recv_sources.emplace_back(send_rank, tag);
+  };
+  for (int n = nbs; n <= nbe; n++) {
+    int on = newtoold[n];
+    LogicalLocation &oloc = loclist[on];
+    LogicalLocation &nloc = newloc[n];
+    auto pb = FindMeshBlock(n);
+    if (oloc.level() == nloc.level() &&
+        ranklist[on] != Globals::my_rank) { // same level, different rank
+      add_recv(AMRTransfer::SameToSame, nloc, pb, ranklist[on],
+               CreateAMRMPITag(n - nbs, 0, 0, 0));
+    } else if (oloc.level() > nloc.level()) { // f2c
+      for (int l = 0; l < nleaf; l++) {
+        if (ranklist[on + l] == Globals::my_rank) continue;
+        add_recv(AMRTransfer::FineToCoarse, loclist[on + l], pb, ranklist[on + l],
+                 CreateAMRMPITag(n - nbs, loclist[on + l]));
       }
-      // rb_idx is a running index, so we repeat the loop until all vals are true
-    } while (!all_received && niter < 1e7);
-    if (!all_received) PARTHENON_FAIL("AMR Receive failed");
+    } else if (oloc.level() < nloc.level() && ranklist[on] != Globals::my_rank) { // c2f
+      add_recv(AMRTransfer::CoarseToFine, nloc, pb, ranklist[on],
+               CreateAMRMPITag(n - nbs, nloc));
+    }
+  }
+  std::vector<MPI_Request> recv_reqs(recvs.size());
+  for (int i = 0; i < recvs.size(); ++i) {
+    auto &buf = recvs[i].buf;
+    PARTHENON_MPI_CHECK(MPI_Irecv(buf.data(), buf.size(), MPI_PARTHENON_REAL,
+                                  recv_sources[i].first, recv_sources[i].second,
+                                  amr_comm, &recv_reqs[i]));
+  }
+#endif // MPI_PARALLEL
+
+  // Fill new blocks whose old data lives on this rank while the messages are in flight
+  std::int64_t nlocal_copies = 0;
+  for (int n = nbs; n <= nbe; n++) {
+    int on = newtoold[n];
+    LogicalLocation &oloc = loclist[on];
+    LogicalLocation &nloc = newloc[n];
+    auto pb = FindMeshBlock(n);
+    if (oloc.level() > nloc.level()) { // f2c
+      for (int l = 0; l < nleaf; l++) {
+        if (ranklist[on + l] != Globals::my_rank) continue;
+        auto pob = old_block_list[on + l - onbs];
+        CopyLocalBlockData(AMRTransfer::FineToCoarse, loclist[on + l], pob.get(),
+                           pb->vars_cc_, pb.get());
+        nlocal_copies++;
+      }
+    } else if (oloc.level() < nloc.level() && ranklist[on] == Globals::my_rank) { // c2f
+      auto pob = old_block_list[on - onbs];
+      CopyLocalBlockData(AMRTransfer::CoarseToFine, nloc, pob.get(), pb->vars_cc_,
+                         pb.get());
+      nlocal_copies++;
+    }
+  }
+
+#ifdef MPI_PARALLEL
+  // Unpack the messages from other ranks in the order they arrive
+  std::vector<int> completed(recv_reqs.size());
+  std::vector<MPI_Status> statuses(recv_reqs.size());
+  std::int64_t recv_bytes = 0;
+  int nremaining = recv_reqs.size();
+  while (nremaining > 0) {
+    int ncompleted;
+    PARTHENON_MPI_CHECK(MPI_Waitsome(recv_reqs.size(), recv_reqs.data(), &ncompleted,
+                                     completed.data(), statuses.data()));
+    for (int i = 0; i < ncompleted; ++i) {
+      auto &recv = recvs[completed[i]];
+      const double cost = UnpackAMRBlockMessage(recv.buf, recv.transfer, recv.fine_loc,
+                                                recv.pmb->vars_cc_, recv.pmb.get());
+      // complete the costs of the new blocks that were not known on this rank
+      if (lb_distributed_) {
+        auto &new_cost = newcost[recv.pmb->gid];
+        new_cost = (recv.transfer == AMRTransfer::FineToCoarse) ? new_cost + cost : cost;
+      }
+      int count;
+      PARTHENON_MPI_CHECK(MPI_Get_count(&statuses[i], MPI_PARTHENON_REAL, &count));
+      recv_bytes += count * sizeof(Real);
+    }
+    nremaining -= ncompleted;
   }
+  remesh_stats.AddVolume(RemeshStats::Phase::migration_recv, recvs.size(), recv_bytes);
+#endif // MPI_PARALLEL
   // Fence here to be careful that all communication is finished before moving
   // on to prolongation
   Kokkos::fence();
+  // copies within the rank are counted as blocks without bytes sent
+  remesh_stats.AddVolume(RemeshStats::Phase::migration_recv, nlocal_copies, 0);
+  recv_timer.Stop();
 
   // Prolongate blocks that had a coarse buffer filled (i.e. c2f blocks)
+  auto prolongation_timer = remesh_stats.Time(RemeshStats::Phase::prolongation);
   ProResCache_t prolongation_cache;
-  int nprolong = 0;
+  int nprolong = 0, nprolong_blocks = 0;
   for (int nn = nbs; nn <= nbe; nn++) {
     int on = newtoold[nn];
     auto pmb = FindMeshBlock(nn);
-    if (newloc[nn].level() > loclist[on].level()) nprolong += pmb->vars_cc_.size();
+    if (newloc[nn].level() > loclist[on].level()) {
+      nprolong += pmb->vars_cc_.size();
+      nprolong_blocks++;
+    }
   }
   prolongation_cache.Initialize(nprolong, resolved_packages.get());
   int iprolong = 0;
@@ -927,6 +1204,8 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
 
   refinement::ProlongateShared(resolved_packages.get(), prolongation_cache,
                                block_list[0]->cellbounds, block_list[0]->c_cellbounds);
+  remesh_stats.AddVolume(RemeshStats::Phase::prolongation, nprolong_blocks, 0);
+  prolongation_timer.Stop();
 
   // update the lists
   loclist = std::move(newloc);
@@ -942,34 +1221,61 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
   // in order to maintain a consistent global state.
   // Thus we rebuild and synchronize the mesh now, but using a unique
   // neighbor precedence favoring the "old" fine blocks over "new" ones
+  auto neighbor_timer = remesh_stats.Time(RemeshStats::Phase::neighbor_search);
+  int nsearched = 0;
   for (auto &pmb : block_list) {
-    pmb->pbval->SearchAndSetNeighbors(this, tree, ranklist.data(), nslist.data(),
-                                      newly_refined);
+    if (search_neighbors[pmb->lid]) {
+      nsearched++;
+      pmb->pbval->SearchAndSetNeighbors(this, tree, ranklist.data(), nslist.data(),
+                                        newly_refined);
+    } else {
+      pmb->pbval->UpdateNeighborIds(tree, ranklist.data(), nslist.data());
+    }
   }
+  neighbor_timer.Stop();
   // Make sure all old sends/receives are done before we reconfigure the mesh
 #ifdef MPI_PARALLEL
-  if (send_reqs.size() != 0)
+  if (send_reqs.size() != 0) {
+    auto phase_timer = remesh_stats.Time(RemeshStats::Phase::migration_send);
     PARTHENON_MPI_CHECK(
         MPI_Waitall(send_reqs.size(), send_reqs.data(), MPI_STATUSES_IGNORE));
+  }
 #endif
   // Re-initialize the mesh with our temporary ownership/neighbor configurations.
   // No buffers are different when we switch to the final precedence order.
+  neighbor_timer.Restart();
   SetSameLevelNeighbors(block_list, leaf_grid_locs, this->GetRootGridInfo(), nbs, false,
                         0, newly_refined);
-  BuildGMGHierarchy(nbs, pin, app_in);
-  Initialize(false, pin, app_in);
+  neighbor_timer.Stop();
+  {
+    auto phase_timer = remesh_stats.Time(RemeshStats::Phase::gmg);
+    BuildGMGHierarchy(nbs, pin, app_in);
+  }
+  BuildBlockPartitions();
+  {
+    auto phase_timer = remesh_stats.Time(RemeshStats::Phase::buffer_cache);
+    Initialize(false, pin, app_in);
+  }
 
   // Internal refinement relies on the fine shared values, which are only consistent after
   // being updated with any previously fine versions
+  prolongation_timer.Restart();
   refinement::ProlongateInternal(resolved_packages.get(), prolongation_cache,
                                  block_list[0]->cellbounds, block_list[0]->c_cellbounds);
+  prolongation_timer.Stop();
 
   // Rebuild just the ownership model, this time weighting the "new" fine blocks just like
   // any other blocks at their level.
+  neighbor_timer.Restart();
   SetSameLevelNeighbors(block_list, leaf_grid_locs, this->GetRootGridInfo(), nbs, false);
+  // The ownership only differs from the first search for blocks next to newly refined
+  // blocks, which are all in the changed neighborhood
   for (auto &pmb : block_list) {
-    pmb->pbval->SearchAndSetNeighbors(this, tree, ranklist.data(), nslist.data());
+    if (search_neighbors[pmb->lid])
+      pmb->pbval->SearchAndSetNeighbors(this, tree, ranklist.data(), nslist.data());
   }
+  remesh_stats.AddVolume(RemeshStats::Phase::neighbor_search, nsearched, 0);
+  neighbor_timer.Stop();
 
   Kokkos::Profiling::popRegion(); // AMR: Recv data and unpack
 
@@ -0,0 +1,63 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file load_balance.cpp
+//  \brief prefix sum assignment of blocks to ranks from distributed block costs
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include "mesh/load_balance.hpp"
+#include "utils/error_checking.hpp"
+
+namespace parthenon {
+namespace load_balance {
+
+std::vector<int> RankStarts(const std::vector<double> &costs, int first_gid,
+                            bool decide_first, double offset, double total, int nranks,
+                            int ntot) {
+  if (total <= 0.0 || ntot < nranks) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in CalculateLoadBalance" << std::endl
+        << "There is at least one process which has no MeshBlock" << std::endl
+        << "Decrease the number of processes or use smaller MeshBlocks." << std::endl;
+    PARTHENON_FAIL(msg);
+  }
+  std::vector<int> starts(nranks, ntot);
+  double position = offset;
+  for (int i = 0; i < costs.size(); ++i) {
+    const double midpoint = position + 0.5 * costs[i];
+    position += costs[i];
+    if (i == 0 && !decide_first) continue;
+    const int rank = std::min(nranks - 1, static_cast<int>(midpoint * nranks / total));
+    starts[rank] = std::min(starts[rank], first_gid + i);
+  }
+  return starts;
+}
+
+void CompleteRankStarts(std::vector<int> &starts, int ntot) {
+  const int nranks = starts.size();
+  // ranks without blocks start where the next rank starts
+  starts[nranks - 1] = std::min(starts[nranks - 1], ntot);
+  for (int rank = nranks - 2; rank >= 0; --rank)
+    starts[rank] = std::min(starts[rank], starts[rank + 1]);
+  // then every rank gets at least one block
+  starts[0] = 0;
+  for (int rank = 1; rank < nranks; ++rank)
+    starts[rank] = std::max(starts[rank], starts[rank - 1] + 1);
+  for (int rank = nranks - 1; rank >= 0; --rank)
+    starts[rank] = std::min(starts[rank], ntot - nranks + rank);
+}
+
+} // namespace load_balance
+} // namespace parthenon
@@ -0,0 +1,43 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef MESH_LOAD_BALANCE_HPP_
+#define MESH_LOAD_BALANCE_HPP_
+
+#include <vector>
+
+namespace parthenon {
+namespace load_balance {
+
+// Assignment of index-contiguous blocks to ranks from a prefix sum over the block costs,
+// used by parthenon/loadbalancing/distributed. Every rank only knows the costs of a
+// range of blocks and where the cumulative cost of this range starts, so no rank needs
+// the costs of all blocks. A block goes to the rank whose equal share of the total cost
+// contains the midpoint of the block.
+//
+// RankStarts returns the lowest global id that the blocks [first_gid, first_gid +
+// costs.size()) assign to each rank, or ntot for ranks that none of these blocks are
+// assigned to. The first block is only counted if decide_first is set, otherwise
+// another rank holds the rest of its cost and decides it. offset is the cumulative cost
+// of all blocks before first_gid and total the cost of all blocks.
+std::vector<int> RankStarts(const std::vector<double> &costs, int first_gid,
+                            bool decide_first, double offset, double total, int nranks,
+                            int ntot);
+
+// Turn the minimum of the starts of all ranks into the first global id of every rank,
+// making sure that every rank gets at least one of the ntot blocks
+void CompleteRankStarts(std::vector<int> &starts, int ntot);
+
+} // namespace load_balance
+} // namespace parthenon
+
+#endif // MESH_LOAD_BALANCE_HPP_
@@ -0,0 +1,251 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file memory_usage.cpp
+//  \brief breakdown of the memory of the local blocks by package, variable, component
+//         and stage
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "globals.hpp"
+#include "interface/mesh_data.hpp"
+#include "interface/meshblock_data.hpp"
+#include "interface/state_descriptor.hpp"
+#include "interface/swarm_container.hpp"
+#include "interface/variable.hpp"
+#include "mesh/memory_usage.hpp"
+#include "mesh/mesh.hpp"
+#include "mesh/meshblock.hpp"
+#include "parthenon_mpi.hpp"
+#include "utils/error_checking.hpp"
+
+namespace parthenon {
+
+const char *MemoryUsage::ComponentName(Component component) {
+  switch (component) {
+  case Component::data:
+    return "data";
+  case Component::fluxes:
+    return "fluxes";
+  case Component::coarse:
+    return "coarse";
+  case Component::boundary_buffers:
+    return "boundary_buffers";
+  case Component::swarm:
+    return "swarm";
+  case Component::pack_cache:
+    return "pack_cache";
+  case Component::storage_pool:
+    return "storage_pool";
+  default:
+    PARTHENON_FAIL("Unknown memory component");
+  }
+}
+
+void MemoryUsage::Sample(Mesh *pmesh) {
+  for (auto &[key, usage] : usage_)
+    usage.current = 0;
+
+  // package of every field and swarm
+  std::unordered_map<std::string, std::string> packages;
+  for (const auto &[name, pkg] : pmesh->packages.AllPackages()) {
+    for (const auto &[vid, m] : pkg->AllFields())
+      packages[vid.base_name] = name;
+    for (const auto &[base_name, pool] : pkg->AllSparsePools())
+      packages[base_name] = name;
+    for (const auto &[swarm, m] : pkg->AllSwarms())
+      packages[swarm] = name;
+  }
+  auto package = [&packages](const std::string &name) {
+    auto it = packages.find(name);
+    return it == packages.end() ? std::string() : it->second;
+  };
+
+  // the data pointers of the storage counted so far
+  std::unordered_set<const void *> counted;
+  auto add = [&](const key_t &key, const void *ptr, std::int64_t bytes) {
+    if (bytes == 0 || !counted.insert(ptr).second) return;
+    usage_[key].current += bytes;
+  };
+
+  // base name of every variable label, to attribute the boundary buffers
+  std::unordered_map<std::string, std::string> base_names;
+  for (auto &pmb : pmesh->block_list) {
+    std::vector<std::string> stages{"base"};
+    for (const auto &[stage, pmbd] : pmb->meshblock_data.Stages())
+      if (stage != "base") stages.push_back(stage);
+    for (const auto &stage : stages) {
+      auto &pmbd = pmb->meshblock_data.Get(stage);
+      for (const auto &v : pmbd->GetVariableVector()) {
+        if (!v->IsAllocated()) continue;
+        const auto pkg = package(v->base_name());
+        base_names[v->label()] = v->base_name();
+        add({pkg, v->label(), Component::data, stage}, v->data.data(),
+            v->data.size() * sizeof(Real));
+        std::int64_t flux_bytes = 0;
+        for (int d = X1DIR; d <= X3DIR; ++d)
+          flux_bytes += v->flux[d].size() * sizeof(Real);
+        add({pkg, v->label(), Component::fluxes, stage}, v->flux[X1DIR].data(),
+            flux_bytes);
+        add({pkg, v->label(), Component::coarse, stage}, v->coarse_s.data(),
+            v->coarse_s.size() * sizeof(Real));
+      }
+      const auto &cache = pmbd->GetSparsePackCache();
+      add({"", "", Component::pack_cache, stage}, &cache, cache.SizeInBytes());
+    }
+
+    for (const auto &[stage, swarms] : pmb->swarm_data.Stages()) {
+      for (const auto &swarm : swarms->GetSwarmVector()) {
+        const key_t key{package(swarm->label()), swarm->label(), Component::swarm, stage};
+        for (const auto &v : swarm->GetVariableVector<Real>())
+          add(key, v->data.data(), v->data.size() * sizeof(Real));
+        for (const auto &v : swarm->GetVariableVector<int>())
+          add(key, v->data.data(), v->data.size() * sizeof(int));
+      }
+    }
+  }
+
+  // the boundary buffers are shared by all stages
+  for (const auto *comm_map :
+       {&pmesh->boundary_comm_map, &pmesh->boundary_comm_flxcor_map}) {
+    for (const auto &[key, buf] : *comm_map) {
+      const auto &label = std::get<2>(key);
+      auto it = base_names.find(label);
+      const auto pkg = it == base_names.end() ? std::string() : package(it->second);
+      add({pkg, label, Component::boundary_buffers, ""}, buf.buffer().data(),
+          buf.buffer().size() * sizeof(Real));
+    }
+  }
+
+  auto add_mesh_data = [&](const std::shared_ptr<MeshData<Real>> &md) {
+    if (md == nullptr) return;
+    const auto &cache = md->GetSparsePackCache();
+    add({"", "", Component::pack_cache, md->StageName()}, &cache, cache.SizeInBytes());
+  };
+  for (const auto &[stage, md] : pmesh->mesh_data.Stages())
+    add_mesh_data(md);
+  for (const auto &partitions : pmesh->mesh_data.Partitions())
+    for (const auto &md : partitions)
+      add_mesh_data(md);
+
+  const auto &pool = pmesh->GetVariableStoragePool();
+  if (pool != nullptr) {
+    add({"", "", Component::storage_pool, ""}, pool.get(), pool->SizeInBytes());
+  }
+
+  for (auto &[key, usage] : usage_)
+    usage.high_water = std::max(usage.high_water, usage.current);
+}
+
+std::int64_t MemoryUsage::CurrentTotal() const {
+  std::int64_t total = 0;
+  for (const auto &[key, usage] : usage_)
+    total += usage.current;
+  return total;
+}
+
+std::vector<MemoryUsage::ReducedUsage> MemoryUsage::Reduce() const {
+  // entries are identified across ranks by their keys joined with ','
+  auto name = [](const key_t &key) {
+    return std::get<0>(key) + "," + std::get<1>(key) + "," +
+           ComponentName(std::get<2>(key)) + "," + std::get<3>(key);
+  };
+  std::map<std::string, key_t> keys;
+  for (const auto &[key, usage] : usage_)
+    keys.emplace(name(key), key);
+
+#ifdef MPI_PARALLEL
+  // union of the entries of all ranks
+  std::string local;
+  for (const auto &[n, key] : keys)
+    local += n + "\n";
+  int len = local.size();
+  std::vector<int> lens(Globals::nranks), displs(Globals::nranks, 0);
+  PARTHENON_MPI_CHECK(
+      MPI_Allgather(&len, 1, MPI_INT, lens.data(), 1, MPI_INT, MPI_COMM_WORLD));
+  for (int r = 1; r < Globals::nranks; ++r)
+    displs[r] = displs[r - 1] + lens[r - 1];
+  std::string all(displs.back() + lens.back(), '\0');
+  PARTHENON_MPI_CHECK(MPI_Allgatherv(local.data(), len, MPI_CHAR, all.data(),
+                                     lens.data(), displs.data(), MPI_CHAR,
+                                     MPI_COMM_WORLD));
+  std::istringstream lines(all);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (line.empty() || keys.count(line) > 0) continue;
+    // split the name into the fields of the key
+    std::vector<std::string> fields;
+    std::istringstream field_stream(line);
+    std::string field;
+    while (std::getline(field_stream, field, ','))
+      fields.push_back(field);
+    fields.resize(4);
+    auto component = Component::data;
+    for (int c = 0; c < static_cast<int>(Component::count); ++c) {
+      if (fields[2] == ComponentName(static_cast<Component>(c))) {
+        component = static_cast<Component>(c);
+      }
+    }
+    keys.emplace(line, key_t{fields[0], fields[1], component, fields[3]});
+  }
+#endif
+
+  // current and high-water values of all entries, negated for the minimum
+  const int n = keys.size();
+  std::vector<std::int64_t> max_vals(2 * n), min_vals(2 * n), sum_vals(2 * n);
+  int i = 0;
+  for (const auto &[nm, key] : keys) {
+    auto it = usage_.find(key);
+    const Usage usage = it == usage_.end() ? Usage() : it->second;
+    max_vals[i] = sum_vals[i] = usage.current;
+    max_vals[n + i] = sum_vals[n + i] = usage.high_water;
+    min_vals[i] = -usage.current;
+    min_vals[n + i] = -usage.high_water;
+    i++;
+  }
+#ifdef MPI_PARALLEL
+  PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, max_vals.data(), 2 * n, MPI_INT64_T,
+                                    MPI_MAX, MPI_COMM_WORLD));
+  PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, min_vals.data(), 2 * n, MPI_INT64_T,
+                                    MPI_MAX, MPI_COMM_WORLD));
+  PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, sum_vals.data(), 2 * n, MPI_INT64_T,
+                                    MPI_SUM, MPI_COMM_WORLD));
+#endif
+
+  std::vector<ReducedUsage> reduced;
+  reduced.reserve(n);
+  i = 0;
+  for (const auto &[nm, key] : keys) {
+    ReducedUsage r;
+    r.key = key;
+    r.current_min = -min_vals[i];
+    r.current_max = max_vals[i];
+    r.current_mean = static_cast<double>(sum_vals[i]) / Globals::nranks;
+    r.high_water_min = -min_vals[n + i];
+    r.high_water_max = max_vals[n + i];
+    r.high_water_mean = static_cast<double>(sum_vals[n + i]) / Globals::nranks;
+    reduced.push_back(r);
+    i++;
+  }
+  return reduced;
+}
+
+} // namespace parthenon
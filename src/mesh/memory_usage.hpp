@@ -0,0 +1,80 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef MESH_MEMORY_USAGE_HPP_
+#define MESH_MEMORY_USAGE_HPP_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace parthenon {
+
+class Mesh;
+
+// Breakdown of the device memory of the local blocks by package, variable, component and
+// stage. Every Sample sets the current value of each entry and raises its high-water
+// mark, which is thus the maximum over all samples. Storage shared by several variables
+// or stages is counted once, for the first one using it (the base stage first).
+class MemoryUsage {
+ public:
+  enum class Component : int {
+    data,             // data of the variables
+    fluxes,           // fluxes of the variables
+    coarse,           // coarse buffers of the variables
+    boundary_buffers, // boundary and flux correction communication buffers
+    swarm,            // particle pools of the swarms
+    pack_cache,       // cached sparse packs of MeshData and MeshBlockData
+    storage_pool,     // storage kept for reuse by the VariableStoragePool
+    count
+  };
+  static const char *ComponentName(Component component);
+
+  // (package, variable or swarm, component, stage). Entries that are not specific to a
+  // package, variable or stage have an empty string there.
+  using key_t = std::tuple<std::string, std::string, Component, std::string>;
+  struct Usage {
+    std::int64_t current = 0;
+    std::int64_t high_water = 0;
+  };
+  // an entry reduced over all ranks, ranks without the entry count as using 0 bytes
+  struct ReducedUsage {
+    key_t key;
+    std::int64_t current_min, current_max, high_water_min, high_water_max;
+    double current_mean, high_water_mean;
+  };
+
+  // Sample the memory after every remesh in addition to explicit calls of Sample
+  void Enable() { enabled_ = true; }
+  bool IsEnabled() const { return enabled_; }
+
+  // Update the entries with the memory currently used on this rank
+  void Sample(Mesh *pmesh);
+
+  const std::map<key_t, Usage> &Entries() const { return usage_; }
+  // sum of the current values of all entries on this rank
+  std::int64_t CurrentTotal() const;
+
+  // The entries of all ranks in the same order on all ranks. Has to be called on all
+  // ranks.
+  std::vector<ReducedUsage> Reduce() const;
+
+ private:
+  bool enabled_ = false;
+  std::map<key_t, Usage> usage_;
+};
+
+} // namespace parthenon
+
+#endif // MESH_MEMORY_USAGE_HPP_
@@ -20,11 +20,14 @@
 #include <algorithm>
 #include <cstdint>
 #include <iostream>
+#include <memory>
 #include <numeric>
 #include <sstream>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "parthenon_mpi.hpp"
 
@@ -158,14 +161,29 @@ void Mesh::BuildGMGHierarchy(int nbs, ParameterInput *pin, ApplicationInput *app
   gmg_min_logical_level_ = gmg_min_level;
 
   const int gmg_levels = current_level - gmg_min_level + 1;
+
+  // Keep the previous hierarchy, so that after a remesh only the levels touched by the
+  // refinement changes are rebuilt. Since gmg_min_level only depends on the root grid,
+  // a GMG level index refers to the same logical level before and after a remesh.
+  const int old_gmg_levels = gmg_grid_locs.size();
+  auto old_grid_locs = std::move(gmg_grid_locs);
+  auto old_block_lists = std::move(gmg_block_lists);
+  auto old_mesh_data = std::move(gmg_mesh_data);
+  const bool same_pack_size = (gmg_pack_size_ == DefaultPackSize());
+  gmg_pack_size_ = DefaultPackSize();
+
+  // Internal node blocks of the previous hierarchy on this rank, by level and location
+  std::vector<std::unordered_map<LogicalLocation, std::shared_ptr<MeshBlock>>>
+      old_internal_blocks(old_gmg_levels);
+  for (int gmg_level = 0; gmg_level < old_gmg_levels; ++gmg_level) {
+    for (auto &pmb : old_block_lists[gmg_level]) {
+      if (pmb->lid < 0) old_internal_blocks[gmg_level][pmb->loc] = pmb;
+    }
+  }
+
   gmg_grid_locs = std::vector<LogicalLocMap_t>(gmg_levels);
   gmg_block_lists = std::vector<BlockList_t>(gmg_levels);
 
-  // Create MeshData objects for GMG
-  gmg_mesh_data = std::vector<DataCollection<MeshData<Real>>>(gmg_levels);
-  for (auto &mdc : gmg_mesh_data)
-    mdc.SetMeshPointer(this);
-
   // Add leaf grid locations to GMG grid levels
   int gmg_gid = 0;
   for (auto loc : loclist) {
@@ -195,12 +213,21 @@ void Mesh::BuildGMGHierarchy(int nbs, ParameterInput *pin, ApplicationInput *app
           gmg_grid_locs[gmg_level].insert(
               {parent, std::make_pair(gmg_gid, gid_rank.second)});
           if (gid_rank.second == Globals::my_rank) {
-            BoundaryFlag block_bcs[6];
-            auto block_size = block_size_default;
-            SetBlockSizeAndBoundaries(parent, block_size, block_bcs);
-            gmg_block_lists[gmg_level].push_back(
-                MeshBlock::Make(gmg_gid, -1, parent, block_size, block_bcs, this, pin,
-                                app_in, packages, resolved_packages, gflag));
+            std::shared_ptr<MeshBlock> pmb;
+            if (gmg_level < old_gmg_levels) {
+              auto it = old_internal_blocks[gmg_level].find(parent);
+              if (it != old_internal_blocks[gmg_level].end()) pmb = it->second;
+            }
+            if (pmb) {
+              pmb->gid = gmg_gid;
+            } else {
+              BoundaryFlag block_bcs[6];
+              auto block_size = block_size_default;
+              SetBlockSizeAndBoundaries(parent, block_size, block_bcs);
+              pmb = MeshBlock::Make(gmg_gid, -1, parent, block_size, block_bcs, this, pin,
+                                    app_in, packages, resolved_packages, gflag);
+            }
+            gmg_block_lists[gmg_level].push_back(pmb);
           }
           gmg_gid++;
         }
@@ -208,19 +235,85 @@ void Mesh::BuildGMGHierarchy(int nbs, ParameterInput *pin, ApplicationInput *app
     }
   }
 
-  // Find same level neighbors on all GMG levels
+  // A level is unchanged if it contains the same locations on the same ranks and its
+  // local blocks are the same objects. The global ids are not compared, since the ids of
+  // all internal nodes shift whenever the number of leaves changes.
+  auto same_locations = [](const LogicalLocMap_t &locs, const LogicalLocMap_t &old_locs) {
+    if (locs.size() != old_locs.size()) return false;
+    for (auto &[loc, gid_rank] : locs) {
+      auto it = old_locs.find(loc);
+      if (it == old_locs.end() || it->second.second != gid_rank.second) return false;
+    }
+    return true;
+  };
+  auto same_blocks = [](const BlockList_t &blocks, const BlockList_t &old_blocks) {
+    if (blocks.size() != old_blocks.size()) return false;
+    std::unordered_set<MeshBlock *> old_set;
+    for (auto &pmb : old_blocks)
+      old_set.insert(pmb.get());
+    for (auto &pmb : blocks) {
+      if (old_set.count(pmb.get()) == 0) return false;
+    }
+    return true;
+  };
+  std::vector<bool> changed(gmg_levels, true);
+  for (int gmg_level = 0; gmg_level < std::min(gmg_levels, old_gmg_levels); ++gmg_level) {
+    if (same_pack_size &&
+        same_locations(gmg_grid_locs[gmg_level], old_grid_locs[gmg_level]) &&
+        same_blocks(gmg_block_lists[gmg_level], old_block_lists[gmg_level])) {
+      changed[gmg_level] = false;
+      // keep the order of the blocks the partitions of the level were built from
+      gmg_block_lists[gmg_level] = std::move(old_block_lists[gmg_level]);
+    }
+  }
+
+  // Reuse the MeshData of unchanged levels, which keeps their partitions and pack
+  // caches. Their boundary buffers are rebuilt in Initialize, so only the cached
+  // boundary information is reset.
+  gmg_mesh_data = std::vector<DataCollection<MeshData<Real>>>(gmg_levels);
+  for (int gmg_level = 0; gmg_level < gmg_levels; ++gmg_level) {
+    if (!changed[gmg_level]) {
+      gmg_mesh_data[gmg_level] = std::move(old_mesh_data[gmg_level]);
+      for (auto &[label, md] : gmg_mesh_data[gmg_level].Stages())
+        md->GetBvarsCache().clear();
+      for (auto &stage : gmg_mesh_data[gmg_level].Partitions()) {
+        for (auto &md : stage)
+          md->GetBvarsCache().clear();
+      }
+    } else {
+      gmg_mesh_data[gmg_level].SetMeshPointer(this);
+    }
+  }
+
+  // Find same level neighbors on changed GMG levels. The blocks of unchanged levels keep
+  // their neighbors, whose global and local ids are only updated.
   auto root_grid = this->GetRootGridInfo();
   for (int gmg_level = 0; gmg_level < gmg_levels; ++gmg_level) {
     int grid_logical_level = gmg_level - gmg_levels + 1 + current_level;
-    SetSameLevelNeighbors(gmg_block_lists[gmg_level], gmg_grid_locs[gmg_level], root_grid,
-                          nbs, true, grid_logical_level);
+    if (changed[gmg_level]) {
+      SetSameLevelNeighbors(gmg_block_lists[gmg_level], gmg_grid_locs[gmg_level],
+                            root_grid, nbs, true, grid_logical_level);
+      continue;
+    }
+    for (auto &pmb : gmg_block_lists[gmg_level]) {
+      auto &neighbors = pmb->loc.level() == grid_logical_level
+                            ? pmb->gmg_same_neighbors
+                            : pmb->gmg_composite_finer_neighbors;
+      for (auto &nb : neighbors) {
+        nb.snb.gid = gmg_grid_locs[gmg_level].at(nb.loc).first;
+        nb.snb.lid = nb.snb.gid - nbs;
+      }
+    }
   }
 
-  // Now find GMG coarser neighbor
-  for (int gmg_level = 1; gmg_level < gmg_levels; ++gmg_level) {
+  // Now find GMG coarser neighbor, which only needs a lookup per block, so it is done on
+  // all levels to pick up the new global ids of the neighboring levels
+  for (int gmg_level = 0; gmg_level < gmg_levels; ++gmg_level) {
     int grid_logical_level = gmg_level - gmg_levels + 1 + current_level;
     for (auto &pmb : gmg_block_lists[gmg_level]) {
       if (pmb->loc.level() != grid_logical_level) continue;
+      pmb->gmg_coarser_neighbors.clear();
+      if (gmg_level == 0) continue;
       auto parent_loc = pmb->loc.GetParent();
       auto loc = pmb->loc;
       auto gid = pmb->gid;
@@ -239,10 +332,12 @@ void Mesh::BuildGMGHierarchy(int nbs, ParameterInput *pin, ApplicationInput *app
   }
 
   // Now find finer GMG neighbors
-  for (int gmg_level = 0; gmg_level < gmg_levels - 1; ++gmg_level) {
+  for (int gmg_level = 0; gmg_level < gmg_levels; ++gmg_level) {
     int grid_logical_level = gmg_level - gmg_levels + 1 + current_level;
     for (auto &pmb : gmg_block_lists[gmg_level]) {
       if (pmb->loc.level() != grid_logical_level) continue;
+      pmb->gmg_finer_neighbors.clear();
+      if (gmg_level == gmg_levels - 1) continue;
       auto daughter_locs = pmb->loc.GetDaughters();
       for (auto &daughter_loc : daughter_locs) {
         if (gmg_grid_locs[gmg_level + 1].count(daughter_loc) > 0) {
@@ -18,6 +18,7 @@
 //  \brief implementation of functions in Mesh class
 
 #include <algorithm>
+#include <cctype>
 #include <cinttypes>
 #include <cmath>
 #include <cstdint>
@@ -99,12 +100,13 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, Packages_t &packages,
       multigrid(pin->GetOrAddString("parthenon/mesh", "multigrid", "false") == "true"
                     ? true
                     : false),
-      nbnew(), nbdel(), step_since_lb(), gflag(), packages(packages),
+      nbnew(), nbdel(), nremesh(), remesh_time(), step_since_lb(), gflag(),
+      packages(packages),
       // private members:
       num_mesh_threads_(pin->GetOrAddInteger("parthenon/mesh", "num_threads", 1)),
       tree(this), use_uniform_meshgen_fn_{true, true, true, true}, lb_flag_(true),
-      lb_automatic_(),
-      lb_manual_(), MeshBndryFnctn{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr} {
+      lb_automatic_(), lb_manual_(), lb_model_(),
+      MeshBndryFnctn{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr} {
   std::stringstream msg;
   RegionSize block_size;
   BoundaryFlag block_bcs[6];
@@ -236,6 +238,8 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, Packages_t &packages,
 
   // Load balancing flag and parameters
   RegisterLoadBalancing_(pin);
+  RegisterVariableStorage_(pin);
+  RegisterRemeshStats_(pin);
 
   // SMR / AMR:
   if (adaptive) {
@@ -246,12 +250,18 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, Packages_t &packages,
           << 63 - root_level + 1 << "." << std::endl;
       PARTHENON_FAIL(msg);
     }
+    refinement_buffer_ = pin->GetOrAddInteger("parthenon/mesh", "refinement_buffer", 0);
+    PARTHENON_REQUIRE_THROWS(refinement_buffer_ >= 0,
+                             "parthenon/mesh/refinement_buffer must be non-negative");
   } else {
     max_level = 63;
+    refinement_buffer_ = 0;
   }
 
   InitUserMeshData(this, pin);
 
+  // locations of all statically refined blocks
+  std::vector<LogicalLocation> smr_locs;
   if (multilevel) {
     if (block_size.nx(X1DIR) % 2 == 1 || (block_size.nx(X2DIR) % 2 == 1 && (ndim >= 2)) ||
         (block_size.nx(X3DIR) % 2 == 1 && (ndim >= 3))) {
@@ -341,9 +351,7 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, Packages_t &packages,
         for (std::int64_t k = l_region_min[2]; k < l_region_max[2]; k += 2) {
           for (std::int64_t j = l_region_min[1]; j < l_region_max[1]; j += 2) {
             for (std::int64_t i = l_region_min[0]; i < l_region_max[0]; i += 2) {
-              LogicalLocation nloc(lrlev, i, j, k);
-              int nnew;
-              tree.AddMeshBlock(nloc, nnew);
+              smr_locs.emplace_back(lrlev, i, j, k);
             }
           }
         }
@@ -352,6 +360,10 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, Packages_t &packages,
     }
   }
 
+  // refine the tree for all regions at once
+  int nnew = 0;
+  tree.AddMeshBlock(smr_locs, nnew);
+
   // initial mesh hierarchy construction is completed here
   tree.CountMeshBlock(nbtotal);
   loclist.resize(nbtotal);
@@ -377,16 +389,6 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, Packages_t &packages,
 
   nslist = std::vector<int>(Globals::nranks);
   nblist = std::vector<int>(Globals::nranks);
-  if (adaptive) { // allocate arrays for AMR
-    nref = std::vector<int>(Globals::nranks);
-    nderef = std::vector<int>(Globals::nranks);
-    rdisp = std::vector<int>(Globals::nranks);
-    ddisp = std::vector<int>(Globals::nranks);
-    bnref = std::vector<int>(Globals::nranks);
-    bnderef = std::vector<int>(Globals::nranks);
-    brdisp = std::vector<int>(Globals::nranks);
-    bddisp = std::vector<int>(Globals::nranks);
-  }
 
   // initialize cost array with the simplest estimate; all the blocks are equal
   costlist = std::vector<double>(nbtotal, 1.0);
@@ -429,6 +431,7 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, Packages_t &packages,
   }
   SetSameLevelNeighbors(block_list, leaf_grid_locs, this->GetRootGridInfo(), nbs, false);
   BuildGMGHierarchy(nbs, pin, app_in);
+  BuildBlockPartitions();
   ResetLoadBalanceVariables();
 }
 
@@ -475,12 +478,13 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, RestartReader &rr,
       multigrid(pin->GetOrAddString("parthenon/mesh", "multigrid", "false") == "true"
                     ? true
                     : false),
-      nbnew(), nbdel(), step_since_lb(), gflag(), packages(packages),
+      nbnew(), nbdel(), nremesh(), remesh_time(), step_since_lb(), gflag(),
+      packages(packages),
       // private members:
       num_mesh_threads_(pin->GetOrAddInteger("parthenon/mesh", "num_threads", 1)),
       tree(this), use_uniform_meshgen_fn_{true, true, true, true}, lb_flag_(true),
-      lb_automatic_(),
-      lb_manual_(), MeshBndryFnctn{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr} {
+      lb_automatic_(), lb_manual_(), lb_model_(),
+      MeshBndryFnctn{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr} {
   std::stringstream msg;
   RegionSize block_size;
   BoundaryFlag block_bcs[6];
@@ -572,6 +576,8 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, RestartReader &rr,
 
   // Load balancing flag and parameters
   RegisterLoadBalancing_(pin);
+  RegisterVariableStorage_(pin);
+  RegisterRemeshStats_(pin);
 
   // SMR / AMR
   if (adaptive) {
@@ -584,8 +590,12 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, RestartReader &rr,
           << 63 - root_level + 1 << "." << std::endl;
       PARTHENON_FAIL(msg);
     }
+    refinement_buffer_ = pin->GetOrAddInteger("parthenon/mesh", "refinement_buffer", 0);
+    PARTHENON_REQUIRE_THROWS(refinement_buffer_ >= 0,
+                             "parthenon/mesh/refinement_buffer must be non-negative");
   } else {
     max_level = 63;
+    refinement_buffer_ = 0;
   }
 
   InitUserMeshData(this, pin);
@@ -606,9 +616,7 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, RestartReader &rr,
   // rebuild the Block Tree
   tree.CreateRootGrid();
 
-  for (int i = 0; i < nbtotal; i++) {
-    tree.AddMeshBlockWithoutRefine(loclist[i]);
-  }
+  tree.AddMeshBlockWithoutRefine(loclist);
 
   int nnb;
   // check the tree structure, and assign GID
@@ -640,16 +648,6 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, RestartReader &rr,
   nslist = std::vector<int>(Globals::nranks);
   nblist = std::vector<int>(Globals::nranks);
 
-  if (adaptive) { // allocate arrays for AMR
-    nref = std::vector<int>(Globals::nranks);
-    nderef = std::vector<int>(Globals::nranks);
-    rdisp = std::vector<int>(Globals::nranks);
-    ddisp = std::vector<int>(Globals::nranks);
-    bnref = std::vector<int>(Globals::nranks);
-    bnderef = std::vector<int>(Globals::nranks);
-    brdisp = std::vector<int>(Globals::nranks);
-    bddisp = std::vector<int>(Globals::nranks);
-  }
 
   CalculateLoadBalance(costlist, ranklist, nslist, nblist);
   PopulateLeafLocationMap();
@@ -693,6 +691,7 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, RestartReader &rr,
   }
   SetSameLevelNeighbors(block_list, leaf_grid_locs, this->GetRootGridInfo(), nbs, false);
   BuildGMGHierarchy(nbs, pin, app_in);
+  BuildBlockPartitions();
   ResetLoadBalanceVariables();
 }
 
@@ -926,7 +925,16 @@ void Mesh::Initialize(bool init_problem, ParameterInput *pin, ApplicationInput *
       pmb->InitMeshBlockUserData(pmb, pin);
     }
 
+    // the neighbors are known now, so release the coarse buffers that are not needed
+    // before the boundary buffers are built
+    if (lazy_coarse_buffers_ && multilevel) {
+      for (auto &pmb : block_list)
+        pmb->SetCoarseBuffers(pmb->NeedsCoarseBuffers());
+    }
+
     const int num_partitions = DefaultNumPartitions();
+    // "base" is the first stage of the leaf and of every GMG collection
+    const int base_id = mesh_data.GetStageId("base");
 
     // problem generator
     if (init_problem) {
@@ -940,7 +948,7 @@ void Mesh::Initialize(bool init_problem, ParameterInput *pin, ApplicationInput *
                           "Mesh ProblemGenerator requires parthenon/mesh/pack_size=-1 "
                           "during first initialization.");
 
-        auto &md = mesh_data.GetOrAdd("base", 0);
+        auto &md = mesh_data.GetOrAddPartition(base_id, 0);
         ProblemGenerator(this, pin, md.get());
         // Call individual MeshBlock ProblemGenerator
       } else {
@@ -959,17 +967,17 @@ void Mesh::Initialize(bool init_problem, ParameterInput *pin, ApplicationInput *
       Update::PreCommFillDerived(mbd.get());
     }
     for (int i = 0; i < num_partitions; ++i) {
-      auto &md = mesh_data.GetOrAdd("base", i);
+      auto &md = mesh_data.GetOrAddPartition(base_id, i);
       Update::PreCommFillDerived(md.get());
     }
 
     // Build densely populated communication tags
     tag_map.clear();
     for (int i = 0; i < num_partitions; i++) {
-      auto &md = mesh_data.GetOrAdd("base", i);
+      auto &md = mesh_data.GetOrAddPartition(base_id, i);
       tag_map.AddMeshDataToMap<BoundaryType::any>(md);
       for (int gmg_level = 0; gmg_level < gmg_mesh_data.size(); ++gmg_level) {
-        auto &mdg = gmg_mesh_data[gmg_level].GetOrAdd(gmg_level, "base", i);
+        auto &mdg = gmg_mesh_data[gmg_level].GetOrAddPartition(base_id, i, gmg_level);
         // tag_map.AddMeshDataToMap<BoundaryType::any>(mdg);
         tag_map.AddMeshDataToMap<BoundaryType::gmg_same>(mdg);
         tag_map.AddMeshDataToMap<BoundaryType::gmg_prolongate_send>(mdg);
@@ -1005,10 +1013,10 @@ void Mesh::Initialize(bool init_problem, ParameterInput *pin, ApplicationInput *
     boundary_comm_flxcor_map.clear();
 
     for (int i = 0; i < num_partitions; i++) {
-      auto &md = mesh_data.GetOrAdd("base", i);
+      auto &md = mesh_data.GetOrAddPartition(base_id, i);
       BuildBoundaryBuffers(md);
       for (int gmg_level = 0; gmg_level < gmg_mesh_data.size(); ++gmg_level) {
-        auto &mdg = gmg_mesh_data[gmg_level].GetOrAdd(gmg_level, "base", i);
+        auto &mdg = gmg_mesh_data[gmg_level].GetOrAddPartition(base_id, i, gmg_level);
         BuildBoundaryBuffers(mdg);
         BuildGMGBoundaryBuffers(mdg);
       }
@@ -1020,7 +1028,7 @@ void Mesh::Initialize(bool init_problem, ParameterInput *pin, ApplicationInput *
     do {
       all_sent = true;
       for (int i = 0; i < num_partitions; i++) {
-        auto &md = mesh_data.GetOrAdd("base", i);
+        auto &md = mesh_data.GetOrAddPartition(base_id, i);
         if (!sent[i]) {
           if (SendBoundaryBuffers(md) != TaskStatus::complete) {
             all_sent = false;
@@ -1044,7 +1052,7 @@ void Mesh::Initialize(bool init_problem, ParameterInput *pin, ApplicationInput *
     do {
       all_received = true;
       for (int i = 0; i < num_partitions; i++) {
-        auto &md = mesh_data.GetOrAdd("base", i);
+        auto &md = mesh_data.GetOrAddPartition(base_id, i);
         if (!received[i]) {
           if (ReceiveBoundaryBuffers(md) != TaskStatus::complete) {
             all_received = false;
@@ -1060,14 +1068,14 @@ void Mesh::Initialize(bool init_problem, ParameterInput *pin, ApplicationInput *
         "Too many iterations waiting to receive boundary communication buffers.");
 
     for (int i = 0; i < num_partitions; i++) {
-      auto &md = mesh_data.GetOrAdd("base", i);
+      auto &md = mesh_data.GetOrAddPartition(base_id, i);
       // unpack FillGhost variables
       SetBoundaries(md);
     }
 
     //  Now do prolongation, compute primitives, apply BCs
     for (int i = 0; i < num_partitions; i++) {
-      auto &md = mesh_data.GetOrAdd("base", i);
+      auto &md = mesh_data.GetOrAddPartition(base_id, i);
       if (multilevel) {
         ApplyBoundaryConditionsOnCoarseOrFineMD(md, true);
         ProlongateBoundaries(md);
@@ -1130,6 +1138,24 @@ std::shared_ptr<MeshBlock> Mesh::FindMeshBlock(int tgid) const {
   return block_list[i];
 }
 
+//----------------------------------------------------------------------------------------
+// \!fn void Mesh::BuildBlockPartitions()
+// \brief Partition the leaf and GMG block lists into packs of the default size. Called
+//        whenever the block lists change, so that the MeshData of the partitions can be
+//        created without partitioning the blocks again.
+
+void Mesh::BuildBlockPartitions() {
+  auto partition_blocks = [&](BlockList_t &blocks) {
+    // Account for possibly empty block lists
+    if (blocks.empty()) return std::vector<BlockList_t>(1);
+    return partition::ToSizeN(blocks, DefaultPackSize());
+  };
+  block_partitions_ = partition_blocks(block_list);
+  gmg_block_partitions_.resize(gmg_block_lists.size());
+  for (int gmg_level = 0; gmg_level < gmg_block_lists.size(); ++gmg_level)
+    gmg_block_partitions_[gmg_level] = partition_blocks(gmg_block_lists[gmg_level]);
+}
+
 //----------------------------------------------------------------------------------------
 // \!fn void Mesh::SetBlockSizeAndBoundaries(LogicalLocation loc,
 //                 RegionSize &block_size, BundaryFlag *block_bcs)
@@ -1211,11 +1237,54 @@ int Mesh::GetNumberOfMeshBlockCells() const {
 const RegionSize &Mesh::GetBlockSize() const { return base_block_size; }
 
 // Functionality re-used in mesh constructor
+void Mesh::RegisterRemeshStats_(ParameterInput *pin) {
+  if (pin->GetOrAddBoolean("parthenon/mesh", "remesh_stats", false)) {
+    // a restarted run appends to the records of the original run
+    remesh_stats.Enable(pin->GetOrAddString("parthenon/job", "problem_id", "parthenon") +
+                            ".remesh.csv",
+                        is_restart);
+  }
+}
+
+// Functionality re-used in mesh constructor
+void Mesh::RegisterVariableStorage_(ParameterInput *pin) {
+  const std::string block = "parthenon/mesh";
+  if (pin->GetOrAddBoolean(block, "pool_variable_storage", true)) {
+    // negative for no limit
+    const Real max_mb = pin->GetOrAddReal(block, "pool_variable_storage_max_mb", 256.0);
+    variable_storage_pool_ = std::make_shared<VariableStoragePool<Real>>(
+        max_mb < 0.0 ? -1 : static_cast<std::int64_t>(max_mb * 1024 * 1024));
+    // non-positive to trim only after remeshing
+    pool_trim_interval_ =
+        pin->GetOrAddInteger(block, "pool_variable_storage_trim_interval", 10);
+  }
+  copy_on_write_stages_ = pin->GetOrAddBoolean(block, "copy_on_write_stages", false);
+  lazy_coarse_buffers_ = pin->GetOrAddBoolean(block, "lazy_coarse_buffers", false);
+  // the geometric multigrid uses the coarse buffers of all blocks
+  PARTHENON_REQUIRE_THROWS(!lazy_coarse_buffers_ || !multigrid,
+                           "parthenon/mesh/lazy_coarse_buffers is incompatible with "
+                           "multigrid");
+
+  auto &options = variable_arena_options_;
+  options.mesh_wide = pin->GetOrAddBoolean(block, "mesh_variable_storage", false);
+  options.enabled =
+      pin->GetOrAddBoolean(block, "variable_arena", false) || options.mesh_wide;
+  options.alignment = pin->GetOrAddInteger(block, "variable_arena_alignment", 64);
+  options.padding = pin->GetOrAddInteger(block, "variable_arena_padding", 0);
+  // the storage of all local blocks is allocated with the first block, so the blocks of
+  // a rank must not change
+  PARTHENON_REQUIRE_THROWS(
+      !options.mesh_wide || (!adaptive && !lb_automatic_ && !lb_manual_),
+      "parthenon/mesh/mesh_variable_storage requires a mesh without adaptive refinement "
+      "or load balancing");
+}
+
 void Mesh::RegisterLoadBalancing_(ParameterInput *pin) {
-#ifdef MPI_PARALLEL // JMM: Not sure this ifdef is needed
-  const std::string balancer =
-      pin->GetOrAddString("parthenon/loadbalancing", "balancer", "default",
-                          std::vector<std::string>{"default", "automatic", "manual"});
+  // also read without MPI, where the blocks of a remesh are assigned the same way
+  lb_distributed_ = pin->GetOrAddBoolean("parthenon/loadbalancing", "distributed", false);
+  const std::string balancer = pin->GetOrAddString(
+      "parthenon/loadbalancing", "balancer", "default",
+      std::vector<std::string>{"default", "automatic", "manual", "model"});
   if (balancer == "automatic") {
     // JMM: I am disabling timing based load balancing, as it's not
     // threaded through the infrastructure. I think some thought needs
@@ -1225,10 +1294,39 @@ void Mesh::RegisterLoadBalancing_(ParameterInput *pin) {
     lb_automatic_ = true;
   } else if (balancer == "manual") {
     lb_manual_ = true;
+  } else if (balancer == "model") {
+    // costs are set from the cost model instead of SetCostForLoadBalancing
+    lb_manual_ = true;
+    lb_model_ = true;
+    lb_cell_weight_ = pin->GetOrAddReal("parthenon/loadbalancing", "cell_weight", 1.0);
+    const Real particle_weight =
+        pin->GetOrAddReal("parthenon/loadbalancing", "particle_weight", 1.0);
+    for (auto const &[name, pkg] : packages.AllPackages()) {
+      // package names may contain characters that are not allowed in input keys
+      std::string key = "particle_weight_" + name;
+      std::replace_if(
+          key.begin(), key.end(), [](char c) { return !std::isalnum(c) && c != '_'; },
+          '_');
+      const Real pkg_weight = pin->DoesParameterExist("parthenon/loadbalancing", key)
+                                  ? pin->GetReal("parthenon/loadbalancing", key)
+                                  : 1.0;
+      // keyed by the label of the swarm in the resolved packages, which is prefixed by
+      // the package for private swarms. A swarm shared by several packages gets the
+      // weight of the package providing it.
+      for (auto const &[label, metadata] : pkg->AllSwarms()) {
+        const auto role = metadata.Role();
+        if (role == Metadata::Private) {
+          lb_swarm_weights_[name + "::" + label] = particle_weight * pkg_weight;
+        } else if (role == Metadata::Provides) {
+          lb_swarm_weights_[label] = particle_weight * pkg_weight;
+        } else if (role == Metadata::Overridable) {
+          lb_swarm_weights_.emplace(label, particle_weight * pkg_weight);
+        }
+      }
+    }
   }
   lb_tolerance_ = pin->GetOrAddReal("parthenon/loadbalancing", "tolerance", 0.5);
   lb_interval_ = pin->GetOrAddInteger("parthenon/loadbalancing", "interval", 10);
-#endif // MPI_PARALLEL
 }
 
 // Create separate communicators for all variables. Needs to be done at the mesh
@@ -1266,6 +1364,11 @@ void Mesh::SetupMPIComms() {
     const auto ret = mpi_comm_map_.insert({pair.first, mpi_comm});
     PARTHENON_REQUIRE_THROWS(ret.second, "Communicator with same name already in map");
   }
+  // All variables of a block are sent in a single message when blocks are migrated
+  MPI_Comm amr_comm;
+  PARTHENON_MPI_CHECK(MPI_Comm_dup(MPI_COMM_WORLD, &amr_comm));
+  const auto ret = mpi_comm_map_.insert({amr_comm_label_, amr_comm});
+  PARTHENON_REQUIRE_THROWS(ret.second, "Communicator with same name already in map");
   // TODO(everying during a sync) we should discuss what to do with face vars as they
   // are currently not handled in pmb->meshblock_data.Get()->SetupPersistentMPI(); nor
   // inserted into pmb->pbval->bvars.
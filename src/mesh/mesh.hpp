@@ -22,6 +22,7 @@
 //  (potentially on different levels) that tile the entire domain.
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <map>
@@ -44,9 +45,13 @@
 #include "interface/data_collection.hpp"
 #include "interface/mesh_data.hpp"
 #include "interface/state_descriptor.hpp"
+#include "interface/variable_arena.hpp"
+#include "interface/variable_storage_pool.hpp"
 #include "kokkos_abstraction.hpp"
 #include "mesh/meshblock_pack.hpp"
 #include "mesh/meshblock_tree.hpp"
+#include "mesh/memory_usage.hpp"
+#include "mesh/remesh_stats.hpp"
 #include "outputs/io_wrapper.hpp"
 #include "parameter_input.hpp"
 #include "parthenon_arrays.hpp"
@@ -79,6 +84,8 @@ class Mesh {
   friend class BoundaryBase;
   friend class BoundaryValues;
   friend class MeshRefinement;
+  template <typename T>
+  friend class MeshBlockData;
 
  public:
   // 2x function overloads of ctor: normal and restarted simulation
@@ -108,6 +115,14 @@ class Mesh {
   const int ndim; // number of dimensions
   const bool adaptive, multilevel, multigrid;
   int nbtotal, nbnew, nbdel;
+  // number of times the mesh was modified by AMR or load balancing and the time spent
+  int nremesh;
+  double remesh_time;
+  // per phase breakdown of remeshing, written to <problem_id>.remesh.csv if enabled
+  RemeshStats remesh_stats;
+  // memory of the local blocks by package, variable, component and stage, sampled by
+  // memory usage outputs and after every remesh once enabled
+  MemoryUsage memory_usage;
   std::uint64_t mbcnt;
   bool analysis_flag; // flag if this mesh is constructed for postprocessing
 
@@ -134,12 +149,40 @@ class Mesh {
   void OutputCycleDiagnostics();
   void LoadBalancingAndAdaptiveMeshRefinement(ParameterInput *pin,
                                               ApplicationInput *app_in);
+  TaskStatus StartRemeshExchange();
+  // nullptr if parthenon/mesh/pool_variable_storage is false
+  const std::shared_ptr<VariableStoragePool<Real>> &GetVariableStoragePool() const {
+    return variable_storage_pool_;
+  }
+  // layout of the arenas holding the dense variables of the blocks, if enabled by
+  // parthenon/mesh/variable_arena
+  const VariableArenaOptions &GetVariableArenaOptions() const {
+    return variable_arena_options_;
+  }
+  // whether non-shallow stage copies share the data of variables that are not exchanged
+  // with neighbors until they are written, set by parthenon/mesh/copy_on_write_stages
+  bool CopyOnWriteStages() const { return copy_on_write_stages_; }
+  // whether the coarse buffers are only allocated on blocks with a coarser neighbor, set
+  // by parthenon/mesh/lazy_coarse_buffers
+  bool LazyCoarseBuffers() const { return lazy_coarse_buffers_; }
+  // storage of the dense variables of the given stage on all local blocks, nullptr
+  // unless parthenon/mesh/mesh_variable_storage is true and the stage was created
+  std::shared_ptr<VariableArena<Real>>
+  GetMeshArena(const std::string &stage = "base") const {
+    auto it = mesh_arenas_.find(stage);
+    return it == mesh_arenas_.end() ? nullptr : it->second;
+  }
   int DefaultPackSize() {
     return default_pack_size_ < 1 ? block_list.size() : default_pack_size_;
   }
   int DefaultNumPartitions() {
     return partition::partition_impl::IntCeil(block_list.size(), DefaultPackSize());
   }
+  // Partitions of the leaf blocks (gmg_level < 0) or the blocks of a GMG level into
+  // packs of DefaultPackSize, cached until the next remesh
+  const std::vector<BlockList_t> &GetDefaultBlockPartitions(int gmg_level = -1) const {
+    return gmg_level < 0 ? block_partitions_ : gmg_block_partitions_[gmg_level];
+  }
   // step 7: create new MeshBlock list (same MPI rank but diff level: create new block)
   // Moved here given Cuda/nvcc restriction:
   // "error: The enclosing parent function ("...")
@@ -237,6 +280,18 @@ class Mesh {
  private:
   // data
   int root_level, max_level, current_level;
+  // number of blocks around blocks tagged for refinement that are refined with them
+  int refinement_buffer_;
+  // storage of the Variables of destroyed MeshBlocks, reused for new MeshBlocks
+  std::shared_ptr<VariableStoragePool<Real>> variable_storage_pool_;
+  // the pool is also trimmed every pool_trim_interval_ cycles without a remesh
+  int pool_trim_interval_ = 0;
+  int cycles_since_pool_trim_ = 0;
+  VariableArenaOptions variable_arena_options_;
+  bool copy_on_write_stages_ = false;
+  bool lazy_coarse_buffers_ = false;
+  // arenas of all local blocks by stage, created by the MeshBlockData of the first block
+  std::map<std::string, std::shared_ptr<VariableArena<Real>>> mesh_arenas_;
   int num_mesh_threads_;
   /// Maps Global Block IDs to which rank the block is mapped to.
   std::vector<int> ranklist;
@@ -246,15 +301,19 @@ class Mesh {
   std::vector<int> nblist;
   /// Maps global block ID to its cost
   std::vector<double> costlist;
-  // 8x arrays used exclusively for AMR (not SMR):
-  /// Count of blocks to refine on each rank
-  std::vector<int> nref;
-  /// Count of blocks to de-refine on each rank
-  std::vector<int> nderef;
-  std::vector<int> rdisp, ddisp;
-  std::vector<int> bnref, bnderef;
-  std::vector<int> brdisp, bddisp;
-  // the last 4x should be std::size_t, but are limited to int by MPI
+  // progress of the exchange of refinement flags and costs, see ExchangeRemeshFlags
+  enum class RemeshExchange { idle, counts, locations };
+  RemeshExchange remesh_exchange_ = RemeshExchange::idle;
+  // cost and number of blocks flagged for refinement and derefinement of every rank
+  std::vector<double> remesh_counts_;
+  // locations of the flagged blocks of every rank and their sizes and displacements in
+  // bytes
+  std::vector<LogicalLocation> remesh_locs_;
+  std::vector<int> remesh_loc_bytes_, remesh_loc_disp_;
+#ifdef MPI_PARALLEL
+  MPI_Request remesh_counts_request_ = MPI_REQUEST_NULL;
+  MPI_Request remesh_locs_request_ = MPI_REQUEST_NULL;
+#endif
 
   std::vector<LogicalLocation> loclist;
   MeshBlockTree tree;
@@ -266,33 +325,55 @@ class Mesh {
   bool use_uniform_meshgen_fn_[4];
 
   // variables for load balancing control
-  bool lb_flag_, lb_automatic_, lb_manual_;
+  bool lb_flag_, lb_automatic_, lb_manual_, lb_model_;
+  // only keep the costs of the blocks of this rank and assign the blocks to ranks with a
+  // prefix sum over the ranks, see CalculateDistributedLoadBalance
+  bool lb_distributed_ = false;
+  // cost model: cost = cell_weight * ncells + sum over swarms of weight * nparticles,
+  // with the weights keyed by the resolved swarm labels (package::swarm if private)
+  double lb_cell_weight_;
+  std::unordered_map<std::string, double> lb_swarm_weights_;
   double lb_tolerance_;
   int lb_interval_;
 
   // size of default MeshBlockPacks
   int default_pack_size_;
+  // partitions of block_list and gmg_block_lists, see GetDefaultBlockPartitions
+  std::vector<BlockList_t> block_partitions_;
+  std::vector<std::vector<BlockList_t>> gmg_block_partitions_;
 
   int gmg_min_logical_level_ = 0;
+  // pack size the GMG hierarchy was built with
+  int gmg_pack_size_ = -1;
 
 #ifdef MPI_PARALLEL
   // Global map of MPI comms for separate variables
   std::unordered_map<std::string, MPI_Comm> mpi_comm_map_;
+  // Key in mpi_comm_map_ of the comm used for aggregated block transfers during remeshing
+  static inline const std::string amr_comm_label_ = "parthenon::amr_block_transfer";
 #endif
 
   // functions
   void CalculateLoadBalance(std::vector<double> const &costlist,
                             std::vector<int> &ranklist, std::vector<int> &nslist,
                             std::vector<int> &nblist);
+  void CalculateDistributedLoadBalance(std::vector<double> const &newcost, int nfirst,
+                                       int nlast, bool decide_first,
+                                       std::vector<int> &ranklist,
+                                       std::vector<int> &nslist,
+                                       std::vector<int> &nblist);
   void ResetLoadBalanceVariables();
 
   // Mesh::LoadBalancingAndAdaptiveMeshRefinement() helper functions:
   void UpdateCostList();
   void UpdateMeshBlockTree(int &nnew, int &ndel);
-  bool GatherCostListAndCheckBalance();
+  bool ExchangeRemeshFlags(bool wait);
+  void GatherCostList();
+  bool CheckLoadBalance();
   void RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput *app_in,
                                        int ntot);
   void BuildGMGHierarchy(int nbs, ParameterInput *pin, ApplicationInput *app_in);
+  void BuildBlockPartitions();
   void
   SetSameLevelNeighbors(BlockList_t &block_list, const LogicalLocMap_t &loc_map,
                         RootGridInfo root_grid, int nbs, bool gmg_neighbors,
@@ -307,6 +388,8 @@ class Mesh {
 
   // Re-used functionality in constructor
   void RegisterLoadBalancing_(ParameterInput *pin);
+  void RegisterVariableStorage_(ParameterInput *pin);
+  void RegisterRemeshStats_(ParameterInput *pin);
 
   void SetupMPIComms();
   void PopulateLeafLocationMap();
@@ -335,6 +335,38 @@ void MeshBlock::AllocateSparse(std::string const &label, bool only_control,
   }
 }
 
+bool MeshBlock::NeedsCoarseBuffers() const {
+  for (const auto &nb : neighbors) {
+    if (nb.snb.level < loc.level()) return true;
+  }
+  return false;
+}
+
+void MeshBlock::SetCoarseBuffers(bool allocate) {
+  if (allocate == has_coarse_buffers_) return;
+  has_coarse_buffers_ = allocate;
+  auto &mbd = meshblock_data;
+  for (auto &base_var : mbd.Get()->GetVariableVector()) {
+    if (!base_var->IsAllocated() || !base_var->HasCoarseBuffer_()) continue;
+    // the stages share the coarse buffer of the base stage
+    if (allocate) base_var->AllocateCoarse_(this);
+    for (auto stage : mbd.Stages()) {
+      if (stage.first == "base" || !stage.second->HasVariable(base_var->label())) {
+        continue;
+      }
+      auto v = stage.second->GetVarPtr(base_var->label());
+      if (v == base_var) continue;
+      if (allocate) {
+        v->coarse_s = base_var->coarse_s;
+      } else {
+        v->coarse_s.Reset();
+      }
+    }
+    if (!allocate) base_var->DeallocateCoarse_(this);
+  }
+  IncrementAllocationEpoch();
+}
+
 void MeshBlock::DeallocateSparse(std::string const &label) {
   auto &mbd = meshblock_data;
   auto DeallocateVar = [&mbd](const std::string &l) {
@@ -17,11 +17,13 @@
 #ifndef MESH_MESHBLOCK_HPP_
 #define MESH_MESHBLOCK_HPP_
 
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -40,6 +42,7 @@
 #include "outputs/io_wrapper.hpp"
 #include "parameter_input.hpp"
 #include "parthenon_arrays.hpp"
+#include "utils/array_to_tuple.hpp"
 
 namespace parthenon {
 
@@ -181,6 +184,32 @@ class MeshBlock : public std::enable_shared_from_this<MeshBlock> {
 
   std::uint64_t ReportMemUsage() { return mem_usage_; }
 
+  // Incremented whenever a variable of any stage of the block is (de)allocated, so that
+  // caches depending on the allocation status can cheaply check for changes
+  void IncrementAllocationEpoch() { allocation_epoch_++; }
+  std::uint64_t GetAllocationEpoch() const { return allocation_epoch_; }
+
+  // Whether the variables have coarse buffers, which is always the case unless
+  // Mesh::LazyCoarseBuffers. Only blocks with a coarser neighbor need them, to restrict
+  // the data sent to and prolongate the data received from that neighbor.
+  bool HasCoarseBuffers() const { return has_coarse_buffers_; }
+  bool NeedsCoarseBuffers() const;
+  // Allocate or release the coarse buffers of the allocated variables of all stages
+  void SetCoarseBuffers(bool allocate);
+
+  // Flux storage shared by all variables with Metadata::ScratchFluxes whose fluxes have
+  // the dimensions dims, in all stages. Created on first use and counted once.
+  device_view_t<Real>
+  GetScratchFluxStorage(const std::array<int, MAX_VARIABLE_DIMENSION> &dims) {
+    auto it = scratch_fluxes_.find(dims);
+    if (it != scratch_fluxes_.end()) return it->second;
+    auto storage = std::make_from_tuple<device_view_t<Real>>(std::tuple_cat(
+        std::make_tuple(std::string("scratch_fluxes")), ArrayToReverseTuple(dims)));
+    LogMemUsage(storage.size() * sizeof(Real));
+    scratch_fluxes_.emplace(dims, storage);
+    return storage;
+  }
+
   //----------------------------------------------------------------------------------------
   //! \fn void MeshBlock::DeepCopy(const DstType& dst, const SrcType& src)
   //  \brief Deep copy between views using the exec space of the MeshBlock
@@ -461,6 +490,12 @@ class MeshBlock : public std::enable_shared_from_this<MeshBlock> {
 
   // memory usage on a block
   std::uint64_t mem_usage_;
+  // see GetAllocationEpoch
+  std::uint64_t allocation_epoch_ = 0;
+  // see HasCoarseBuffers
+  bool has_coarse_buffers_ = true;
+  // see GetScratchFluxStorage
+  std::map<std::array<int, MAX_VARIABLE_DIMENSION>, device_view_t<Real>> scratch_fluxes_;
 };
 
 using BlockList_t = std::vector<std::shared_ptr<MeshBlock>>;
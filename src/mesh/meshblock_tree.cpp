@@ -21,11 +21,19 @@
 // logical root (single block) level is 0.  Note the logical level of the physical root
 // grid (user-specified root grid) will be greater than zero if it contains more than
 // one MeshBlock
+// The tree is stored as a linear octree, i.e. only the leaves are stored in an array
+// sorted by Z-ordering. Since leaves never overlap, the only leaf that can contain a
+// given location is the last leaf that is not ordered after it, so all lookups are
+// binary searches.
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "defs.hpp"
 #include "globals.hpp"
@@ -35,429 +43,374 @@
 
 namespace parthenon {
 
-// Define static member variables
-Mesh *pmesh_;
-MeshBlockTree *MeshBlockTree::proot_;
-int MeshBlockTree::nleaf_;
-
-//----------------------------------------------------------------------------------------
-//! \fn MeshBlockTree::MeshBlockTree()
-//  \brief constructor for the logical root
-
-MeshBlockTree::MeshBlockTree(Mesh *pmesh) : pleaf_(nullptr), gid_(-1) {
-  pmesh_ = pmesh;
-  proot_ = this;
-  loc_ = LogicalLocation(0, 0, 0, 0);
+namespace {
+void BrokenTreeError() {
+  std::stringstream msg;
+  msg << "### FATAL ERROR in FindNeighbor" << std::endl
+      << "Neighbor search failed. The Block Tree is broken." << std::endl;
+  PARTHENON_FAIL(msg);
 }
+} // namespace
 
 //----------------------------------------------------------------------------------------
-//! \fn MeshBlockTree::MeshBlockTree(int gid, int ox1, int ox2, int ox3)
-//  \brief constructor for a leaf
+//! \fn MeshBlockTree::MeshBlockTree(Mesh *pmesh)
+//  \brief constructor for the tree of a Mesh, the root grid information is taken from
+//  the Mesh in CreateRootGrid
 
-MeshBlockTree::MeshBlockTree(MeshBlockTree *parent, int ox1, int ox2, int ox3)
-    : pleaf_(nullptr), gid_(parent->gid_) {
-  loc_ = parent->loc_.GetDaughter(ox1, ox2, ox3);
-}
+MeshBlockTree::MeshBlockTree(Mesh *pmesh) : pmesh_(pmesh), ndim_(1), nleaf_(2) {}
 
 //----------------------------------------------------------------------------------------
-//! \fn MeshBlockTree::~MeshBlockTree()
-//  \brief destructor (for both root and leaves)
-
-MeshBlockTree::~MeshBlockTree() {
-  if (pleaf_ != nullptr) {
-    for (int i = 0; i < nleaf_; i++)
-      delete pleaf_[i];
-    delete[] pleaf_;
-  }
-}
+//! \fn MeshBlockTree::MeshBlockTree(const RootGridInfo &rg_info, int ndim)
+//  \brief constructor for a tree that is not attached to a Mesh
+
+MeshBlockTree::MeshBlockTree(const RootGridInfo &rg_info, int ndim)
+    : pmesh_(nullptr), rg_info_(rg_info), ndim_(ndim), nleaf_(1 << ndim) {}
 
 //----------------------------------------------------------------------------------------
 //! \fn void MeshBlockTree::CreateRootGrid()
 //  \brief create the root grid; the root grid can be incomplete (less than 8 leaves)
 
 void MeshBlockTree::CreateRootGrid() {
-  if (loc_.level() == 0) {
-    nleaf_ = 2;
-    if (pmesh_->ndim >= 2) nleaf_ = 4;
-    if (pmesh_->ndim >= 3) nleaf_ = 8;
+  if (pmesh_ != nullptr) {
+    rg_info_ = pmesh_->GetRootGridInfo();
+    ndim_ = pmesh_->ndim;
   }
-  if (loc_.level() == pmesh_->root_level) return;
-
-  pleaf_ = new MeshBlockTree *[nleaf_];
-  for (int n = 0; n < nleaf_; n++)
-    pleaf_[n] = nullptr;
-
-  std::int64_t levfac = 1LL << (pmesh_->root_level - loc_.level() - 1);
-  for (int n = 0; n < nleaf_; n++) {
-    int i = n & 1, j = (n >> 1) & 1, k = (n >> 2) & 1;
-    if ((loc_.lx3() * 2 + k) * levfac < pmesh_->nrbx[X3DIR - 1] &&
-        (loc_.lx2() * 2 + j) * levfac < pmesh_->nrbx[X2DIR - 1] &&
-        (loc_.lx1() * 2 + i) * levfac < pmesh_->nrbx[X1DIR - 1]) {
-      pleaf_[n] = new MeshBlockTree(this, i, j, k);
-      pleaf_[n]->CreateRootGrid();
+  nleaf_ = 1 << ndim_;
+
+  locs_.clear();
+  for (std::int64_t k = 0; k < rg_info_.n[2]; k++) {
+    for (std::int64_t j = 0; j < rg_info_.n[1]; j++) {
+      for (std::int64_t i = 0; i < rg_info_.n[0]; i++) {
+        locs_.emplace_back(rg_info_.level, i, j, k);
+      }
     }
   }
-  return;
+  std::sort(locs_.begin(), locs_.end());
+  gids_.assign(locs_.size(), -1);
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void MeshBlockTree::AddMeshBlock(LogicalLocation rloc, int &nnew)
+//! \fn void MeshBlockTree::AddMeshBlock(const LogicalLocation &rloc, int &nnew)
 //  \brief add a MeshBlock to the tree, also creates neighboring blocks
 
-void MeshBlockTree::AddMeshBlock(LogicalLocation rloc, int &nnew) {
-  if (loc_.level() == rloc.level()) return; // done
-
-  if (pleaf_ == nullptr) // leaf -> create the finer level
-    Refine(nnew);
-
-  // get leaf indexes
-  int sh = rloc.level() - loc_.level() - 1;
-  int mx, my, mz;
-  mx = ((rloc.lx1() >> sh) & 1LL) == 1LL;
-  my = ((rloc.lx2() >> sh) & 1LL) == 1LL;
-  mz = ((rloc.lx3() >> sh) & 1LL) == 1LL;
-  int n = mx + (my << 1) + (mz << 2);
-  pleaf_[n]->AddMeshBlock(rloc, nnew);
+void MeshBlockTree::AddMeshBlock(const LogicalLocation &rloc, int &nnew) {
+  AddMeshBlock(std::vector<LogicalLocation>{rloc}, nnew);
+}
 
-  return;
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBlockTree::AddMeshBlock(std::vector<LogicalLocation> rlocs, int &nnew)
+//  \brief add a list of MeshBlocks to the tree, also creates neighboring blocks
+
+void MeshBlockTree::AddMeshBlock(std::vector<LogicalLocation> rlocs, int &nnew) {
+  // Every pass refines the leaves containing the requested locations by one level
+  while (!rlocs.empty()) {
+    std::vector<LogicalLocation> lref, remaining;
+    for (const auto &rloc : rlocs) {
+      const int n = FindLeaf_(rloc);
+      if (n < 0 || locs_[n].level() >= rloc.level()) continue; // done
+      lref.push_back(locs_[n]);
+      if (locs_[n].level() + 1 < rloc.level()) remaining.push_back(rloc);
+    }
+    Refine(lref, nnew);
+    rlocs = std::move(remaining);
+  }
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void MeshBlockTree::AddMeshBlockWithoutRefine(LogicalLocation rloc)
+//! \fn void MeshBlockTree::AddMeshBlockWithoutRefine(const LogicalLocation &rloc)
 //  \brief add a MeshBlock to the tree without refinement, used in restarting.
 //         MeshBlockTree::CreateRootGrid must be called before this method
-void MeshBlockTree::AddMeshBlockWithoutRefine(LogicalLocation rloc) {
-  if (loc_.level() == rloc.level()) // done
-    return;
-
-  if (pleaf_ == nullptr) {
-    pleaf_ = new MeshBlockTree *[nleaf_];
-    for (int n = 0; n < nleaf_; n++)
-      pleaf_[n] = nullptr;
-  }
 
-  // get leaf indexes
-  int sh = rloc.level() - loc_.level() - 1;
-  int mx, my, mz;
-  mx = ((rloc.lx1() >> sh) & 1LL) == 1LL;
-  my = ((rloc.lx2() >> sh) & 1LL) == 1LL;
-  mz = ((rloc.lx3() >> sh) & 1LL) == 1LL;
-  int n = mx + (my << 1) + (mz << 2);
-  if (pleaf_[n] == nullptr) pleaf_[n] = new MeshBlockTree(this, mx, my, mz);
-  pleaf_[n]->AddMeshBlockWithoutRefine(rloc);
-
-  return;
+void MeshBlockTree::AddMeshBlockWithoutRefine(const LogicalLocation &rloc) {
+  AddMeshBlockWithoutRefine(std::vector<LogicalLocation>{rloc});
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void MeshBlockTree::Refine(int &nnew)
-//  \brief make finer leaves
-
-void MeshBlockTree::Refine(int &nnew) {
-  if (pleaf_ != nullptr) return;
-
-  pleaf_ = new MeshBlockTree *[nleaf_];
-  for (int n = 0; n < nleaf_; n++)
-    pleaf_[n] = nullptr;
+//! \fn void MeshBlockTree::AddMeshBlockWithoutRefine(
+//                              const std::vector<LogicalLocation> &rlocs)
+//  \brief add a list of MeshBlocks to the tree without refinement, used in restarting.
+//         Leaves that contain any of the new blocks are removed from the tree.
+
+void MeshBlockTree::AddMeshBlockWithoutRefine(const std::vector<LogicalLocation> &rlocs) {
+  std::vector<LogicalLocation> all_locs(std::move(locs_));
+  all_locs.insert(all_locs.end(), rlocs.begin(), rlocs.end());
+  std::sort(all_locs.begin(), all_locs.end());
+
+  locs_.clear();
+  locs_.reserve(all_locs.size());
+  for (int n = 0; n < all_locs.size(); n++) {
+    // a location directly followed by a location it contains is either a duplicate or
+    // not a leaf
+    if (n + 1 < all_locs.size() && all_locs[n].Contains(all_locs[n + 1])) continue;
+    locs_.push_back(all_locs[n]);
+  }
+  gids_.assign(locs_.size(), -1);
+}
 
-  for (int n = 0; n < nleaf_; n++) {
-    int i = n & 1, j = (n >> 1) & 1, k = (n >> 2) & 1;
-    pleaf_[n] = new MeshBlockTree(this, i, j, k);
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBlockTree::Refine(const std::vector<LogicalLocation> &locs, int &nnew)
+//  \brief make finer leaves for all leaves in locs, as well as for all leaves that have
+//  to be refined to keep the tree 2:1 balanced
+
+void MeshBlockTree::Refine(const std::vector<LogicalLocation> &locs, int &nnew) {
+  std::vector<char> refine(locs_.size(), 0);
+  std::vector<int> stack;
+  for (const auto &loc : locs) {
+    const int n = FindLeaf_(loc);
+    if (n >= 0 && locs_[n] == loc) stack.push_back(n);
   }
 
-  std::int64_t nxmax, nymax, nzmax;
-  std::int64_t ox, oy, oz, oxmin, oxmax, oymin, oymax, ozmin, ozmax;
-
-  oxmin = -1, oxmax = 1,
-  nxmax = (pmesh_->nrbx[X1DIR - 1] << (loc_.level() - pmesh_->root_level));
-  if (pmesh_->ndim >= 2)
-    oymin = -1, oymax = 1,
-    nymax = (pmesh_->nrbx[X2DIR - 1] << (loc_.level() - pmesh_->root_level));
-  else
-    oymin = 0, oymax = 0, nymax = 1;
-  if (pmesh_->ndim >= 3) // 3D
-    ozmin = -1, ozmax = 1,
-    nzmax = (pmesh_->nrbx[X3DIR - 1] << (loc_.level() - pmesh_->root_level));
-  else
-    ozmin = 0, ozmax = 0, nzmax = 1;
-
-  int level = loc_.level();
-  std::int64_t lx1, lx2, lx3;
-  for (oz = ozmin; oz <= ozmax; oz++) {
-    lx3 = loc_.lx3() + oz;
-    if (lx3 < 0) {
-      if (pmesh_->mesh_bcs[BoundaryFace::inner_x3] != BoundaryFlag::periodic)
-        continue;
-      else
-        lx3 = nzmax - 1;
-    }
-    if (lx3 >= nzmax) {
-      if (pmesh_->mesh_bcs[BoundaryFace::outer_x3] != BoundaryFlag::periodic)
-        continue;
-      else
-        lx3 = 0;
-    }
-    for (oy = oymin; oy <= oymax; oy++) {
-      lx2 = loc_.lx2() + oy;
-      if (lx2 < 0) {
-        if (pmesh_->mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::periodic) {
-          lx2 = nymax - 1;
-        } else {
-          continue;
-        }
-      }
-      if (lx2 >= nymax) {
-        if (pmesh_->mesh_bcs[BoundaryFace::outer_x2] == BoundaryFlag::periodic) {
-          lx2 = 0;
-        } else {
-          continue;
+  const int ox2max = (ndim_ >= 2) ? 1 : 0;
+  const int ox3max = (ndim_ >= 3) ? 1 : 0;
+  while (!stack.empty()) {
+    const int n = stack.back();
+    stack.pop_back();
+    if (refine[n]) continue;
+    refine[n] = 1;
+    // all neighbors of a refined block have to be at least at its current level
+    for (int ox3 = -ox3max; ox3 <= ox3max; ox3++) {
+      for (int ox2 = -ox2max; ox2 <= ox2max; ox2++) {
+        for (int ox1 = -1; ox1 <= 1; ox1++) {
+          if (ox1 == 0 && ox2 == 0 && ox3 == 0) continue;
+          LogicalLocation nloc;
+          if (!GetNeighborLocation_(locs_[n], ox1, ox2, ox3, nloc)) continue;
+          const int nn = FindLeaf_(nloc);
+          if (nn >= 0 && locs_[nn].level() < nloc.level()) stack.push_back(nn);
         }
       }
-      for (ox = oxmin; ox <= oxmax; ox++) {
-        if (ox == 0 && oy == 0 && oz == 0) continue;
-        lx1 = loc_.lx1() + ox;
-        if (lx1 < 0) {
-          if (pmesh_->mesh_bcs[BoundaryFace::inner_x1] != BoundaryFlag::periodic)
-            continue;
-          else
-            lx1 = nxmax - 1;
-        }
-        if (lx1 >= nxmax) {
-          if (pmesh_->mesh_bcs[BoundaryFace::outer_x1] != BoundaryFlag::periodic)
-            continue;
-          else
-            lx1 = 0;
-        }
-        proot_->AddMeshBlock(LogicalLocation(level, lx1, lx2, lx3), nnew);
+    }
+  }
+
+  // Replace the refined leaves by their daughters. The daughters of a block are
+  // contiguous in Z-ordering, so the leaves stay sorted.
+  std::vector<LogicalLocation> new_locs;
+  std::vector<int> new_gids;
+  new_locs.reserve(locs_.size());
+  new_gids.reserve(locs_.size());
+  for (int n = 0; n < locs_.size(); n++) {
+    if (refine[n]) {
+      for (int l = 0; l < nleaf_; l++) {
+        new_locs.push_back(locs_[n].GetDaughter(l & 1, (l >> 1) & 1, (l >> 2) & 1));
+        new_gids.push_back(gids_[n]); // new leaves inherit the GID of the parent
       }
+      nnew += nleaf_ - 1;
+    } else {
+      new_locs.push_back(locs_[n]);
+      new_gids.push_back(gids_[n]);
     }
   }
-  // this block is not a leaf anymore
-  gid_ = -1;
+  locs_ = std::move(new_locs);
+  gids_ = std::move(new_gids);
+}
 
-  nnew += nleaf_ - 1;
-  return;
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBlockTree::Derefine(std::vector<LogicalLocation> locs, int &ndel)
+//  \brief destroy the leaves of the blocks in locs and make them leaves, unless that
+//  would break the 2:1 balance of the tree
+
+void MeshBlockTree::Derefine(std::vector<LogicalLocation> locs, int &ndel) {
+  // Derefining finer blocks can allow derefinement of coarser blocks, so work through
+  // the list level by level starting at the finest level. Blocks on the same level do
+  // not influence each other.
+  std::sort(locs.begin(), locs.end(),
+            [](const LogicalLocation &left, const LogicalLocation &right) {
+              return left.level() > right.level();
+            });
+  auto first = locs.begin();
+  while (first != locs.end()) {
+    const int level = first->level();
+    auto last = std::find_if(first, locs.end(), [level](const LogicalLocation &loc) {
+      return loc.level() != level;
+    });
+
+    std::vector<char> merge(locs_.size(), 0);
+    bool any_merge = false;
+    for (auto it = first; it != last; ++it) {
+      if (!CanDerefine_(*it)) continue;
+      merge[FindLeaf_(it->GetDaughter(0, 0, 0))] = 1;
+      any_merge = true;
+    }
+    first = last;
+    if (!any_merge) continue;
+
+    std::vector<LogicalLocation> new_locs;
+    std::vector<int> new_gids;
+    new_locs.reserve(locs_.size());
+    new_gids.reserve(locs_.size());
+    for (int n = 0; n < locs_.size();) {
+      new_locs.push_back(merge[n] ? locs_[n].GetParent() : locs_[n]);
+      new_gids.push_back(gids_[n]); // now this is a leaf; inherit the first leaf's GID
+      if (merge[n]) {
+        ndel += nleaf_ - 1;
+        n += nleaf_;
+      } else {
+        n++;
+      }
+    }
+    locs_ = std::move(new_locs);
+    gids_ = std::move(new_gids);
+  }
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void MeshBlockTree::Derefine(int &ndel)
-//  \brief destroy leaves and make this block a leaf
+//! \fn bool MeshBlockTree::CanDerefine_(const LogicalLocation &loc) const
+//  \brief check that loc is an internal node whose daughters are all leaves and that no
+//  neighbor of loc has refined daughters adjacent to loc
 
-void MeshBlockTree::Derefine(int &ndel) {
+bool MeshBlockTree::CanDerefine_(const LogicalLocation &loc) const {
+  if (loc.level() < rg_info_.level || !HasDescendants_(loc)) return false;
   int s2 = 0, e2 = 0, s3 = 0, e3 = 0;
-  if (pmesh_->ndim >= 2) s2 = -1, e2 = 1;
-  if (pmesh_->ndim >= 3) s3 = -1, e3 = 1;
+  if (ndim_ >= 2) s2 = -1, e2 = 1;
+  if (ndim_ >= 3) s3 = -1, e3 = 1;
   for (int ox3 = s3; ox3 <= e3; ox3++) {
     for (int ox2 = s2; ox2 <= e2; ox2++) {
       for (int ox1 = -1; ox1 <= 1; ox1++) {
-        MeshBlockTree *bt = proot_->FindNeighbor(loc_, ox1, ox2, ox3, true);
-        if (bt != nullptr) {
-          if (bt->pleaf_ != nullptr) {
-            int lis, lie, ljs, lje, lks, lke;
-            if (ox1 == -1)
-              lis = lie = 1;
-            else if (ox1 == 1)
-              lis = lie = 0;
-            else
-              lis = 0, lie = 1;
-            if (pmesh_->ndim >= 2) {
-              if (ox2 == -1)
-                ljs = lje = 1;
-              else if (ox2 == 1)
-                ljs = lje = 0;
-              else
-                ljs = 0, lje = 1;
-            } else {
-              ljs = lje = 0;
-            }
-            if (pmesh_->ndim >= 3) {
-              if (ox3 == -1)
-                lks = lke = 1;
-              else if (ox3 == 1)
-                lks = lke = 0;
-              else
-                lks = 0, lke = 1;
-            } else {
-              lks = lke = 0;
-            }
-            for (int lk = lks; lk <= lke; lk++) {
-              for (int lj = ljs; lj <= lje; lj++) {
-                for (int li = lis; li <= lie; li++) {
-                  int n = li + (lj << 1) + (lk << 2);
-                  if (bt->pleaf_[n]->pleaf_ != nullptr) return;
-                }
-              }
+        Node bt = FindNeighbor(loc, ox1, ox2, ox3, true);
+        if (!bt || bt.IsLeaf()) continue;
+        // only the daughters of the neighbor that are adjacent to loc matter
+        const int lis = (ox1 == 1) ? 0 : (ox1 == -1);
+        const int lie = (ox1 == -1) ? 1 : (ox1 == 0);
+        const int ljs = (ndim_ >= 2 && ox2 == -1) ? 1 : 0;
+        const int lje = (ndim_ >= 2 && ox2 != 1) ? 1 : 0;
+        const int lks = (ndim_ >= 3 && ox3 == -1) ? 1 : 0;
+        const int lke = (ndim_ >= 3 && ox3 != 1) ? 1 : 0;
+        for (int lk = lks; lk <= lke; lk++) {
+          for (int lj = ljs; lj <= lje; lj++) {
+            for (int li = lis; li <= lie; li++) {
+              if (!IsLeaf_(bt.GetLocation().GetDaughter(li, lj, lk))) return false;
             }
           }
         }
       }
     }
   }
-
-  gid_ = pleaf_[0]->gid_; // now this is a leaf; inherit the first leaf's GID
-  for (int n = 0; n < nleaf_; n++)
-    delete pleaf_[n];
-  delete[] pleaf_;
-  pleaf_ = nullptr;
-  ndel += nleaf_ - 1;
-  return;
-}
-
-//----------------------------------------------------------------------------------------
-//! \fn void MeshBlockTree::CountMeshBlock(int& count)
-//  \brief creates the Location list sorted by Z-ordering
-
-void MeshBlockTree::CountMeshBlock(int &count) {
-  if (loc_.level() == 0) count = 0;
-
-  if (pleaf_ == nullptr) {
-    count++;
-  } else {
-    for (int n = 0; n < nleaf_; n++) {
-      if (pleaf_[n] != nullptr) pleaf_[n]->CountMeshBlock(count);
-    }
-  }
-  return;
+  return true;
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn void MeshBlockTree::GetMeshBlockList(LogicalLocation *list,
 //                                           int *pglist, int& count)
-//  \brief creates the Location list sorted by Z-ordering
+//  \brief creates the Location list sorted by Z-ordering, assigns the new GIDs and
+//  returns the previous GIDs of the leaves in pglist
 
 void MeshBlockTree::GetMeshBlockList(LogicalLocation *list, int *pglist, int &count) {
-  if (loc_.level() == 0) count = 0;
-
-  if (pleaf_ == nullptr) {
-    list[count] = loc_;
-    if (pglist != nullptr) pglist[count] = gid_;
-    gid_ = count;
-    count++;
-  } else {
-    for (int n = 0; n < nleaf_; n++) {
-      if (pleaf_[n] != nullptr) pleaf_[n]->GetMeshBlockList(list, pglist, count);
-    }
+  count = locs_.size();
+  for (int n = 0; n < count; n++) {
+    list[n] = locs_[n];
+    if (pglist != nullptr) pglist[n] = gids_[n];
+    gids_[n] = n;
   }
-  return;
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn MeshBlockTree* MeshBlockTree::FindNeighbor(LogicalLocation myloc,
-//                                    int ox1, int ox2, int ox3, bool amrflag)
-//  \brief find a neighboring block, called from the root of the tree
-//         If it is coarser or same level, return the pointer to that block.
-//         If it is a finer block, return the pointer to its parent.
+//! \fn MeshBlockTree::Node MeshBlockTree::FindNeighbor(const LogicalLocation &myloc,
+//                                    int ox1, int ox2, int ox3, bool amrflag) const
+//  \brief find a neighboring block
+//         If it is coarser or same level, return the handle of that block.
+//         If it is a finer block, return the handle of its parent.
 //         Note that this function must be called on a completed tree only
 
-MeshBlockTree *MeshBlockTree::FindNeighbor(LogicalLocation myloc, int ox1, int ox2,
-                                           int ox3, bool amrflag) {
-  std::stringstream msg;
-  std::int64_t lx, ly, lz;
-  int ll;
-  int ox, oy, oz;
-  MeshBlockTree *bt = proot_;
-  lx = myloc.lx1(), ly = myloc.lx2(), lz = myloc.lx3(), ll = myloc.level();
-
-  lx += ox1;
-  ly += ox2;
-  lz += ox3;
-  // periodic and polar boundaries
-  if (lx < 0) {
-    if (pmesh_->mesh_bcs[BoundaryFace::inner_x1] == BoundaryFlag::periodic)
-      lx = (pmesh_->nrbx[X1DIR - 1] << (ll - pmesh_->root_level)) - 1;
-    else
-      return nullptr;
-  }
-  if (lx >= pmesh_->nrbx[X1DIR - 1] << (ll - pmesh_->root_level)) {
-    if (pmesh_->mesh_bcs[BoundaryFace::outer_x1] == BoundaryFlag::periodic)
-      lx = 0;
-    else
-      return nullptr;
-  }
-  if (ly < 0) {
-    if (pmesh_->mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::periodic) {
-      ly = (pmesh_->nrbx[X2DIR - 1] << (ll - pmesh_->root_level)) - 1;
-    } else {
-      return nullptr;
-    }
-  }
-  if (ly >= pmesh_->nrbx[X2DIR - 1] << (ll - pmesh_->root_level)) {
-    if (pmesh_->mesh_bcs[BoundaryFace::outer_x2] == BoundaryFlag::periodic) {
-      ly = 0;
-    } else {
-      return nullptr;
-    }
-  }
-  std::int64_t num_x3 = pmesh_->nrbx[X3DIR - 1] << (ll - pmesh_->root_level);
-  if (lz < 0) {
-    if (pmesh_->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::periodic)
-      lz = num_x3 - 1;
-    else
-      return nullptr;
-  }
-  if (lz >= num_x3) {
-    if (pmesh_->mesh_bcs[BoundaryFace::outer_x3] == BoundaryFlag::periodic)
-      lz = 0;
-    else
-      return nullptr;
+MeshBlockTree::Node MeshBlockTree::FindNeighbor(const LogicalLocation &myloc, int ox1,
+                                                int ox2, int ox3, bool amrflag) const {
+  LogicalLocation nloc;
+  if (!GetNeighborLocation_(myloc, ox1, ox2, ox3, nloc)) return Node();
+
+  const int n = FindLeaf_(nloc);
+  if (n >= 0) { // leaf on the same or the next coarser level
+    if (locs_[n].level() < nloc.level() - 1) BrokenTreeError();
+    return Node(this, locs_[n], n);
   }
-  if (ll < 1) return proot_; // single grid; return root
+  if (!HasDescendants_(nloc)) BrokenTreeError();
+  // one level finer: check if it is a leaf
+  if (!amrflag && !IsLeaf_(nloc.GetDaughter(ox1 < 0, ox2 < 0, ox3 < 0)))
+    BrokenTreeError();
+  return Node(this, nloc, -1);
+}
 
-  for (int level = 0; level < ll; level++) {
-    if (bt->pleaf_ == nullptr) { // leaf
-      if (level == ll - 1) {
-        return bt;
-      } else {
-        msg << "### FATAL ERROR in FindNeighbor" << std::endl
-            << "Neighbor search failed. The Block Tree is broken." << std::endl;
-        PARTHENON_FAIL(msg);
-        return nullptr;
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBlockTree::GetRefinementBuffer(const std::vector<LogicalLocation> &locs,
+//                    int nbuf, std::vector<LogicalLocation> &region,
+//                    std::vector<LogicalLocation> &lref) const
+//  \brief find the same level locations within nbuf blocks of the blocks in locs,
+//  returned in region, and the leaves containing them, returned in lref. Refining lref
+//  along with locs surrounds the refined region by nbuf buffer blocks.
+
+void MeshBlockTree::GetRefinementBuffer(const std::vector<LogicalLocation> &locs,
+                                        int nbuf, std::vector<LogicalLocation> &region,
+                                        std::vector<LogicalLocation> &lref) const {
+  const int nbuf2 = (ndim_ >= 2) ? nbuf : 0;
+  const int nbuf3 = (ndim_ >= 3) ? nbuf : 0;
+  for (const auto &loc : locs) {
+    for (int ox3 = -nbuf3; ox3 <= nbuf3; ox3++) {
+      for (int ox2 = -nbuf2; ox2 <= nbuf2; ox2++) {
+        for (int ox1 = -nbuf; ox1 <= nbuf; ox1++) {
+          LogicalLocation nloc;
+          if (!GetNeighborLocation_(loc, ox1, ox2, ox3, nloc)) continue;
+          region.push_back(nloc);
+          const int n = FindLeaf_(nloc);
+          if (n >= 0) lref.push_back(locs_[n]);
+        }
       }
     }
-    // find a leaf in the next level
-    int sh = ll - level - 1;
-    ox = ((lx >> sh) & 1LL) == 1LL;
-    oy = ((ly >> sh) & 1LL) == 1LL;
-    oz = ((lz >> sh) & 1LL) == 1LL;
-    bt = bt->GetLeaf(ox, oy, oz);
-    if (bt == nullptr) {
-      msg << "### FATAL ERROR in FindNeighbor" << std::endl
-          << "Neighbor search failed. The Block Tree is broken." << std::endl;
-      PARTHENON_FAIL(msg);
-      return nullptr;
-    }
-  }
-  if (bt->pleaf_ == nullptr) // leaf on the same level
-    return bt;
-  // one level finer: check if it is a leaf
-  ox = oy = oz = 0;
-  if (ox1 < 0) ox = 1;
-  if (ox2 < 0) oy = 1;
-  if (ox3 < 0) oz = 1;
-  MeshBlockTree *btleaf = bt->GetLeaf(ox, oy, oz);
-  if (btleaf->pleaf_ == nullptr) return bt; // return this block
-  if (!amrflag) {
-    msg << "### FATAL ERROR in FindNeighbor" << std::endl
-        << "Neighbor search failed. The Block Tree is broken." << std::endl;
-    PARTHENON_FAIL(msg);
   }
-  return bt;
+  std::sort(region.begin(), region.end());
+  region.erase(std::unique(region.begin(), region.end()), region.end());
+  std::sort(lref.begin(), lref.end());
+  lref.erase(std::unique(lref.begin(), lref.end()), lref.end());
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn MeshBlockTree::Node MeshBlockTree::FindMeshBlock(const LogicalLocation &tloc)
+//  \brief find the (leaf or internal) node with LogicalLocation tloc, returns an empty
+//  handle if there is no such node
+
+MeshBlockTree::Node MeshBlockTree::FindMeshBlock(const LogicalLocation &tloc) const {
+  const int n = FindLeaf_(tloc);
+  if (n >= 0) return (locs_[n] == tloc) ? Node(this, tloc, n) : Node();
+  if (HasDescendants_(tloc)) return Node(this, tloc, -1);
+  return Node();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int MeshBlockTree::FindLeaf_(const LogicalLocation &loc) const
+//  \brief index of the leaf that contains (or is) loc, -1 if there is no such leaf
+
+int MeshBlockTree::FindLeaf_(const LogicalLocation &loc) const {
+  auto it = std::upper_bound(locs_.begin(), locs_.end(), loc);
+  if (it == locs_.begin()) return -1;
+  --it;
+  return loc.IsContainedIn(*it) ? std::distance(locs_.begin(), it) : -1;
+}
+
+bool MeshBlockTree::IsLeaf_(const LogicalLocation &loc) const {
+  const int n = FindLeaf_(loc);
+  return n >= 0 && locs_[n] == loc;
+}
+
+bool MeshBlockTree::HasDescendants_(const LogicalLocation &loc) const {
+  auto it = std::lower_bound(locs_.begin(), locs_.end(), loc);
+  return it != locs_.end() && it->level() > loc.level() && loc.Contains(*it);
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn MeshBlockTree* MeshBlockTree::FindMeshBlock(LogicalLocation tloc)
-//  \brief find MeshBlock with LogicalLocation tloc and return a pointer
-
-MeshBlockTree *MeshBlockTree::FindMeshBlock(LogicalLocation tloc) {
-  if (tloc.level() == loc_.level()) return this;
-  // get leaf indexes
-  int sh = tloc.level() - loc_.level() - 1;
-  int mx = (((tloc.lx1() >> sh) & 1LL) == 1LL);
-  int my = (((tloc.lx2() >> sh) & 1LL) == 1LL);
-  int mz = (((tloc.lx3() >> sh) & 1LL) == 1LL);
-  int n = mx + (my << 1) + (mz << 2);
-  if (pleaf_[n] == nullptr) return nullptr;
-  return pleaf_[n]->FindMeshBlock(tloc);
+//! \fn bool MeshBlockTree::GetNeighborLocation_(const LogicalLocation &loc, int ox1,
+//                                     int ox2, int ox3, LogicalLocation &nloc) const
+//  \brief location of the same level block at offset (ox1, ox2, ox3), taking periodic
+//  boundaries into account. Returns false if there is no such block.
+
+bool MeshBlockTree::GetNeighborLocation_(const LogicalLocation &loc, int ox1, int ox2,
+                                         int ox3, LogicalLocation &nloc) const {
+  std::int64_t lx[3] = {loc.lx1() + ox1, loc.lx2() + ox2, loc.lx3() + ox3};
+  for (int dir = 0; dir < 3; dir++) {
+    const std::int64_t nmax = static_cast<std::int64_t>(rg_info_.n[dir])
+                              << (loc.level() - rg_info_.level);
+    if (lx[dir] < 0 || lx[dir] >= nmax) {
+      if (!rg_info_.periodic[dir]) return false;
+      lx[dir] = ((lx[dir] % nmax) + nmax) % nmax;
+    }
+  }
+  nloc = LogicalLocation(loc.level(), lx[0], lx[1], lx[2]);
+  return true;
 }
 
 } // namespace parthenon
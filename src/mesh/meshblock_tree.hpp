@@ -17,11 +17,14 @@
 #ifndef MESH_MESHBLOCK_TREE_HPP_
 #define MESH_MESHBLOCK_TREE_HPP_
 //! \file meshblock_tree.hpp
-//  \brief defines the LogicalLocation structure and MeshBlockTree class
+//  \brief defines the MeshBlockTree class, a linear octree of MeshBlock locations
 //======================================================================================
 
+#include <vector>
+
 #include "bvals/bvals.hpp"
 #include "defs.hpp"
+#include "mesh/logical_location.hpp"
 
 namespace parthenon {
 
@@ -29,47 +32,80 @@ class Mesh;
 
 //--------------------------------------------------------------------------------------
 //! \class MeshBlockTree
-//  \brief Objects are nodes in an AMR MeshBlock tree structure
+//  \brief Linear octree storing the leaves of the AMR MeshBlock tree
+//  The leaves are kept in a flat array sorted by LogicalLocation (i.e. by Morton number
+//  and then level), which is the Z-ordering used for the global block list. Internal
+//  nodes are not stored, they are implied by the leaves they contain. Lookups are binary
+//  searches and refinement/derefinement is applied in batches with a single merge of
+//  the leaf array.
 
 class MeshBlockTree {
-  friend class Mesh;
-  friend class MeshBlock;
-  friend class BoundaryBase;
-
  public:
-  explicit MeshBlockTree(Mesh *pmesh);
-  MeshBlockTree(MeshBlockTree *parent, int ox1, int ox2, int ox3);
-  ~MeshBlockTree();
+  //--------------------------------------------------------------------------------------
+  //! \class MeshBlockTree::Node
+  //  \brief Lightweight handle to a (leaf or internal) node of the tree. A default
+  //  constructed Node does not refer to any node and converts to false.
+  class Node {
+   public:
+    Node() = default;
+
+    explicit operator bool() const { return ptree_ != nullptr; }
+    bool IsLeaf() const { return leaf_ >= 0; }
+    const LogicalLocation &GetLocation() const { return loc_; }
+    int GetGid() const { return IsLeaf() ? ptree_->gids_[leaf_] : -1; }
+
+    // returns the daughter ox1 + 2 * ox2 + 4 * ox3 of an internal node
+    Node GetLeaf(int ox1, int ox2, int ox3) const {
+      return ptree_->FindMeshBlock(loc_.GetDaughter(ox1, ox2, ox3));
+    }
 
-  // accessor
-  MeshBlockTree *GetLeaf(int ox1, int ox2, int ox3) {
-    return pleaf_[(ox1 + (ox2 << 1) + (ox3 << 2))];
-  }
+   private:
+    friend class MeshBlockTree;
+    Node(const MeshBlockTree *ptree, const LogicalLocation &loc, int leaf)
+        : ptree_(ptree), loc_(loc), leaf_(leaf) {}
+
+    const MeshBlockTree *ptree_ = nullptr;
+    LogicalLocation loc_;
+    int leaf_ = -1; // index into the leaf arrays, -1 for internal nodes
+  };
+
+  explicit MeshBlockTree(Mesh *pmesh);
+  MeshBlockTree(const RootGridInfo &rg_info, int ndim);
 
   // functions
   void CreateRootGrid();
-  void AddMeshBlock(LogicalLocation rloc, int &nnew);
-  void AddMeshBlockWithoutRefine(LogicalLocation rloc);
-  void Refine(int &nnew);
-  void Derefine(int &ndel);
-  MeshBlockTree *FindMeshBlock(LogicalLocation tloc);
-  void CountMeshBlock(int &count);
+  void AddMeshBlock(const LogicalLocation &rloc, int &nnew);
+  void AddMeshBlock(std::vector<LogicalLocation> rlocs, int &nnew);
+  void AddMeshBlockWithoutRefine(const LogicalLocation &rloc);
+  void AddMeshBlockWithoutRefine(const std::vector<LogicalLocation> &rlocs);
+  void Refine(const std::vector<LogicalLocation> &locs, int &nnew);
+  void Derefine(std::vector<LogicalLocation> locs, int &ndel);
+  Node FindMeshBlock(const LogicalLocation &tloc) const;
+  void CountMeshBlock(int &count) const { count = locs_.size(); }
   void GetMeshBlockList(LogicalLocation *list, int *pglist, int &count);
-  MeshBlockTree *FindNeighbor(LogicalLocation myloc, int ox1, int ox2, int ox3,
-                              bool amrflag = false);
-
-  LogicalLocation GetLocation() const { return loc_; }
-  bool IsLeaf() const { return pleaf_ == nullptr; }
-  int GetGid() const { return gid_; }
+  Node FindNeighbor(const LogicalLocation &myloc, int ox1, int ox2, int ox3,
+                    bool amrflag = false) const;
+  void GetRefinementBuffer(const std::vector<LogicalLocation> &locs, int nbuf,
+                           std::vector<LogicalLocation> &region,
+                           std::vector<LogicalLocation> &lref) const;
 
  private:
+  int FindLeaf_(const LogicalLocation &loc) const;
+  bool IsLeaf_(const LogicalLocation &loc) const;
+  bool HasDescendants_(const LogicalLocation &loc) const;
+  bool GetNeighborLocation_(const LogicalLocation &loc, int ox1, int ox2, int ox3,
+                            LogicalLocation &nloc) const;
+  bool CanDerefine_(const LogicalLocation &loc) const;
+
   // data
-  MeshBlockTree **pleaf_;
-  int gid_;
-  LogicalLocation loc_;
+  Mesh *pmesh_;
+  RootGridInfo rg_info_;
+  int ndim_;
+  int nleaf_;
 
-  static MeshBlockTree *proot_;
-  static int nleaf_;
+  // leaves sorted by LogicalLocation and their global ids
+  std::vector<LogicalLocation> locs_;
+  std::vector<int> gids_;
 };
 
 } // namespace parthenon
@@ -0,0 +1,117 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file remesh_stats.cpp
+//  \brief per remesh breakdown of the time spent in and the data moved by each phase
+
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "globals.hpp"
+#include "mesh/remesh_stats.hpp"
+#include "parthenon_mpi.hpp"
+#include "utils/error_checking.hpp"
+
+namespace parthenon {
+
+const char *RemeshStats::PhaseName(Phase phase) {
+  switch (phase) {
+  case Phase::tag:
+    return "tag";
+  case Phase::flag_gather:
+    return "flag_gather";
+  case Phase::tree_update:
+    return "tree_update";
+  case Phase::balance:
+    return "balance";
+  case Phase::restriction:
+    return "restriction";
+  case Phase::migration_send:
+    return "migration_send";
+  case Phase::migration_recv:
+    return "migration_recv";
+  case Phase::block_construction:
+    return "block_construction";
+  case Phase::prolongation:
+    return "prolongation";
+  case Phase::neighbor_search:
+    return "neighbor_search";
+  case Phase::buffer_cache:
+    return "buffer_cache";
+  case Phase::gmg:
+    return "gmg";
+  default:
+    PARTHENON_FAIL("Unknown remesh phase");
+  }
+}
+
+void RemeshStats::Write(int nremesh, int nbtotal, int nnew, int ndel) {
+  if (!enabled_) return;
+#ifdef MPI_PARALLEL
+  if (Globals::nranks > 1) {
+    void *time_send = (Globals::my_rank == 0) ? MPI_IN_PLACE : time_.data();
+    void *blocks_send = (Globals::my_rank == 0) ? MPI_IN_PLACE : blocks_.data();
+    void *bytes_send = (Globals::my_rank == 0) ? MPI_IN_PLACE : bytes_.data();
+    PARTHENON_MPI_CHECK(MPI_Reduce(time_send, time_.data(), nphases, MPI_DOUBLE, MPI_MAX,
+                                   0, MPI_COMM_WORLD));
+    PARTHENON_MPI_CHECK(MPI_Reduce(blocks_send, blocks_.data(), nphases, MPI_INT64_T,
+                                   MPI_SUM, 0, MPI_COMM_WORLD));
+    PARTHENON_MPI_CHECK(MPI_Reduce(bytes_send, bytes_.data(), nphases, MPI_INT64_T,
+                                   MPI_SUM, 0, MPI_COMM_WORLD));
+  }
+#endif
+
+  // only the master rank writes the file
+  if (Globals::my_rank == 0) {
+    FILE *pfile;
+    if ((pfile = std::fopen(fname_.c_str(), truncate_ ? "w" : "a")) == nullptr) {
+      std::stringstream msg;
+      msg << "### FATAL ERROR in function [RemeshStats::Write]" << std::endl
+          << "Output file '" << fname_ << "' could not be opened";
+      PARTHENON_FAIL(msg);
+    }
+
+    // a restarted run appends to the records of the previous one
+    std::fseek(pfile, 0, SEEK_END);
+    if (std::ftell(pfile) == 0) {
+      std::fprintf(pfile, "# remesh,nblocks,nnew,ndel,nchecks");
+      for (int p = 0; p < nphases; ++p) {
+        const char *name = PhaseName(static_cast<Phase>(p));
+        std::fprintf(pfile, ",%s_time,%s_blocks,%s_bytes", name, name, name);
+      }
+      std::fprintf(pfile, "\n");
+    }
+
+    std::fprintf(pfile, "%d,%d,%d,%d,%lld", nremesh, nbtotal, nnew, ndel,
+                 static_cast<long long>(nchecks_));
+    for (int p = 0; p < nphases; ++p) {
+      std::fprintf(pfile, ",%.6e,%lld,%lld", time_[p], static_cast<long long>(blocks_[p]),
+                   static_cast<long long>(bytes_[p]));
+    }
+    std::fprintf(pfile, "\n");
+    std::fclose(pfile);
+  }
+  truncate_ = false;
+
+  Reset();
+}
+
+void RemeshStats::Reset() {
+  nchecks_ = 0;
+  time_.fill(0.0);
+  blocks_.fill(0);
+  bytes_.fill(0);
+}
+
+} // namespace parthenon
@@ -0,0 +1,129 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef MESH_REMESH_STATS_HPP_
+#define MESH_REMESH_STATS_HPP_
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include <Kokkos_Core.hpp>
+
+namespace parthenon {
+
+// Breakdown of the time spent in, and the blocks and bytes handled by, the phases of
+// remeshing. The phases are accumulated over all checks for remeshing since the last
+// record, and a record is appended to a CSV file every time the mesh is modified.
+class RemeshStats {
+ public:
+  enum class Phase : int {
+    tag,                // evaluating the refinement criteria
+    flag_gather,        // exchanging refinement flags and costs between ranks
+    tree_update,        // refining and derefining the MeshBlockTree
+    balance,            // building the new block lists and assigning them to ranks
+    restriction,        // restricting blocks that are derefined
+    migration_send,     // packing and sending blocks to other ranks
+    migration_recv,     // receiving and unpacking blocks, copies within the rank
+    block_construction, // creating the new MeshBlocks
+    prolongation,       // prolongating newly refined blocks
+    neighbor_search,    // finding the neighbors of the new blocks
+    buffer_cache,       // rebuilding the boundary buffers in Mesh::Initialize
+    gmg,                // rebuilding the geometric multigrid hierarchy
+    count
+  };
+  static constexpr int nphases = static_cast<int>(Phase::count);
+
+  // Adds the time between its construction (or Restart) and Stop (or destruction) to a
+  // phase. The device is fenced first when the stats are enabled, so that asynchronous
+  // kernels are attributed to the phase that launched them.
+  class PhaseTimer {
+   public:
+    PhaseTimer(RemeshStats *stats, Phase phase) : stats_(stats), phase_(phase) {}
+    PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer &operator=(const PhaseTimer &) = delete;
+    ~PhaseTimer() { Stop(); }
+
+    void Stop() {
+      if (!running_) return;
+      if (stats_->IsEnabled()) {
+        Kokkos::fence();
+        stats_->AddTime(phase_, timer_.seconds());
+      }
+      running_ = false;
+    }
+
+    void Restart() {
+      Stop();
+      timer_.reset();
+      running_ = true;
+    }
+
+   private:
+    RemeshStats *stats_;
+    Phase phase_;
+    bool running_ = true;
+    Kokkos::Timer timer_;
+  };
+
+  // Enable writing a record per remesh to the file fname (on rank 0). The file is
+  // truncated by the first record unless appending, e.g. after a restart, in which case
+  // the header is only written if the file is empty.
+  void Enable(const std::string &fname, bool append) {
+    fname_ = fname;
+    truncate_ = !append;
+    enabled_ = true;
+  }
+  bool IsEnabled() const { return enabled_; }
+
+  // Nothing is accumulated while the stats are disabled
+  PhaseTimer Time(Phase phase) { return PhaseTimer(this, phase); }
+  void AddTime(Phase phase, double seconds) {
+    if (enabled_) time_[Index_(phase)] += seconds;
+  }
+  void AddVolume(Phase phase, std::int64_t blocks, std::int64_t bytes) {
+    if (!enabled_) return;
+    blocks_[Index_(phase)] += blocks;
+    bytes_[Index_(phase)] += bytes;
+  }
+  // count a check for remeshing, whether or not the mesh was modified
+  void AddCheck() {
+    if (enabled_) nchecks_++;
+  }
+
+  // accumulated since the last record
+  double Seconds(Phase phase) const { return time_[Index_(phase)]; }
+  std::int64_t Blocks(Phase phase) const { return blocks_[Index_(phase)]; }
+  std::int64_t Bytes(Phase phase) const { return bytes_[Index_(phase)]; }
+  std::int64_t NumChecks() const { return nchecks_; }
+
+  // Reduce the phases over all ranks (maximum time, total blocks and bytes), append a
+  // record to the file on rank 0 and reset the phases. Has to be called on all ranks.
+  void Write(int nremesh, int nbtotal, int nnew, int ndel);
+  void Reset();
+
+  static const char *PhaseName(Phase phase);
+
+ private:
+  static int Index_(Phase phase) { return static_cast<int>(phase); }
+
+  bool enabled_ = false;
+  bool truncate_ = false;
+  std::string fname_;
+  std::int64_t nchecks_ = 0;
+  std::array<double, nphases> time_{};
+  std::array<std::int64_t, nphases> blocks_{}, bytes_{};
+};
+
+} // namespace parthenon
+
+#endif // MESH_REMESH_STATS_HPP_
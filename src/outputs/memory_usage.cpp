@@ -0,0 +1,85 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file memory_usage.cpp
+//  \brief writes the memory usage by package, variable, component and stage
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs/outputs.hpp"
+#include "utils/error_checking.hpp"
+
+namespace parthenon {
+
+//----------------------------------------------------------------------------------------
+//! \fn void MemoryUsageOutput::WriteOutputFile()
+//  \brief Appends a record per entry of the memory usage to <problem_id>.mem.csv
+
+void MemoryUsageOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
+                                        const SignalHandler::OutputSignal signal) {
+  // Like the history, the file is only appended to at the regular output times
+  if (signal == SignalHandler::OutputSignal::now) {
+    return;
+  }
+  pm->memory_usage.Sample(pm);
+  const auto reduced = pm->memory_usage.Reduce();
+
+  // only the master rank writes the file
+  if (Globals::my_rank == 0) {
+    std::string fname;
+    fname.assign(output_params.file_basename);
+    fname.append(".mem.csv");
+
+    FILE *pfile;
+    if ((pfile = std::fopen(fname.c_str(), "a")) == nullptr) {
+      std::stringstream msg;
+      msg << "### FATAL ERROR in function [MemoryUsageOutput::WriteOutputFile]"
+          << std::endl
+          << "Output file '" << fname << "' could not be opened";
+      PARTHENON_FAIL(msg);
+    }
+
+    if (output_params.file_number == 0) {
+      std::fprintf(pfile, "# cycle,time,package,variable,component,stage,current_min,"
+                          "current_max,current_mean,high_water_min,high_water_max,"
+                          "high_water_mean\n");
+    }
+
+    const int ncycle = tm != nullptr ? tm->ncycle : 0;
+    const Real time = tm != nullptr ? tm->time : 0.0;
+    for (const auto &r : reduced) {
+      const auto &[package, variable, component, stage] = r.key;
+      std::fprintf(pfile, "%d,%.6e,%s,%s,%s,%s,%lld,%lld,%.6e,%lld,%lld,%.6e\n", ncycle,
+                   time, package.c_str(), variable.c_str(),
+                   MemoryUsage::ComponentName(component), stage.c_str(),
+                   static_cast<long long>(r.current_min),
+                   static_cast<long long>(r.current_max), r.current_mean,
+                   static_cast<long long>(r.high_water_min),
+                   static_cast<long long>(r.high_water_max), r.high_water_mean);
+    }
+    std::fclose(pfile);
+  }
+
+  // advance output parameters
+  output_params.file_number++;
+  output_params.next_time += output_params.dt;
+  output_params.next_ncycle += output_params.dn;
+  pin->SetInteger(output_params.block_name, "file_number", output_params.file_number);
+  pin->SetReal(output_params.block_name, "next_time", output_params.next_time);
+}
+
+} // namespace parthenon
@@ -205,7 +205,8 @@ Outputs::Outputs(Mesh *pm, ParameterInput *pin, SimTime *tm) {
 
       // set output variable and optional data format string used in formatted writes
       if ((op.file_type != "hst") && (op.file_type != "rst") &&
-          (op.file_type != "ascent") && (op.file_type != "histogram")) {
+          (op.file_type != "ascent") && (op.file_type != "histogram") &&
+          (op.file_type != "mem")) {
         op.variables = pin->GetOrAddVector<std::string>(pib->block_name, "variables",
                                                         std::vector<std::string>());
         // JMM: If the requested var isn't present for a given swarm,
@@ -249,6 +250,9 @@ Outputs::Outputs(Mesh *pm, ParameterInput *pin, SimTime *tm) {
       if (op.file_type == "hst") {
         pnew_type = new HistoryOutput(op);
         num_hst_outputs++;
+      } else if (op.file_type == "mem") {
+        pnew_type = new MemoryUsageOutput(op);
+        pm->memory_usage.Enable();
       } else if (op.file_type == "vtk") {
         pnew_type = new VTKOutput(op);
       } else if (op.file_type == "ascent") {
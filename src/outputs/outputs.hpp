@@ -163,6 +163,18 @@ class HistoryOutput : public OutputType {
                        const SignalHandler::OutputSignal signal) override;
 };
 
+//----------------------------------------------------------------------------------------
+//! \class MemoryUsageOutput
+//  \brief derived OutputType class for the memory usage by package, variable, component
+//  and stage, reduced over all ranks
+
+class MemoryUsageOutput : public OutputType {
+ public:
+  explicit MemoryUsageOutput(const OutputParameters &oparams) : OutputType(oparams) {}
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
+                       const SignalHandler::OutputSignal signal) override;
+};
+
 //----------------------------------------------------------------------------------------
 //! \class VTKOutput
 //  \brief derived OutputType class for vtk dumps
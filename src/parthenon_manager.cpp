@@ -129,6 +129,14 @@ ParthenonStatus ParthenonManager::ParthenonInitEnv(int argc, char *argv[]) {
                            Globals::sparse_config.deallocation_threshold);
   Globals::sparse_config.deallocation_count = pinput->GetOrAddInteger(
       "parthenon/sparse", "dealloc_count", Globals::sparse_config.deallocation_count);
+  Globals::sparse_config.deallocation_interval =
+      pinput->GetOrAddInteger("parthenon/sparse", "dealloc_interval",
+                              Globals::sparse_config.deallocation_interval);
+  PARTHENON_REQUIRE_THROWS(Globals::sparse_config.deallocation_interval > 0,
+                           "parthenon/sparse/dealloc_interval must be positive");
+  Globals::sparse_config.deallocation_interior_only =
+      pinput->GetOrAddBoolean("parthenon/sparse", "dealloc_interior_only",
+                              Globals::sparse_config.deallocation_interior_only);
 
   // set timeout config
   Globals::receive_boundary_buffer_timeout =
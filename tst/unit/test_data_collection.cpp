@@ -18,6 +18,7 @@
 
 #include "basic_types.hpp"
 #include "interface/data_collection.hpp"
+#include "interface/mesh_data.hpp"
 #include "interface/meshblock_data.hpp"
 #include "interface/metadata.hpp"
 #include "kokkos_abstraction.hpp"
@@ -118,3 +119,21 @@ TEST_CASE("Adding MeshBlockData objects to a DataCollection", "[DataCollection]"
     }
   }
 }
+
+TEST_CASE("Stage ids of a DataCollection", "[DataCollection]") {
+  GIVEN("A DataCollection of MeshData") {
+    DataCollection<MeshData<Real>> d;
+    const int base = d.GetStageId("base");
+    const int dudt = d.GetStageId("dUdt");
+    THEN("every label has its own id, which does not change") {
+      REQUIRE(base != dudt);
+      REQUIRE(d.GetStageId("base") == base);
+      REQUIRE(d.GetStageId(std::string("dUdt")) == dudt);
+    }
+    THEN("the ids survive purging the stages") {
+      d.PurgeNonBase();
+      REQUIRE(d.GetStageId("dUdt") == dudt);
+      REQUIRE(d.Partitions().empty());
+    }
+  }
+}
@@ -0,0 +1,102 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "mesh/load_balance.hpp"
+
+using parthenon::load_balance::CompleteRankStarts;
+using parthenon::load_balance::RankStarts;
+
+namespace {
+// Run the distributed assignment of the blocks with the given costs as if the blocks
+// [first[r], first[r + 1]) were held by rank r, without the first block of a rank if it
+// is not decided there, and reduce the starts of all ranks
+std::vector<int> AssignDistributed(const std::vector<double> &costs,
+                                   const std::vector<int> &first,
+                                   const std::vector<bool> &decide_first, int nranks) {
+  const int ntot = costs.size();
+  const double total = std::accumulate(costs.begin(), costs.end(), 0.0);
+  std::vector<int> starts(nranks, ntot);
+  double offset = 0.0;
+  for (int r = 0; r < first.size(); ++r) {
+    const int last = (r + 1 < first.size()) ? first[r + 1] : ntot;
+    const std::vector<double> my_costs(costs.begin() + first[r], costs.begin() + last);
+    auto my_starts =
+        RankStarts(my_costs, first[r], decide_first[r], offset, total, nranks, ntot);
+    for (int rank = 0; rank < nranks; ++rank) {
+      starts[rank] = std::min(starts[rank], my_starts[rank]);
+    }
+    offset += std::accumulate(my_costs.begin(), my_costs.end(), 0.0);
+  }
+  CompleteRankStarts(starts, ntot);
+  return starts;
+}
+} // namespace
+
+TEST_CASE("Distributed load balance", "[LoadBalance]") {
+  GIVEN("Blocks of equal cost held by three ranks") {
+    const std::vector<double> costs(9, 1.0);
+    THEN("every rank gets a third of the blocks, wherever the costs are held") {
+      REQUIRE(AssignDistributed(costs, {0, 3, 6}, {true, true, true}, 3) ==
+              std::vector<int>{0, 3, 6});
+      REQUIRE(AssignDistributed(costs, {0, 1, 8}, {true, true, true}, 3) ==
+              std::vector<int>{0, 3, 6});
+    }
+  }
+
+  GIVEN("Blocks of different costs") {
+    const std::vector<double> costs{4.0, 1.0, 1.0, 1.0, 1.0};
+    THEN("the expensive block gets a rank of its own") {
+      REQUIRE(AssignDistributed(costs, {0, 2}, {true, true}, 2) ==
+              std::vector<int>{0, 1});
+    }
+  }
+
+  GIVEN("A block expensive enough to cover the share of two ranks") {
+    const std::vector<double> costs{10.0, 1.0, 1.0, 1.0};
+    THEN("every rank still gets a block") {
+      REQUIRE(AssignDistributed(costs, {0, 1, 2}, {true, true, true}, 3) ==
+              std::vector<int>{0, 1, 2});
+    }
+  }
+
+  GIVEN("A block whose cost is split between two ranks") {
+    // the cost of block 2 is held in equal parts by both ranks, as for a block that is
+    // derefined from children on both ranks
+    const std::vector<double> rank0{1.0, 1.0, 0.5}, rank1{0.5, 1.0, 1.0};
+    auto starts0 = RankStarts(rank0, 0, true, 0.0, 5.0, 2, 5);
+    auto starts1 = RankStarts(rank1, 2, false, 2.5, 5.0, 2, 5);
+    THEN("only the rank holding its first part decides its rank") {
+      REQUIRE(starts0 == std::vector<int>{0, 5});
+      // the second rank would have assigned the block to itself
+      REQUIRE(starts1 == std::vector<int>{5, 3});
+      std::vector<int> starts{std::min(starts0[0], starts1[0]),
+                              std::min(starts0[1], starts1[1])};
+      CompleteRankStarts(starts, 5);
+      REQUIRE(starts == std::vector<int>{0, 3});
+    }
+  }
+
+  GIVEN("Ranks that none of the blocks are assigned to") {
+    std::vector<int> starts{4, 4, 0, 4};
+    CompleteRankStarts(starts, 4);
+    THEN("the starts are shifted so that every rank gets one block") {
+      REQUIRE(starts == std::vector<int>{0, 1, 2, 3});
+    }
+  }
+}
@@ -0,0 +1,1078 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "amr_criteria/refinement_package.hpp"
+#include "application_input.hpp"
+#include "basic_types.hpp"
+#include "globals.hpp"
+#include "interface/data_collection.hpp"
+#include "interface/make_pack_descriptor.hpp"
+#include "interface/mesh_data.hpp"
+#include "interface/meshblock_data.hpp"
+#include "interface/metadata.hpp"
+#include "interface/packages.hpp"
+#include "interface/state_descriptor.hpp"
+#include "interface/swarm_container.hpp"
+#include "interface/update.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/memory_usage.hpp"
+#include "mesh/mesh.hpp"
+#include "mesh/mesh_refinement.hpp"
+#include "mesh/meshblock.hpp"
+#include "parameter_input.hpp"
+#include "time_integration/staged_integrator.hpp"
+
+// The tests below build a complete Mesh, whose communicators need MPI to be initialized,
+// which the unit tests do not do
+#ifndef MPI_PARALLEL
+
+using parthenon::AmrTag;
+using parthenon::ApplicationInput;
+using parthenon::IndexDomain;
+using parthenon::IndexRange;
+using parthenon::Mesh;
+using parthenon::MeshBlock;
+using parthenon::Metadata;
+using parthenon::MetadataFlag;
+using parthenon::Packages_t;
+using parthenon::ParameterInput;
+using parthenon::ParArrayND;
+using parthenon::Real;
+using parthenon::StateDescriptor;
+
+namespace {
+// A periodic two-dimensional mesh of 2x2 blocks of 8x8 cells with a scalar field and a
+// vector field with fluxes that may be refined by one level, in packs of two blocks.
+// The settings of <parthenon/mesh> can be overridden and add_fields can add more fields
+// to the package.
+class TestMesh {
+ public:
+  explicit TestMesh(const std::map<std::string, std::string> &mesh_settings = {},
+                    const std::function<void(StateDescriptor *)> &add_fields = {},
+                    const std::function<void(ParameterInput *)> &add_inputs = {}) {
+    parthenon::Globals::nranks = 1;
+    parthenon::Globals::my_rank = 0;
+    std::map<std::string, std::string> settings{
+        {"x1min", "0.0"}, {"x1max", "1.0"}, {"x2min", "0.0"}, {"x2max", "1.0"},
+        {"x3min", "-0.5"}, {"x3max", "0.5"}, {"nx1", "16"}, {"nx2", "16"}, {"nx3", "1"},
+        {"ix1_bc", "periodic"}, {"ox1_bc", "periodic"}, {"ix2_bc", "periodic"},
+        {"ox2_bc", "periodic"}, {"refinement", "adaptive"}, {"numlevel", "2"},
+        {"derefine_count", "1"}, {"pack_size", "2"}};
+    for (const auto &[key, value] : mesh_settings) {
+      settings[key] = value;
+    }
+    for (const auto &[key, value] : settings) {
+      pin.SetString("parthenon/mesh", key, value);
+    }
+    pin.SetString("parthenon/meshblock", "nx1", "8");
+    pin.SetString("parthenon/meshblock", "nx2", "8");
+    pin.SetString("parthenon/meshblock", "nx3", "1");
+    if (add_inputs) add_inputs(&pin);
+
+    auto pkg = std::make_shared<StateDescriptor>("Test package");
+    pkg->AddField("u", Metadata({Metadata::Cell, Metadata::Independent,
+                                 Metadata::FillGhost}));
+    pkg->AddField("v", Metadata({Metadata::Cell, Metadata::Independent,
+                                 Metadata::WithFluxes},
+                                std::vector<int>{2}));
+    if (add_fields) add_fields(pkg.get());
+    packages.Add(pkg);
+    packages.Add(parthenon::Refinement::Initialize(&pin));
+
+    mesh = std::make_unique<Mesh>(&pin, &app_in, packages);
+    mesh->Initialize(true, &pin, &app_in);
+  }
+
+  // Add a stage to every block, as drivers do before using it
+  void AddStage(const std::string &label) {
+    for (auto &pmb : mesh->block_list) {
+      pmb->meshblock_data.Add(label, pmb->meshblock_data.Get());
+    }
+  }
+
+  // Tag every block with tag(block) and remesh
+  void Remesh(const std::function<AmrTag(const MeshBlock &)> &tag) {
+    for (auto &pmb : mesh->block_list) {
+      pmb->pmr->SetRefinement(tag(*pmb));
+    }
+    mesh->LoadBalancingAndAdaptiveMeshRefinement(&pin, &app_in);
+  }
+
+  ParameterInput pin;
+  ApplicationInput app_in;
+  Packages_t packages;
+  std::unique_ptr<Mesh> mesh;
+};
+
+// Refine the first block and keep the others
+AmrTag RefineFirst(const MeshBlock &pmb) {
+  return pmb.gid == 0 ? AmrTag::refine : AmrTag::same;
+}
+
+// Set all variables of stage on every block to value(gid)
+void FillStage(Mesh &mesh, const std::string &stage,
+               const std::function<Real(int)> &value) {
+  for (auto &pmb : mesh.block_list) {
+    auto rc = pmb->meshblock_data.Get(stage);
+    for (const auto &v : rc->GetVariableVector()) {
+      if (!v->IsAllocated()) continue;
+      rc->MakeWritable(v->label());
+      Kokkos::deep_copy(v->data.KokkosView(), value(pmb->gid));
+    }
+  }
+}
+
+// Whether all variables of stage on every block are value(gid)
+bool StageEquals(Mesh &mesh, const std::string &stage,
+                 const std::function<Real(int)> &value) {
+  for (auto &pmb : mesh.block_list) {
+    for (const auto &v : pmb->meshblock_data.Get(stage)->GetVariableVector()) {
+      auto data = Kokkos::create_mirror_view_and_copy(parthenon::HostMemSpace(),
+                                                      v->data.KokkosView());
+      for (int n = 0; n < data.size(); ++n) {
+        if (data.data()[n] != value(pmb->gid)) return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Whether the interior of every allocated variable of stage on every block is
+// value(gid, label), up to round-off
+bool InteriorEquals(Mesh &mesh, const std::string &stage,
+                    const std::function<Real(int, const std::string &)> &value) {
+  for (auto &pmb : mesh.block_list) {
+    const auto &cb = pmb->cellbounds;
+    const IndexRange ib = cb.GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = cb.GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = cb.GetBoundsK(IndexDomain::interior);
+    for (const auto &v : pmb->meshblock_data.Get(stage)->GetVariableVector()) {
+      if (!v->IsAllocated()) continue;
+      const Real expected = value(pmb->gid, v->label());
+      auto data = v->data.GetHostMirrorAndCopy();
+      for (int l = 0; l < v->GetDim(4); ++l) {
+        for (int k = kb.s; k <= kb.e; ++k) {
+          for (int j = jb.s; j <= jb.e; ++j) {
+            for (int i = ib.s; i <= ib.e; ++i) {
+              if (data(l, k, j, i) != Approx(expected)) return false;
+            }
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Whether the interiors of all allocated variables of two stages agree, up to round-off
+bool InteriorsAgree(Mesh &mesh, const std::string &stage1, const std::string &stage2) {
+  for (auto &pmb : mesh.block_list) {
+    const auto &cb = pmb->cellbounds;
+    const IndexRange ib = cb.GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = cb.GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = cb.GetBoundsK(IndexDomain::interior);
+    const auto &vars1 = pmb->meshblock_data.Get(stage1)->GetVariableVector();
+    const auto &vars2 = pmb->meshblock_data.Get(stage2)->GetVariableVector();
+    for (int n = 0; n < vars1.size(); ++n) {
+      if (!vars1[n]->IsAllocated()) continue;
+      auto data1 = vars1[n]->data.GetHostMirrorAndCopy();
+      auto data2 = vars2[n]->data.GetHostMirrorAndCopy();
+      for (int l = 0; l < vars1[n]->GetDim(4); ++l) {
+        for (int k = kb.s; k <= kb.e; ++k) {
+          for (int j = jb.s; j <= jb.e; ++j) {
+            for (int i = ib.s; i <= ib.e; ++i) {
+              if (data1(l, k, j, i) != Approx(data2(l, k, j, i))) return false;
+            }
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+} // namespace
+
+TEST_CASE("Partitions of the mesh data", "[Mesh][DataCollection]") {
+  GIVEN("A mesh of four blocks in packs of two") {
+    TestMesh test;
+    auto &mesh = *test.mesh;
+    auto &mesh_data = mesh.mesh_data;
+    REQUIRE(mesh.DefaultNumPartitions() == 2);
+
+    test.AddStage("dUdt");
+    const int base = mesh_data.GetStageId("base");
+    const int dudt = mesh_data.GetStageId("dUdt");
+    REQUIRE(base == 0);
+
+    // the blocks of every partition are the cached partitions of the Mesh
+    auto check_partitions = [&](int stage_id) {
+      const auto &partitions = mesh.GetDefaultBlockPartitions();
+      REQUIRE(partitions.size() == mesh.DefaultNumPartitions());
+      int nblocks = 0;
+      for (int p = 0; p < partitions.size(); ++p) {
+        auto &md = mesh_data.GetOrAddPartition(stage_id, p);
+        REQUIRE(md->NumBlocks() == partitions[p].size());
+        for (int b = 0; b < md->NumBlocks(); ++b) {
+          REQUIRE(md->GetBlockData(b)->GetBlockPointer() == partitions[p][b].get());
+          REQUIRE(partitions[p][b] == mesh.block_list[nblocks++]);
+        }
+      }
+      REQUIRE(nblocks == mesh.block_list.size());
+    };
+
+    THEN("the partitions of every stage cover the blocks in order") {
+      check_partitions(base);
+      check_partitions(dudt);
+    }
+
+    THEN("the partitions are reused by id and by label") {
+      auto md = mesh_data.GetOrAddPartition(dudt, 1);
+      REQUIRE(mesh_data.GetOrAddPartition(dudt, 1) == md);
+      REQUIRE(mesh_data.GetOrAdd("dUdt", 1) == md);
+      REQUIRE(mesh_data.GetOrAddPartition(base, 1) != md);
+    }
+
+    WHEN("the mesh is refined") {
+      auto md = mesh_data.GetOrAddPartition(dudt, 0);
+      const auto old_partitions = mesh.GetDefaultBlockPartitions();
+      test.Remesh(RefineFirst);
+      REQUIRE(mesh.nbtotal == 7);
+      test.AddStage("dUdt");
+
+      THEN("the partitions are rebuilt and the stage ids remain valid") {
+        REQUIRE(mesh.DefaultNumPartitions() == 4);
+        REQUIRE(mesh.GetDefaultBlockPartitions()[0] != old_partitions[0]);
+        REQUIRE(mesh_data.GetStageId("dUdt") == dudt);
+        REQUIRE(mesh_data.GetOrAddPartition(dudt, 0) != md);
+        check_partitions(base);
+        check_partitions(dudt);
+      }
+    }
+  }
+}
+
+TEST_CASE("Variable storage shared by all blocks", "[Mesh][VariableArena]") {
+  GIVEN("A mesh without refinement that shares the storage of all blocks") {
+    TestMesh test({{"mesh_variable_storage", "true"}, {"refinement", "none"}});
+    auto &mesh = *test.mesh;
+    test.AddStage("dUdt");
+    const auto &arena = mesh.GetMeshArena("base");
+    REQUIRE(arena != nullptr);
+
+    THEN("every stage has one arena holding the variables of all blocks") {
+      REQUIRE(mesh.GetMeshArena("dUdt") != nullptr);
+      REQUIRE(mesh.GetMeshArena("dUdt") != arena);
+      REQUIRE(mesh.GetMeshArena("missing") == nullptr);
+      REQUIRE(arena->NumVariables() == 2);
+      REQUIRE(arena->NumBlocks("u") == mesh.block_list.size());
+    }
+
+    THEN("the data of every block is its slot of the arena") {
+      for (auto &pmb : mesh.block_list) {
+        for (const std::string stage : {"base", "dUdt"}) {
+          auto rc = pmb->meshblock_data.Get(stage);
+          REQUIRE(rc->GetArena() == mesh.GetMeshArena(stage));
+          REQUIRE(rc->GetArenaBlock() == pmb->lid);
+          for (const std::string label : {"u", "v"}) {
+            const auto &data = rc->Get(label).data;
+            const auto all = rc->GetArena()->GetAllBlocks(label);
+            REQUIRE(all.size() == mesh.block_list.size() * data.KokkosView().size());
+            REQUIRE(data.data() == all.data() + pmb->lid * data.KokkosView().size());
+          }
+        }
+      }
+    }
+  }
+
+  // load balancing is only available with MPI, which this test does not use
+  GIVEN("A mesh with adaptive refinement") {
+    THEN("storage shared by all blocks is rejected") {
+      REQUIRE_THROWS(TestMesh({{"mesh_variable_storage", "true"}}));
+      REQUIRE_THROWS(
+          TestMesh({{"mesh_variable_storage", "true"}, {"variable_arena", "false"}}));
+    }
+  }
+}
+
+TEST_CASE("Copy-on-write stages", "[Mesh][MeshBlockData]") {
+  GIVEN("A mesh whose stages share the data of variables without ghost exchange") {
+    TestMesh test({{"copy_on_write_stages", "true"}});
+    auto &mesh = *test.mesh;
+    for (auto &pmb : mesh.block_list) {
+      auto base = pmb->meshblock_data.Get();
+      Kokkos::deep_copy(base->Get("v").data.KokkosView(), 1.0 + pmb->gid);
+    }
+    test.AddStage("dUdt");
+    auto &pmb = mesh.block_list[0];
+    auto base = pmb->meshblock_data.Get();
+    auto rc = pmb->meshblock_data.Get("dUdt");
+    auto shares = [&](const std::string &label) {
+      return rc->GetVarPtr(label)->data.data() == base->Get(label).data.data();
+    };
+    // whether v of the stage was copied from the base and can be written independently
+    auto is_private_copy = [&]() {
+      if (rc->GetVarPtr("v")->IsShared() || shares("v")) return false;
+      auto v = Kokkos::create_mirror_view_and_copy(parthenon::HostMemSpace(),
+                                                   rc->GetVarPtr("v")->data.KokkosView());
+      for (int n = 0; n < v.size(); ++n) {
+        if (v.data()[n] != 1.0) return false;
+      }
+      Kokkos::deep_copy(rc->GetVarPtr("v")->data.KokkosView(), -1.0);
+      auto v0 = Kokkos::create_mirror_view_and_copy(parthenon::HostMemSpace(),
+                                                    base->Get("v").data.KokkosView());
+      return v0.data()[0] == 1.0;
+    };
+
+    THEN("only the variables without ghost exchange alias the data of the base") {
+      REQUIRE(rc->NumSharedVariables() == 1);
+      REQUIRE(rc->GetVarPtr("v")->IsShared());
+      REQUIRE(shares("v"));
+      REQUIRE(!rc->GetVarPtr("u")->IsShared());
+      REQUIRE(!shares("u"));
+    }
+
+    THEN("making a variable writable copies its data once") {
+      REQUIRE(rc->MakeWritable("v"));
+      REQUIRE(rc->NumSharedVariables() == 0);
+      REQUIRE(!rc->MakeWritable("v"));
+      REQUIRE(is_private_copy());
+    }
+
+    THEN("getting a variable copies its data unless the container is const") {
+      const auto &const_rc = *rc;
+      REQUIRE(const_rc.Get("v").IsShared());
+      REQUIRE(shares("v"));
+      REQUIRE(!rc->Get("v").IsShared());
+      REQUIRE(rc->NumSharedVariables() == 0);
+      REQUIRE(is_private_copy());
+    }
+
+    THEN("variable packs copy the data unless they are read-only") {
+      const std::vector<std::string> v{"v"};
+      auto &read = rc->PackVariablesReadOnly(v);
+      REQUIRE(read(0).data() == base->Get("v").data.data());
+      REQUIRE(shares("v"));
+      auto &write = rc->PackVariables(v);
+      REQUIRE(write(0).data() == rc->GetVarPtr("v")->data.data());
+      REQUIRE(is_private_copy());
+    }
+
+    THEN("variable packs of the mesh data copy the data unless they are read-only") {
+      auto md = mesh.mesh_data.GetOrAdd("dUdt", 0);
+      const std::vector<std::string> v{"v"};
+      md->PackVariablesReadOnly(v);
+      REQUIRE(shares("v"));
+      md->PackVariables(v);
+      REQUIRE(is_private_copy());
+    }
+
+    THEN("variable flux packs copy the data") {
+      rc->PackVariablesAndFluxes(std::vector<std::string>{"v"});
+      REQUIRE(is_private_copy());
+    }
+
+    THEN("sparse packs copy the data unless they are read-only") {
+      using parthenon::PDOpt;
+      auto pkgs = mesh.resolved_packages.get();
+      const std::vector<std::string> v{"v"};
+      parthenon::MakePackDescriptor(pkgs, v, {}, {PDOpt::ReadOnly}).GetPack(rc.get());
+      REQUIRE(shares("v"));
+      parthenon::MakePackDescriptor(pkgs, v).GetPack(rc.get());
+      REQUIRE(is_private_copy());
+    }
+
+    THEN("weighted sums only copy their output") {
+      test.AddStage("out");
+      auto out = pmb->meshblock_data.Get("out");
+      const std::vector<MetadataFlag> flags{Metadata::Independent};
+      parthenon::Update::WeightedSumData(flags, rc.get(), rc.get(), 1.0, 1.0, out.get());
+      REQUIRE(shares("v"));
+      REQUIRE(!out->GetVarPtr("v")->IsShared());
+    }
+  }
+}
+
+TEST_CASE("Exchange of refinement flags", "[Mesh][Refinement]") {
+  GIVEN("An adaptive mesh with outflow boundaries that may be refined by two levels") {
+    TestMesh test({{"numlevel", "3"},
+                   {"ix1_bc", "outflow"},
+                   {"ox1_bc", "outflow"},
+                   {"ix2_bc", "outflow"},
+                   {"ox2_bc", "outflow"}});
+    auto &mesh = *test.mesh;
+    const int root_level = mesh.GetRootLevel();
+    auto count_level = [&mesh](int level) {
+      int n = 0;
+      for (const auto &loc : mesh.GetLocList()) {
+        n += (loc.level() == level);
+      }
+      return n;
+    };
+
+    WHEN("the exchange is started as a task after tagging") {
+      for (auto &pmb : mesh.block_list) {
+        pmb->pmr->SetRefinement(RefineFirst(*pmb));
+      }
+      REQUIRE(mesh.StartRemeshExchange() == parthenon::TaskStatus::complete);
+      // a second call during the same step does not start another exchange
+      REQUIRE(mesh.StartRemeshExchange() == parthenon::TaskStatus::complete);
+      mesh.LoadBalancingAndAdaptiveMeshRefinement(&test.pin, &test.app_in);
+
+      THEN("the flagged block is refined") {
+        REQUIRE(mesh.modified);
+        REQUIRE(mesh.nbtotal == 7);
+        REQUIRE(count_level(root_level + 1) == 4);
+      }
+    }
+
+    WHEN("all blocks are refined") {
+      test.Remesh([](const MeshBlock &) { return AmrTag::refine; });
+      REQUIRE(mesh.nbtotal == 16);
+
+      WHEN("one block is refined while the children of another are derefined") {
+        test.Remesh([](const MeshBlock &pmb) {
+          if (pmb.gid == 0) return AmrTag::refine;
+          return pmb.loc.lx1() >= 2 && pmb.loc.lx2() >= 2 ? AmrTag::derefine
+                                                           : AmrTag::same;
+        });
+
+        THEN("the locations of both kinds of flagged blocks are exchanged") {
+          REQUIRE(mesh.modified);
+          REQUIRE(mesh.nbtotal == 16);
+          REQUIRE(count_level(root_level) == 1);
+          REQUIRE(count_level(root_level + 1) == 11);
+          REQUIRE(count_level(root_level + 2) == 4);
+        }
+      }
+
+      WHEN("no block is flagged") {
+        test.Remesh([](const MeshBlock &) { return AmrTag::same; });
+        THEN("the mesh is not modified") {
+          REQUIRE(!mesh.modified);
+          REQUIRE(mesh.nbtotal == 16);
+        }
+      }
+    }
+  }
+
+  GIVEN("A uniform mesh without load balancing") {
+    TestMesh test({{"refinement", "none"}});
+    auto &mesh = *test.mesh;
+    THEN("there is nothing to exchange and the mesh is never modified") {
+      REQUIRE(mesh.StartRemeshExchange() == parthenon::TaskStatus::complete);
+      mesh.LoadBalancingAndAdaptiveMeshRefinement(&test.pin, &test.app_in);
+      REQUIRE(!mesh.modified);
+      REQUIRE(mesh.nbtotal == 4);
+    }
+  }
+}
+
+TEST_CASE("Cost model of the load balancing", "[Mesh][LoadBalance]") {
+  GIVEN("A mesh with a private and a provided swarm in a package with a space") {
+    TestMesh test(
+        {{"refinement", "none"}},
+        [](StateDescriptor *pkg) {
+          pkg->AddSwarm("p", Metadata({Metadata::Private}));
+          pkg->AddSwarm("q", Metadata({Metadata::Provides}));
+        },
+        [](ParameterInput *pin) {
+          pin->SetString("parthenon/loadbalancing", "balancer", "model");
+          pin->SetReal("parthenon/loadbalancing", "cell_weight", 0.5);
+          pin->SetReal("parthenon/loadbalancing", "particle_weight", 2.0);
+          pin->SetReal("parthenon/loadbalancing", "particle_weight_Test_package", 3.0);
+        });
+    auto &mesh = *test.mesh;
+    // the private swarm is prefixed by the package in the blocks
+    auto add_particles = [&](int gid, const std::string &swarm, int n) {
+      ParArrayND<int> new_indices;
+      auto &swarm_container = mesh.block_list[gid]->swarm_data.Get();
+      swarm_container->Get(swarm)->AddEmptyParticles(n, new_indices);
+    };
+    add_particles(0, "Test package::p", 5);
+    add_particles(0, "q", 2);
+    add_particles(1, "q", 4);
+    mesh.StartRemeshExchange();
+
+    THEN("the cost of every block is cell_weight * ncells + weight * nparticles") {
+      const Real ncells = 8 * 8;
+      const Real weight = 2.0 * 3.0;
+      REQUIRE(mesh.costlist[0] == Approx(0.5 * ncells + weight * 7));
+      REQUIRE(mesh.costlist[1] == Approx(0.5 * ncells + weight * 4));
+      for (int gid = 2; gid < mesh.nbtotal; ++gid) {
+        REQUIRE(mesh.costlist[gid] == Approx(0.5 * ncells));
+      }
+    }
+  }
+}
+
+TEST_CASE("Multigrid hierarchy after remeshing", "[Mesh][GMG]") {
+  GIVEN("A multigrid mesh") {
+    TestMesh test({{"multigrid", "true"}});
+    auto &mesh = *test.mesh;
+    const int root_gmg_level = mesh.GetRootLevel() - mesh.GetGMGMinLogicalLevel();
+    REQUIRE(root_gmg_level > 0);
+    REQUIRE(mesh.GetGMGMaxLevel() == root_gmg_level);
+
+    // whether the global ids of the same level neighbors of the blocks of a level match
+    // the ids of the level
+    auto neighbor_ids_match = [&mesh](int gmg_level) {
+      const int logical_level = gmg_level + mesh.GetGMGMinLogicalLevel();
+      const auto &locs = mesh.gmg_grid_locs[gmg_level];
+      for (auto &pmb : mesh.gmg_block_lists[gmg_level]) {
+        if (locs.at(pmb->loc).first != pmb->gid) return false;
+        const auto &neighbors = pmb->loc.level() == logical_level
+                                    ? pmb->gmg_same_neighbors
+                                    : pmb->gmg_composite_finer_neighbors;
+        for (auto &nb : neighbors) {
+          if (locs.at(nb.loc).first != nb.snb.gid) return false;
+        }
+      }
+      return true;
+    };
+
+    std::vector<parthenon::MeshData<Real> *> old_mesh_data;
+    std::vector<parthenon::BlockList_t> old_block_lists = mesh.gmg_block_lists;
+    for (auto &level : mesh.gmg_mesh_data) {
+      old_mesh_data.push_back(level.Get().get());
+    }
+    auto coarsest = mesh.gmg_block_lists[0][0];
+    const int old_coarsest_gid = coarsest->gid;
+
+    WHEN("a block is refined, which changes the global ids of all internal nodes") {
+      test.Remesh(RefineFirst);
+      REQUIRE(mesh.nbtotal == 7);
+      REQUIRE(mesh.GetGMGMaxLevel() == root_gmg_level + 1);
+      REQUIRE(coarsest->gid != old_coarsest_gid);
+
+      THEN("the levels coarser than the root grid keep their MeshData and blocks") {
+        for (int gmg_level = 0; gmg_level < root_gmg_level; ++gmg_level) {
+          REQUIRE(mesh.gmg_mesh_data[gmg_level].Get().get() == old_mesh_data[gmg_level]);
+          REQUIRE(mesh.gmg_block_lists[gmg_level] == old_block_lists[gmg_level]);
+        }
+      }
+
+      THEN("the level of the root grid and the new level are rebuilt") {
+        REQUIRE(mesh.gmg_mesh_data[root_gmg_level].Get().get() !=
+                old_mesh_data[root_gmg_level]);
+      }
+
+      THEN("the neighbors of all levels have the new global ids") {
+        for (int gmg_level = 0; gmg_level <= mesh.GetGMGMaxLevel(); ++gmg_level) {
+          REQUIRE(neighbor_ids_match(gmg_level));
+        }
+      }
+
+      THEN("the coarser neighbors refer to the new global ids of the coarser level") {
+        for (int gmg_level = 1; gmg_level <= mesh.GetGMGMaxLevel(); ++gmg_level) {
+          const int logical_level = gmg_level + mesh.GetGMGMinLogicalLevel();
+          for (auto &pmb : mesh.gmg_block_lists[gmg_level]) {
+            if (pmb->loc.level() != logical_level) continue;
+            REQUIRE(pmb->gmg_coarser_neighbors.size() == 1);
+            auto &nb = pmb->gmg_coarser_neighbors[0];
+            REQUIRE(nb.snb.gid == mesh.gmg_grid_locs[gmg_level - 1].at(nb.loc).first);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Lazy coarse buffers", "[Mesh][Refinement]") {
+  GIVEN("A refined mesh that only keeps the coarse buffers it needs") {
+    TestMesh test({{"lazy_coarse_buffers", "true"}});
+    auto &mesh = *test.mesh;
+    const int root_level = mesh.GetRootLevel();
+    auto has_coarse = [](const MeshBlock &pmb) {
+      return pmb.meshblock_data.Get()->Get("u").coarse_s.size() > 0;
+    };
+    // whether every block has coarse buffers if and only if it has a coarser neighbor
+    auto buffers_as_needed = [&]() {
+      for (auto &pmb : mesh.block_list) {
+        if (pmb->HasCoarseBuffers() != pmb->NeedsCoarseBuffers() ||
+            has_coarse(*pmb) != pmb->NeedsCoarseBuffers()) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    THEN("the blocks of the uniform mesh have no coarse buffers") {
+      REQUIRE(buffers_as_needed());
+      REQUIRE(!has_coarse(*mesh.block_list[0]));
+    }
+
+    THEN("coarse variable packs are rejected") {
+      auto rc = mesh.block_list[0]->meshblock_data.Get();
+      const std::vector<std::string> u{"u"};
+      REQUIRE_THROWS(rc->PackVariables(u, true));
+      REQUIRE_THROWS(mesh.mesh_data.GetOrAdd("base", 0)->PackVariables(u, true));
+      REQUIRE_NOTHROW(rc->PackVariables(u));
+    }
+
+    WHEN("all blocks are refined") {
+      test.Remesh([](const MeshBlock &) { return AmrTag::refine; });
+      REQUIRE(mesh.nbtotal == 16);
+
+      THEN("the new blocks release their coarse buffers without coarser neighbors") {
+        REQUIRE(buffers_as_needed());
+        REQUIRE(!has_coarse(*mesh.block_list[0]));
+      }
+
+      WHEN("the children of one block are derefined") {
+        for (auto &pmb : mesh.block_list) {
+          auto u = pmb->meshblock_data.Get()->Get("u").data;
+          Kokkos::deep_copy(u.KokkosView(), 3.0);
+        }
+        test.Remesh([](const MeshBlock &pmb) {
+          return pmb.loc.lx1() >= 2 && pmb.loc.lx2() >= 2 ? AmrTag::derefine
+                                                           : AmrTag::same;
+        });
+        REQUIRE(mesh.nbtotal == 13);
+
+        THEN("the remaining blocks next to the coarser block allocate coarse buffers") {
+          int nfine_with_buffers = 0;
+          for (auto &pmb : mesh.block_list) {
+            if (pmb->loc.level() > root_level && has_coarse(*pmb)) nfine_with_buffers++;
+          }
+          REQUIRE(nfine_with_buffers == 12);
+          REQUIRE(buffers_as_needed());
+        }
+
+        THEN("the derefined block holds the restriction of its children") {
+          for (auto &pmb : mesh.block_list) {
+            if (pmb->loc.level() != root_level) continue;
+            auto u = pmb->meshblock_data.Get()->Get("u").data.GetHostMirrorAndCopy();
+            auto ib = pmb->cellbounds.GetBoundsI(IndexDomain::interior);
+            auto jb = pmb->cellbounds.GetBoundsJ(IndexDomain::interior);
+            int nwrong = 0;
+            for (int j = jb.s; j <= jb.e; ++j) {
+              for (int i = ib.s; i <= ib.e; ++i) {
+                nwrong += (u(0, 0, j, i) != 3.0);
+              }
+            }
+            REQUIRE(nwrong == 0);
+            REQUIRE(!has_coarse(*pmb));
+          }
+        }
+      }
+    }
+  }
+
+  GIVEN("A refined mesh that keeps all coarse buffers") {
+    TestMesh test;
+    THEN("every block has coarse buffers and coarse variable packs") {
+      for (auto &pmb : test.mesh->block_list) {
+        REQUIRE(pmb->HasCoarseBuffers());
+      }
+      auto rc = test.mesh->block_list[0]->meshblock_data.Get();
+      REQUIRE_NOTHROW(rc->PackVariables(std::vector<std::string>{"u"}, true));
+    }
+  }
+}
+
+TEST_CASE("Deallocation of sparse variables", "[Mesh][Sparse]") {
+  auto &config = parthenon::Globals::sparse_config;
+  if (!config.enabled) return;
+  // restores the global sparse settings changed by the test
+  struct ConfigGuard {
+    parthenon::Globals::SparseConfig saved = parthenon::Globals::sparse_config;
+    ~ConfigGuard() { parthenon::Globals::sparse_config = saved; }
+  } guard;
+  config.deallocation_count = 1;
+
+  TestMesh test({{"refinement", "none"}}, [](StateDescriptor *pkg) {
+    pkg->AddSparsePool("s", Metadata({Metadata::Cell, Metadata::Sparse}),
+                       std::vector<int>{1});
+  });
+  auto &mesh = *test.mesh;
+  auto &pmb = *mesh.block_list[0];
+  pmb.AllocSparseID("s", 1);
+  auto md = mesh.mesh_data.GetOrAdd("base", 0);
+  REQUIRE(md->GetBlockData(0)->GetBlockPointer() == mesh.block_list[0].get());
+  auto dealloc = [&](int ncalls) {
+    for (int n = 0; n < ncalls; ++n) {
+      parthenon::Update::SparseDealloc(md.get());
+    }
+  };
+
+  GIVEN("A deallocation interval of two calls") {
+    config.deallocation_interval = 2;
+    // the first call checks, the second one is skipped
+    dealloc(2);
+    const auto &state = md->GetSparseDeallocState();
+    const auto is_zero = state.is_zero;
+    THEN("the calls are counted by the MeshData and only every other one checks") {
+      REQUIRE(state.ncalls == 2);
+      REQUIRE(is_zero.GetDim(2) >= md->NumBlocks());
+      REQUIRE(pmb.IsAllocated("s_1"));
+      dealloc(1);
+      REQUIRE(state.ncalls == 3);
+      REQUIRE(!pmb.IsAllocated("s_1"));
+      AND_THEN("the flags of the check are not reallocated") {
+        REQUIRE(state.is_zero.data() == is_zero.data());
+        REQUIRE(state.is_zero_h.data() != nullptr);
+      }
+    }
+  }
+
+  GIVEN("A sparse variable that is only above the threshold in a ghost zone") {
+    auto &data = pmb.meshblock_data.Get()->Get("s_1").data;
+    auto data_h = data.GetHostMirrorAndCopy();
+    data_h(0, 0, 0) = 1.0;
+    data.DeepCopy(data_h);
+    THEN("it is kept when all cells are checked") {
+      dealloc(3);
+      REQUIRE(pmb.IsAllocated("s_1"));
+    }
+    THEN("it is deallocated when only the interior is checked") {
+      config.deallocation_interior_only = true;
+      dealloc(3);
+      REQUIRE(!pmb.IsAllocated("s_1"));
+    }
+  }
+}
+
+TEST_CASE("Trimming the variable storage pool", "[Mesh][VariableStoragePool]") {
+  GIVEN("A static mesh with a deallocated sparse variable") {
+    TestMesh test({{"refinement", "none"}, {"pool_variable_storage_trim_interval", "3"}},
+                  [](StateDescriptor *pkg) {
+                    pkg->AddSparsePool("s", Metadata({Metadata::Cell, Metadata::Sparse}),
+                                       std::vector<int>{1});
+                  });
+    auto &mesh = *test.mesh;
+    if (!parthenon::Globals::sparse_config.enabled) return;
+    mesh.block_list[0]->AllocSparseID("s", 1);
+    mesh.block_list[0]->DeallocateSparse("s_1");
+    const auto &pool = mesh.GetVariableStoragePool();
+    REQUIRE(pool != nullptr);
+    REQUIRE(pool->SizeInBytes() > 0);
+
+    WHEN("the storage is not reused for two trim intervals") {
+      auto cycles = [&](int n) {
+        for (int cycle = 0; cycle < n; ++cycle) {
+          mesh.LoadBalancingAndAdaptiveMeshRefinement(&test.pin, &test.app_in);
+        }
+      };
+      cycles(3);
+      const std::int64_t after_first_trim = pool->SizeInBytes();
+      cycles(3);
+      THEN("it is freed by the second trim although the mesh never changed") {
+        REQUIRE(after_first_trim > 0);
+        REQUIRE(!mesh.modified);
+        REQUIRE(pool->SizeInBytes() == 0);
+      }
+    }
+  }
+}
+
+TEST_CASE("Memory usage of the mesh", "[Mesh][MemoryUsage]") {
+  GIVEN("A mesh with dense, sparse, flux and coarse allocations in two stages") {
+    TestMesh test({}, [](StateDescriptor *pkg) {
+      pkg->AddSparsePool("s", Metadata({Metadata::Cell, Metadata::Sparse}),
+                         std::vector<int>{1, 2});
+    });
+    auto &mesh = *test.mesh;
+    mesh.block_list[0]->AllocSparseID("s", 1);
+    test.AddStage("dUdt");
+    mesh.memory_usage.Sample(&mesh);
+
+    using Component = parthenon::MemoryUsage::Component;
+    const auto &entries = mesh.memory_usage.Entries();
+    auto bytes = [&](const std::string &label, Component component,
+                     const std::string &stage = "base") -> std::int64_t {
+      auto it = entries.find({"Test package", label, component, stage});
+      return it == entries.end() ? 0 : it->second.current;
+    };
+    // sizes of one component of a variable on a block, including the ghost zones
+    const auto &pmb = mesh.block_list[0];
+    const std::int64_t nblocks = mesh.block_list.size();
+    const std::int64_t cells =
+        pmb->cellbounds.GetTotal(IndexDomain::entire) * sizeof(Real);
+    const std::int64_t coarse_cells =
+        pmb->c_cellbounds.GetTotal(IndexDomain::entire) * sizeof(Real);
+
+    THEN("the data of the dense variables are counted for every stage") {
+      for (const std::string stage : {"base", "dUdt"}) {
+        REQUIRE(bytes("u", Component::data, stage) == nblocks * cells);
+        REQUIRE(bytes("v", Component::data, stage) == 2 * nblocks * cells);
+      }
+    }
+
+    THEN("the sparse variables are counted where they are allocated") {
+      const bool sparse = parthenon::Globals::sparse_config.enabled;
+      REQUIRE(bytes("s_1", Component::data) == (sparse ? 1 : nblocks) * cells);
+      REQUIRE(bytes("s_2", Component::data) == (sparse ? 0 : nblocks) * cells);
+    }
+
+    THEN("the fluxes in both directions are counted once for all stages") {
+      REQUIRE(bytes("v", Component::fluxes) == 2 * 2 * nblocks * cells);
+      REQUIRE(bytes("v", Component::fluxes, "dUdt") == 0);
+      REQUIRE(bytes("u", Component::fluxes) == 0);
+    }
+
+    THEN("the coarse buffers are counted once for all stages") {
+      REQUIRE(bytes("u", Component::coarse) == nblocks * coarse_cells);
+      REQUIRE(bytes("v", Component::coarse) == 2 * nblocks * coarse_cells);
+      REQUIRE(bytes("u", Component::coarse, "dUdt") == 0);
+      REQUIRE(bytes("s_1", Component::coarse) == 0);
+    }
+
+    THEN("the high-water marks are the current values of the only sample") {
+      for (const auto &[key, usage] : entries) {
+        REQUIRE(usage.high_water == usage.current);
+      }
+    }
+  }
+}
+
+TEST_CASE("Weighted sums of the mesh data", "[Mesh][Update]") {
+  // out = 2 * base + 0.5 * dUdt for all partitions, returns whether the sums were flat
+  // loops over the arenas
+  auto weighted_sum = [](TestMesh &test) {
+    auto &mesh_data = test.mesh->mesh_data;
+    const std::vector<MetadataFlag> flags{Metadata::Independent};
+    bool fused = true;
+    for (int p = 0; p < test.mesh->DefaultNumPartitions(); ++p) {
+      auto md = mesh_data.GetOrAdd("base", p).get();
+      auto dudt = mesh_data.GetOrAdd("dUdt", p).get();
+      auto out = mesh_data.GetOrAdd("out", p).get();
+      using namespace parthenon::Update;
+      fused = WeightedSumArenas(flags, md, dudt, 0.0, 0.0, out) && fused;
+      WeightedSumData(flags, md, dudt, 2.0, 0.5, out);
+    }
+    return fused;
+  };
+  auto base = [](int gid) { return 1.0 + gid; };
+  auto rate = [](int gid) { return 10.0 * gid; };
+  auto expected = [&](int gid) { return 2.0 * base(gid) + 0.5 * rate(gid); };
+
+  GIVEN("A mesh with an arena per block and stage") {
+    TestMesh test({{"variable_arena", "true"}, {"variable_arena_padding", "3"}});
+    FillStage(*test.mesh, "base", base);
+    THEN("the sums are flat loops over the arenas and correct") {
+      test.AddStage("dUdt");
+      test.AddStage("out");
+      FillStage(*test.mesh, "dUdt", rate);
+      REQUIRE(weighted_sum(test));
+      REQUIRE(StageEquals(*test.mesh, "out", expected));
+    }
+  }
+
+  GIVEN("A mesh with an arena per stage for all blocks") {
+    TestMesh test({{"mesh_variable_storage", "true"}, {"refinement", "none"}});
+    REQUIRE(test.mesh->GetMeshArena("base") != nullptr);
+    FillStage(*test.mesh, "base", base);
+    THEN("the sums are flat loops over the arenas and correct") {
+      test.AddStage("dUdt");
+      test.AddStage("out");
+      FillStage(*test.mesh, "dUdt", rate);
+      REQUIRE(weighted_sum(test));
+      REQUIRE(StageEquals(*test.mesh, "out", expected));
+    }
+  }
+
+  GIVEN("A mesh whose stages share the data of variables without ghost exchange") {
+    TestMesh test({{"variable_arena", "true"}, {"copy_on_write_stages", "true"}});
+    FillStage(*test.mesh, "base", base);
+    THEN("the sums fall back to the packs and are correct") {
+      test.AddStage("dUdt");
+      test.AddStage("out");
+      FillStage(*test.mesh, "dUdt", rate);
+      REQUIRE(!weighted_sum(test));
+      REQUIRE(StageEquals(*test.mesh, "out", expected));
+    }
+  }
+
+  GIVEN("A mesh without arenas") {
+    TestMesh test;
+    FillStage(*test.mesh, "base", base);
+    THEN("the sums fall back to the packs and are correct") {
+      test.AddStage("dUdt");
+      test.AddStage("out");
+      FillStage(*test.mesh, "dUdt", rate);
+      REQUIRE(!weighted_sum(test));
+      REQUIRE(StageEquals(*test.mesh, "out", expected));
+    }
+  }
+}
+
+TEST_CASE("Butcher tableau sums of the mesh data", "[Mesh][Update]") {
+  using parthenon::ButcherIntegrator;
+  using parthenon::MeshData;
+  namespace Update = parthenon::Update;
+  const std::vector<MetadataFlag> flags{Metadata::Independent};
+  const Real dt = 0.1;
+  // more registers than a single kernel of WeightedSumRegisters reads
+  const int nregisters = Update::impl::max_fused_registers + 3;
+
+  TestMesh test({}, [](StateDescriptor *pkg) {
+    Metadata m({Metadata::Cell, Metadata::Independent, Metadata::Sparse});
+    pkg->AddSparsePool("s", m, std::vector<int>{1});
+  });
+  auto &mesh = *test.mesh;
+  for (auto &pmb : mesh.block_list) {
+    pmb->AllocSparseID("s", 1);
+  }
+  std::vector<std::string> registers;
+  for (int n = 0; n < nregisters; ++n) {
+    registers.push_back("k" + std::to_string(n));
+    test.AddStage(registers.back());
+  }
+  test.AddStage("out");
+  test.AddStage("ref");
+  auto base = [](int gid) { return 1.0 + gid; };
+  auto value = [](int n, int gid) { return 0.5 * (n + 1) - 0.25 * gid; };
+  FillStage(mesh, "base", base);
+  for (int n = 0; n < nregisters; ++n) {
+    FillStage(mesh, registers[n], [&](int gid) { return value(n, gid); });
+  }
+
+  auto md = [&](const std::string &stage, int p) {
+    return mesh.mesh_data.GetOrAdd(stage, p);
+  };
+  auto stage_data = [&](int p, int n) {
+    std::vector<std::shared_ptr<MeshData<Real>>> data;
+    for (int m = 0; m < n; ++m) {
+      data.push_back(md(registers[m], p));
+    }
+    return data;
+  };
+  // the loop over the registers that the fused sums replace, out = base if given and
+  // out += weight * register for every (register, weight) in terms
+  auto per_register = [&](const std::string &base_stage,
+                          const std::vector<std::pair<int, Real>> &terms,
+                          const std::string &out) {
+    for (int p = 0; p < mesh.DefaultNumPartitions(); ++p) {
+      auto out_data = md(out, p).get();
+      if (!base_stage.empty()) Update::CopyData(flags, md(base_stage, p).get(), out_data);
+      for (const auto &[n, weight] : terms) {
+        Update::WeightedSumData(flags, out_data, md(registers[n], p).get(), 1.0, weight,
+                                out_data);
+      }
+    }
+  };
+  auto agree = [&]() { return InteriorsAgree(mesh, "out", "ref"); };
+
+  for (const std::string name : {"rk2", "rk4"}) {
+    GIVEN("The " + name + " tableau") {
+      const ButcherIntegrator integrator(name);
+      THEN("the stage sums agree with the loop over the previous stages") {
+        for (int stage = 1; stage <= integrator.nstages; ++stage) {
+          std::vector<std::pair<int, Real>> terms;
+          for (int prev = 0; prev < stage; ++prev) {
+            terms.emplace_back(prev, dt * integrator.a[stage - 1][prev]);
+          }
+          per_register("base", terms, "ref");
+          for (int p = 0; p < mesh.DefaultNumPartitions(); ++p) {
+            Update::SumButcher(flags, md("base", p), stage_data(p, integrator.nstages),
+                               md("out", p), &integrator, dt, stage);
+          }
+          REQUIRE(agree());
+        }
+      }
+      THEN("the update agrees with the loop over all stages") {
+        std::vector<std::pair<int, Real>> terms;
+        for (int stage = 0; stage < integrator.nstages; ++stage) {
+          terms.emplace_back(stage, dt * integrator.b[stage]);
+        }
+        per_register("base", terms, "ref");
+        FillStage(mesh, "out", base);
+        for (int p = 0; p < mesh.DefaultNumPartitions(); ++p) {
+          Update::UpdateButcher(flags, stage_data(p, integrator.nstages), md("out", p),
+                                &integrator, dt);
+        }
+        REQUIRE(agree());
+      }
+    }
+  }
+
+  GIVEN("More registers than are summed in one kernel") {
+    std::vector<std::pair<int, Real>> terms;
+    for (int n = 0; n < nregisters; ++n) {
+      terms.emplace_back(n, 1.0 / (n + 1));
+    }
+    auto fused = [&](bool accumulate) {
+      for (int p = 0; p < mesh.DefaultNumPartitions(); ++p) {
+        std::vector<MeshData<Real> *> in;
+        std::vector<Real> weight;
+        for (const auto &[n, w] : terms) {
+          in.push_back(md(registers[n], p).get());
+          weight.push_back(w);
+        }
+        Update::impl::WeightedSumRegisters(flags, in, weight, md("out", p).get(),
+                                           accumulate, "TestSum");
+      }
+    };
+    THEN("the sum agrees with the loop over the registers") {
+      FillStage(mesh, "ref", [](int) { return 0.0; });
+      per_register("", terms, "ref");
+      FillStage(mesh, "out", [](int) { return 99.0; });
+      fused(false);
+      REQUIRE(agree());
+    }
+    THEN("the accumulated sum agrees with the loop over the registers") {
+      per_register("base", terms, "ref");
+      FillStage(mesh, "out", base);
+      fused(true);
+      REQUIRE(agree());
+    }
+  }
+
+  GIVEN("A register with a zero coefficient that is not a number") {
+    // the sum of the third stage of rk4 only reads the second stage
+    const ButcherIntegrator integrator("rk4");
+    REQUIRE(integrator.a[2][0] == 0.0);
+    FillStage(mesh, registers[0], [](int) { return std::nan(""); });
+    for (int p = 0; p < mesh.DefaultNumPartitions(); ++p) {
+      Update::SumButcher(flags, md("base", p), stage_data(p, integrator.nstages),
+                         md("out", p), &integrator, dt, 3);
+    }
+    THEN("the register is skipped") {
+      const Real a = integrator.a[2][1];
+      REQUIRE(InteriorEquals(mesh, "out", [&](int gid, const std::string &) {
+        return base(gid) + dt * a * value(1, gid);
+      }));
+    }
+  }
+
+  GIVEN("A sparse variable that is not allocated in the base stage") {
+    if (!parthenon::Globals::sparse_config.enabled) return;
+    const ButcherIntegrator integrator("rk2");
+    mesh.block_list[0]->meshblock_data.Get()->DeallocateSparse("s_1");
+    FillStage(mesh, "out", [](int) { return 99.0; });
+    for (int p = 0; p < mesh.DefaultNumPartitions(); ++p) {
+      Update::SumButcher(flags, md("base", p), stage_data(p, integrator.nstages),
+                         md("out", p), &integrator, dt, 2);
+    }
+    THEN("the output is overwritten with the sum of the other stages") {
+      const Real a = integrator.a[1][0];
+      REQUIRE(InteriorEquals(mesh, "out", [&](int gid, const std::string &label) {
+        const bool missing = (gid == 0 && label == "s_1");
+        return (missing ? 0.0 : base(gid)) + dt * a * value(0, gid);
+      }));
+    }
+  }
+}
+
+#endif // MPI_PARALLEL
@@ -23,6 +23,7 @@
 #include <catch2/catch.hpp>
 
 #include "basic_types.hpp"
+#include "interface/make_pack_descriptor.hpp"
 #include "interface/mesh_data.hpp"
 #include "interface/meshblock_data.hpp"
 #include "interface/metadata.hpp"
@@ -189,3 +190,54 @@ TEST_CASE("MeshData works as expected for simple packs", "[MeshData]") {
     }
   }
 }
+
+TEST_CASE("Variables with scratch fluxes share their flux storage", "[MeshData]") {
+  GIVEN("A block with scratch flux variables of two shapes and a regular variable") {
+    constexpr int N = 6;
+    constexpr int NDIM = 3;
+    const std::vector<int> scalar_shape{N, N, N};
+    const std::vector<int> vector_shape{N, N, N, 3};
+    Metadata m_scratch({Metadata::Independent, Metadata::WithFluxes,
+                        Metadata::ScratchFluxes},
+                       scalar_shape);
+    Metadata m_vector({Metadata::Independent, Metadata::WithFluxes,
+                       Metadata::ScratchFluxes},
+                      vector_shape);
+    Metadata m({Metadata::Independent, Metadata::WithFluxes}, scalar_shape);
+    auto pkg = std::make_shared<StateDescriptor>("Test package");
+    pkg->AddField("s1", m_scratch);
+    pkg->AddField("s2", m_scratch);
+    pkg->AddField("s3", m_vector);
+    pkg->AddField("v", m);
+    BlockList_t block_list = MakeBlockList(pkg, 1, N, NDIM);
+    auto &pmbd = block_list[0]->meshblock_data.Get();
+    auto flux_ptr = [&](const std::string &name) {
+      return pmbd->Get(name).flux[parthenon::X1DIR].data();
+    };
+
+    THEN("Only the scratch fluxes of the same shape share storage") {
+      REQUIRE(flux_ptr("s1") == flux_ptr("s2"));
+      REQUIRE(flux_ptr("s1") != flux_ptr("s3"));
+      REQUIRE(flux_ptr("s1") != flux_ptr("v"));
+    }
+
+    THEN("The shared fluxes are shared with the stage copies") {
+      auto &stage = block_list[0]->meshblock_data.Add("stage", pmbd);
+      REQUIRE(stage->Get("s2").flux[parthenon::X1DIR].data() == flux_ptr("s1"));
+    }
+
+    THEN("Flux packs cannot contain several variables with the same scratch fluxes") {
+      using parthenon::PDOpt;
+      using names_t = std::vector<std::string>;
+      REQUIRE_THROWS(pmbd->PackVariablesAndFluxes(names_t{"s1", "s2"}));
+      REQUIRE_THROWS(parthenon::MakePackDescriptor(pkg.get(), names_t{"s1", "s2"}, {},
+                                                   {PDOpt::WithFluxes})
+                         .GetPack(pmbd.get()));
+      REQUIRE_NOTHROW(pmbd->PackVariablesAndFluxes(names_t{"s1", "s3", "v"}));
+      REQUIRE_NOTHROW(parthenon::MakePackDescriptor(pkg.get(), names_t{"s1", "s3", "v"},
+                                                    {}, {PDOpt::WithFluxes})
+                          .GetPack(pmbd.get()));
+      REQUIRE_NOTHROW(pmbd->PackVariables(names_t{"s1", "s2"}));
+    }
+  }
+}
@@ -0,0 +1,228 @@
+//========================================================================================
+// Parthenon performance portable AMR framework
+// Copyright(C) 2023 The Parthenon collaboration
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "mesh/logical_location.hpp"
+#include "mesh/meshblock_tree.hpp"
+
+using parthenon::LogicalLocation;
+using parthenon::MeshBlockTree;
+using parthenon::RootGridInfo;
+
+namespace {
+std::vector<LogicalLocation> GetLeaves(MeshBlockTree &tree, std::vector<int> *pgids) {
+  int count;
+  tree.CountMeshBlock(count);
+  std::vector<LogicalLocation> leaves(count);
+  if (pgids != nullptr) pgids->resize(count);
+  tree.GetMeshBlockList(leaves.data(), pgids ? pgids->data() : nullptr, count);
+  return leaves;
+}
+
+bool IsBalanced(const std::vector<LogicalLocation> &leaves, const RootGridInfo &rg_info) {
+  for (const auto &a : leaves) {
+    for (const auto &b : leaves) {
+      if (a.IsNeighbor(b, rg_info) && std::abs(a.level() - b.level()) > 1) return false;
+    }
+  }
+  return true;
+}
+
+// Brute force version of MeshBlockTree::FindNeighbor on a non-periodic root grid
+LogicalLocation FindNeighborBruteForce(const std::vector<LogicalLocation> &leaves,
+                                       const LogicalLocation &nloc, bool &is_leaf) {
+  for (const auto &leaf : leaves) {
+    if (nloc.IsContainedIn(leaf)) {
+      is_leaf = true;
+      return leaf;
+    }
+  }
+  is_leaf = false;
+  return nloc;
+}
+} // namespace
+
+TEST_CASE("MeshBlockTree", "[MeshBlockTree]") {
+  GIVEN("A 2D tree with a 2x2 root grid") {
+    RootGridInfo rg_info(1, 2, 2, 1, false, false, false);
+    MeshBlockTree tree(rg_info, 2);
+    tree.CreateRootGrid();
+    auto leaves = GetLeaves(tree, nullptr);
+    REQUIRE(leaves.size() == 4);
+    REQUIRE(std::is_sorted(leaves.begin(), leaves.end()));
+
+    WHEN("a block is added at a deep level") {
+      int nnew = 0;
+      tree.AddMeshBlock(LogicalLocation(4, 0, 0, 0), nnew);
+      std::vector<int> old_gids;
+      leaves = GetLeaves(tree, &old_gids);
+      THEN("the tree contains the block, is sorted and is 2:1 balanced") {
+        REQUIRE(nnew == leaves.size() - 4);
+        REQUIRE(std::is_sorted(leaves.begin(), leaves.end()));
+        REQUIRE(std::count(leaves.begin(), leaves.end(), LogicalLocation(4, 0, 0, 0)));
+        REQUIRE(IsBalanced(leaves, rg_info));
+        // All new blocks came from the first root block
+        for (int n = 0; n < leaves.size(); ++n) {
+          if (leaves[n].IsContainedIn(LogicalLocation(1, 0, 0, 0)))
+            REQUIRE(old_gids[n] == 0);
+        }
+      }
+
+      THEN("neighbor searches agree with a brute force search") {
+        for (const auto &leaf : leaves) {
+          for (int ox2 = -1; ox2 <= 1; ++ox2) {
+            for (int ox1 = -1; ox1 <= 1; ++ox1) {
+              if (ox1 == 0 && ox2 == 0) continue;
+              auto node = tree.FindNeighbor(leaf, ox1, ox2, 0);
+              auto nloc = leaf.GetSameLevelNeighbor(ox1, ox2, 0);
+              const std::int64_t nmax = 2LL << (leaf.level() - 1);
+              if (nloc.lx1() < 0 || nloc.lx2() < 0 || nloc.lx1() >= nmax ||
+                  nloc.lx2() >= nmax) {
+                REQUIRE(!node);
+                continue;
+              }
+              bool is_leaf;
+              auto expected = FindNeighborBruteForce(leaves, nloc, is_leaf);
+              REQUIRE(node);
+              REQUIRE(node.IsLeaf() == is_leaf);
+              REQUIRE(node.GetLocation() == expected);
+              if (is_leaf) {
+                const int gid = std::distance(
+                    leaves.begin(), std::find(leaves.begin(), leaves.end(), expected));
+                REQUIRE(node.GetGid() == gid);
+              } else {
+                REQUIRE(node.GetLeaf(0, 0, 0).GetLocation() == nloc.GetDaughter(0, 0, 0));
+              }
+            }
+          }
+        }
+      }
+
+      THEN("derefining all refined blocks recovers the root grid") {
+        int ndel = 0;
+        for (int level = 3; level >= 1; --level) {
+          std::vector<LogicalLocation> lderef;
+          for (const auto &leaf : GetLeaves(tree, nullptr)) {
+            if (leaf.level() == level + 1) lderef.push_back(leaf.GetParent());
+          }
+          tree.Derefine(lderef, ndel);
+        }
+        REQUIRE(ndel == nnew);
+        REQUIRE(GetLeaves(tree, nullptr).size() == 4);
+      }
+    }
+
+    WHEN("a block next to a refined region is derefined") {
+      int nnew = 0;
+      tree.Refine({LogicalLocation(1, 0, 0, 0)}, nnew);
+      tree.Refine({LogicalLocation(2, 1, 1, 0)}, nnew);
+      const auto before = GetLeaves(tree, nullptr);
+      int ndel = 0;
+      tree.Derefine({LogicalLocation(1, 1, 0, 0)}, ndel);
+      THEN("the derefinement is rejected to keep the tree balanced") {
+        REQUIRE(ndel == 0);
+        REQUIRE(GetLeaves(tree, nullptr) == before);
+      }
+    }
+
+    WHEN("a buffer is requested around a refined block") {
+      int nnew = 0;
+      tree.Refine({LogicalLocation(1, 0, 0, 0)}, nnew);
+      std::vector<LogicalLocation> region, lref;
+      tree.GetRefinementBuffer({LogicalLocation(2, 1, 1, 0)}, 2, region, lref);
+      THEN("the buffer covers the same level blocks in range inside the domain") {
+        // lx1, lx2 in [0, 3] since the root grid is not periodic
+        REQUIRE(region.size() == 16);
+        REQUIRE(std::count(region.begin(), region.end(), LogicalLocation(2, 3, 3, 0)));
+        // the four refined blocks and the three unrefined root blocks
+        REQUIRE(lref.size() == 7);
+        REQUIRE(std::count(lref.begin(), lref.end(), LogicalLocation(1, 1, 1, 0)));
+      }
+    }
+  }
+
+  GIVEN("A list of leaves from a restart") {
+    RootGridInfo rg_info(0, 1, 1, 1, false, false, false);
+    MeshBlockTree tree(rg_info, 3);
+    tree.CreateRootGrid();
+    std::vector<LogicalLocation> locs;
+    for (const auto &daughter : LogicalLocation().GetDaughters()) {
+      if (daughter == LogicalLocation(1, 1, 1, 1)) {
+        for (const auto &gdaughter : daughter.GetDaughters())
+          locs.push_back(gdaughter);
+      } else {
+        locs.push_back(daughter);
+      }
+    }
+    std::reverse(locs.begin(), locs.end());
+    tree.AddMeshBlockWithoutRefine(locs);
+    THEN("the tree contains exactly those leaves in Z-order") {
+      auto leaves = GetLeaves(tree, nullptr);
+      std::sort(locs.begin(), locs.end());
+      REQUIRE(leaves == locs);
+    }
+  }
+}
+
+TEST_CASE("MeshBlockTree neighbor search", "[MeshBlockTree]") {
+  // Randomly refined 3D periodic mesh
+  RootGridInfo rg_info(2, 4, 4, 4, true, true, true);
+  MeshBlockTree tree(rg_info, 3);
+  tree.CreateRootGrid();
+  std::mt19937 gen(1234);
+  for (int level = 2; level < 5; ++level) {
+    auto leaves = GetLeaves(tree, nullptr);
+    std::vector<LogicalLocation> lref;
+    std::bernoulli_distribution refine(0.3);
+    for (const auto &leaf : leaves)
+      if (refine(gen)) lref.push_back(leaf);
+    int nnew = 0;
+    tree.Refine(lref, nnew);
+  }
+  std::vector<int> gids;
+  auto leaves = GetLeaves(tree, &gids);
+
+  // Neighbor searches through a map of the leaves, as done for the same level neighbors
+  std::map<LogicalLocation, int> leaf_map;
+  for (int n = 0; n < leaves.size(); ++n)
+    leaf_map[leaves[n]] = gids[n];
+
+  for (const auto &leaf : leaves) {
+    for (int ox3 = -1; ox3 <= 1; ++ox3) {
+      for (int ox2 = -1; ox2 <= 1; ++ox2) {
+        for (int ox1 = -1; ox1 <= 1; ++ox1) {
+          const std::int64_t nmax = 4LL << (leaf.level() - 2);
+          LogicalLocation nloc(leaf.level(), (leaf.lx1() + ox1 + nmax) % nmax,
+                               (leaf.lx2() + ox2 + nmax) % nmax,
+                               (leaf.lx3() + ox3 + nmax) % nmax);
+          // search the same level, then the coarser level
+          auto it = leaf_map.find(nloc);
+          if (it == leaf_map.end()) it = leaf_map.find(nloc.GetParent());
+          const int expected = (it == leaf_map.end()) ? -1 : it->second;
+          REQUIRE(tree.FindNeighbor(leaf, ox1, ox2, ox3).GetGid() == expected);
+        }
+      }
+    }
+  }
+}
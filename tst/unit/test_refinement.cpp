@@ -0,0 +1,268 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "amr_criteria/amr_criteria.hpp"
+#include "amr_criteria/fused_criteria.hpp"
+#include "basic_types.hpp"
+#include "interface/mesh_data.hpp"
+#include "interface/meshblock_data.hpp"
+#include "interface/metadata.hpp"
+#include "interface/state_descriptor.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/meshblock.hpp"
+#include "parameter_input.hpp"
+#include "utils/error_checking.hpp"
+
+// TODO(jcd): can't call the MeshBlock constructor without mesh_refinement.hpp???
+#include "mesh/mesh_refinement.hpp"
+
+using parthenon::AmrTag;
+using parthenon::AMRCriteria;
+using parthenon::BlockList_t;
+using parthenon::DevExecSpace;
+using parthenon::IndexDomain;
+using parthenon::loop_pattern_mdrange_tag;
+using parthenon::MeshBlock;
+using parthenon::MeshData;
+using parthenon::Metadata;
+using parthenon::par_for;
+using parthenon::ParameterInput;
+using parthenon::Real;
+using parthenon::StateDescriptor;
+
+namespace {
+BlockList_t MakeBlockList(const std::shared_ptr<StateDescriptor> pkg, const int NBLOCKS,
+                          const int NSIDE, const int NDIM) {
+  BlockList_t block_list;
+  block_list.reserve(NBLOCKS);
+  for (int i = 0; i < NBLOCKS; ++i) {
+    auto pmb = std::make_shared<MeshBlock>(NSIDE, NDIM);
+    auto &pmbd = pmb->meshblock_data.Get();
+    pmbd->Initialize(pkg, pmb);
+    block_list.push_back(pmb);
+  }
+  return block_list;
+}
+
+// Sets every component of var on block b to exp(slope * (i + j + k)), so that the
+// normalized first derivative is sinh(slope) everywhere
+void SetExponential(const std::shared_ptr<MeshBlock> &pmb, const std::string &var,
+                    const std::vector<Real> &slopes) {
+  auto v = pmb->meshblock_data.Get()->Get(var).data.Get<4>();
+  const int ncomp = v.extent_int(0);
+  PARTHENON_REQUIRE(ncomp == static_cast<int>(slopes.size()),
+                    "Need one slope per component");
+  for (int c = 0; c < ncomp; ++c) {
+    const Real slope = slopes[c];
+    par_for(
+        loop_pattern_mdrange_tag, "set exponential", DevExecSpace(), 0,
+        v.extent_int(1) - 1, 0, v.extent_int(2) - 1, 0, v.extent_int(3) - 1,
+        KOKKOS_LAMBDA(const int k, const int j, const int i) {
+          v(c, k, j, i) = std::exp(slope * (i + j + k));
+        });
+  }
+}
+} // namespace
+
+TEST_CASE("Derivative refinement criteria of all blocks", "[Refinement]") {
+  GIVEN("Blocks with fields of known derivatives and derivative criteria") {
+    constexpr int N = 8;
+    constexpr int NDIM = 3;
+    constexpr int NBLOCKS = 4;
+    auto pkg = std::make_shared<StateDescriptor>("Test package");
+    pkg->AddField("q", Metadata({Metadata::Independent}, std::vector<int>{N, N, N}));
+    pkg->AddField("v", Metadata({Metadata::Independent, Metadata::Vector},
+                                std::vector<int>{N, N, N, 2}));
+    BlockList_t block_list = MakeBlockList(pkg, NBLOCKS, N, NDIM);
+    MeshData<Real> mesh_data("base");
+    mesh_data.Set(block_list, nullptr);
+
+    // first derivatives of 0, 0.1 and 1.2 for the default tolerances 0.05 and 0.5. The
+    // first component of v would always refine but is not checked.
+    const std::vector<Real> q_slopes{0.0, 0.1, 1.0, 0.0};
+    const std::vector<Real> v_slopes{0.0, 0.0, 0.0, 1.0};
+    for (int b = 0; b < NBLOCKS; ++b) {
+      SetExponential(block_list[b], "q", {q_slopes[b]});
+      SetExponential(block_list[b], "v", {1.0, v_slopes[b]});
+    }
+
+    ParameterInput pin;
+    pin.SetString("parthenon/refinement0", "field", "q");
+    pin.SetString("parthenon/refinement1", "field", "v");
+    pin.SetString("parthenon/refinement1", "vector_i", "1");
+    pin.SetString("parthenon/refinement2", "field", "q");
+    std::vector<std::string> methods{"derivative_order_1", "derivative_order_1",
+                                     "derivative_order_2"};
+    std::vector<std::shared_ptr<AMRCriteria>> criteria;
+    for (int n = 0; n < methods.size(); ++n) {
+      std::string block = "parthenon/refinement" + std::to_string(n);
+      criteria.push_back(AMRCriteria::MakeAMRCriteria(methods[n], &pin, block));
+    }
+
+    WHEN("The criteria are evaluated for all blocks at once") {
+      parthenon::Refinement::DerivativeTagger tagger(criteria);
+      REQUIRE(tagger.HostCriteria().empty());
+      const auto &arrays = tagger.Tag(&mesh_data, pkg.get());
+      Kokkos::deep_copy(arrays.tags_h, arrays.tags);
+
+      THEN("the tags are the maximum of the per-block criteria") {
+        for (int b = 0; b < NBLOCKS; ++b) {
+          auto pmbd = block_list[b]->meshblock_data.Get();
+          AmrTag expected = AmrTag::derefine;
+          for (const auto &amr : criteria) {
+            expected = std::max(expected, (*amr)(pmbd.get()));
+          }
+          REQUIRE(arrays.tags_h(b) == expected);
+        }
+        REQUIRE(arrays.tags_h(0) == AmrTag::derefine);
+        REQUIRE(arrays.tags_h(1) == AmrTag::same);
+        REQUIRE(arrays.tags_h(2) == AmrTag::refine);
+        REQUIRE(arrays.tags_h(3) == AmrTag::refine);
+      }
+
+      THEN("a second call reuses the arrays and gives the same tags") {
+        const auto tags = arrays.tags;
+        const auto &again = tagger.Tag(&mesh_data, pkg.get());
+        REQUIRE(again.tags.data() == tags.data());
+        auto tags_h = Kokkos::create_mirror_view_and_copy(parthenon::HostMemSpace(),
+                                                          again.tags);
+        for (int b = 0; b < NBLOCKS; ++b) {
+          REQUIRE(tags_h(b) == arrays.tags_h(b));
+        }
+      }
+
+      THEN("another MeshData with as many blocks gets its own arrays") {
+        MeshData<Real> other("other");
+        other.Set(block_list, nullptr);
+        const auto &other_arrays = tagger.Tag(&other, pkg.get());
+        REQUIRE(other_arrays.tags.data() != arrays.tags.data());
+        REQUIRE(other_arrays.levels.data() != arrays.levels.data());
+        auto tags_h = Kokkos::create_mirror_view_and_copy(parthenon::HostMemSpace(),
+                                                          other_arrays.tags);
+        for (int b = 0; b < NBLOCKS; ++b) {
+          REQUIRE(tags_h(b) == arrays.tags_h(b));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Fused device refinement criteria", "[Refinement]") {
+  GIVEN("Blocks with a field of known derivatives") {
+    constexpr int N = 8;
+    constexpr int NDIM = 3;
+    constexpr int NBLOCKS = 4;
+    auto pkg = std::make_shared<StateDescriptor>("Test package");
+    pkg->AddField("q", Metadata({Metadata::Independent}, std::vector<int>{N, N, N}));
+    BlockList_t block_list = MakeBlockList(pkg, NBLOCKS, N, NDIM);
+    MeshData<Real> mesh_data("base");
+    mesh_data.Set(block_list, nullptr);
+    const std::vector<Real> slopes{0.0, 0.5, 1.0, 0.1};
+    for (int b = 0; b < NBLOCKS; ++b) {
+      SetExponential(block_list[b], "q", {slopes[b]});
+    }
+
+    using namespace parthenon::Refinement;
+    auto desc = parthenon::MakePackDescriptor(pkg.get(), std::vector<std::string>{"q"});
+    auto pack = desc.GetPack(&mesh_data);
+    auto tag_blocks = [&](const auto &...criteria) {
+      parthenon::ParArray1D<AmrTag> tags("tags", NBLOCKS);
+      Kokkos::deep_copy(tags, AmrTag::derefine);
+      TagBlocks(&mesh_data, pack, tags, criteria...);
+      return Kokkos::create_mirror_view_and_copy(parthenon::HostMemSpace(), tags);
+    };
+
+    THEN("the gradient criterion agrees with the first derivative criterion") {
+      ParameterInput pin;
+      pin.SetString("parthenon/refinement0", "field", "q");
+      std::string method = "derivative_order_1";
+      std::string block = "parthenon/refinement0";
+      auto amr = AMRCriteria::MakeAMRCriteria(method, &pin, block);
+      auto tags = tag_blocks(GradientCriterion(0, 0, 0, amr->refine_criteria,
+                                               amr->derefine_criteria));
+      for (int b = 0; b < NBLOCKS; ++b) {
+        auto pmbd = block_list[b]->meshblock_data.Get();
+        REQUIRE(tags(b) == (*amr)(pmbd.get()));
+      }
+    }
+
+    THEN("the threshold criterion agrees with the extrema of each block") {
+      const Real above = 1.0e6, below = 2.0;
+      auto tags = tag_blocks(ThresholdCriterion(0, 0, above, below));
+      for (int b = 0; b < NBLOCKS; ++b) {
+        auto &pmb = block_list[b];
+        auto q = pmb->meshblock_data.Get()->Get("q").data.Get<4>();
+        auto q_h = q.GetHostMirrorAndCopy();
+        auto ib = pmb->cellbounds.GetBoundsI(IndexDomain::interior);
+        auto jb = pmb->cellbounds.GetBoundsJ(IndexDomain::interior);
+        auto kb = pmb->cellbounds.GetBoundsK(IndexDomain::interior);
+        Real qmin = q_h(0, kb.s, jb.s, ib.s), qmax = qmin;
+        for (int k = kb.s; k <= kb.e; ++k) {
+          for (int j = jb.s; j <= jb.e; ++j) {
+            for (int i = ib.s; i <= ib.e; ++i) {
+              qmin = std::min(qmin, q_h(0, k, j, i));
+              qmax = std::max(qmax, q_h(0, k, j, i));
+            }
+          }
+        }
+        AmrTag expected = AmrTag::same;
+        if (qmax > above) {
+          expected = AmrTag::refine;
+        } else if (qmax < below) {
+          expected = AmrTag::derefine;
+        }
+        REQUIRE(tags(b) == expected);
+      }
+    }
+
+    THEN("the Loehner criterion agrees with its value for an exponential") {
+      const Real refine_tol = 0.3, derefine_tol = 0.1, filter = 0.01;
+      auto tags = tag_blocks(LohnerCriterion(0, 0, refine_tol, derefine_tol, filter));
+      for (int b = 0; b < NBLOCKS; ++b) {
+        const Real s = slopes[b];
+        const Real e =
+            (std::cosh(s) - 1.0) / (std::sinh(s) + filter * (std::cosh(s) + 1.0));
+        AmrTag expected = AmrTag::same;
+        if (e > refine_tol) {
+          expected = AmrTag::refine;
+        } else if (e < derefine_tol) {
+          expected = AmrTag::derefine;
+        }
+        REQUIRE(tags(b) == expected);
+      }
+      REQUIRE(tags(0) == AmrTag::derefine);
+      REQUIRE(tags(1) == AmrTag::same);
+      REQUIRE(tags(2) == AmrTag::refine);
+    }
+
+    THEN("fused criteria give the maximum of the individual criteria") {
+      const ThresholdCriterion threshold(0, 0, 1.0e6, 2.0);
+      const GradientCriterion gradient(0, 0, 0, 2.0, 0.2);
+      const LohnerCriterion lohner(0, 0, 0.3, 0.1);
+      auto fused = tag_blocks(threshold, gradient, lohner);
+      auto t = tag_blocks(threshold);
+      auto g = tag_blocks(gradient);
+      auto l = tag_blocks(lohner);
+      for (int b = 0; b < NBLOCKS; ++b) {
+        REQUIRE(fused(b) == std::max({t(b), g(b), l(b)}));
+      }
+    }
+  }
+}
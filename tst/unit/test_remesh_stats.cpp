@@ -0,0 +1,138 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "mesh/remesh_stats.hpp"
+
+using parthenon::RemeshStats;
+using Phase = parthenon::RemeshStats::Phase;
+
+namespace {
+std::vector<std::string> ReadLines(const std::string &fname) {
+  std::ifstream file(fname);
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(file, line);) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+std::vector<std::string> Split(const std::string &line) {
+  std::vector<std::string> fields;
+  std::stringstream ss(line);
+  for (std::string field; std::getline(ss, field, ',');) {
+    fields.push_back(field);
+  }
+  return fields;
+}
+} // namespace
+
+TEST_CASE("Remesh statistics", "[RemeshStats]") {
+  const std::string fname = "test_remesh_stats.remesh.csv";
+  std::remove(fname.c_str());
+
+  GIVEN("Disabled statistics") {
+    RemeshStats stats;
+    stats.AddCheck();
+    stats.AddVolume(Phase::migration_send, 2, 1024);
+    { auto timer = stats.Time(Phase::tag); }
+    THEN("nothing is accumulated") {
+      REQUIRE(stats.NumChecks() == 0);
+      REQUIRE(stats.Blocks(Phase::migration_send) == 0);
+      REQUIRE(stats.Seconds(Phase::tag) == 0.0);
+    }
+  }
+
+  GIVEN("Enabled statistics with some remeshing work") {
+    RemeshStats stats;
+    stats.Enable(fname, false);
+    stats.AddCheck();
+    stats.AddCheck();
+    stats.AddTime(Phase::tag, 0.5);
+    stats.AddVolume(Phase::migration_send, 2, 1024);
+    { auto timer = stats.Time(Phase::tree_update); }
+    REQUIRE(stats.NumChecks() == 2);
+    REQUIRE(stats.Seconds(Phase::tree_update) >= 0.0);
+
+    WHEN("records are written") {
+      stats.Write(1, 16, 8, 0);
+      THEN("the phases are reset") {
+        REQUIRE(stats.NumChecks() == 0);
+        REQUIRE(stats.Seconds(Phase::tag) == 0.0);
+        REQUIRE(stats.Bytes(Phase::migration_send) == 0);
+      }
+      stats.AddVolume(Phase::restriction, 8, 0);
+      stats.Write(2, 9, 0, 7);
+
+      THEN("the file has one header and one record per remesh") {
+        auto lines = ReadLines(fname);
+        REQUIRE(lines.size() == 3);
+        const auto header = Split(lines[0]);
+        REQUIRE(header.size() == 5 + 3 * RemeshStats::nphases);
+        REQUIRE(header[0] == "# remesh");
+        REQUIRE(header[5] == "tag_time");
+
+        const auto first = Split(lines[1]);
+        REQUIRE(first.size() == header.size());
+        REQUIRE(first[0] == "1");
+        REQUIRE(first[1] == "16");
+        REQUIRE(first[2] == "8");
+        REQUIRE(first[4] == "2");
+        REQUIRE(std::stod(first[5]) == 0.5);
+        const int send = 5 + 3 * static_cast<int>(Phase::migration_send);
+        REQUIRE(header[send + 1] == "migration_send_blocks");
+        REQUIRE(first[send + 1] == "2");
+        REQUIRE(first[send + 2] == "1024");
+
+        const auto second = Split(lines[2]);
+        REQUIRE(second[0] == "2");
+        REQUIRE(second[4] == "0");
+        REQUIRE(std::stod(second[5]) == 0.0);
+        const int restriction = 5 + 3 * static_cast<int>(Phase::restriction);
+        REQUIRE(second[restriction + 1] == "8");
+      }
+
+      AND_WHEN("a restarted run appends to the file") {
+        RemeshStats restarted;
+        restarted.Enable(fname, true);
+        restarted.Write(3, 16, 7, 0);
+        THEN("no second header is written") {
+          auto lines = ReadLines(fname);
+          REQUIRE(lines.size() == 4);
+          REQUIRE(Split(lines[3])[0] == "3");
+        }
+      }
+
+      AND_WHEN("a new run writes to the file") {
+        RemeshStats rerun;
+        rerun.Enable(fname, false);
+        rerun.Write(1, 16, 8, 0);
+        THEN("the file is overwritten") {
+          auto lines = ReadLines(fname);
+          REQUIRE(lines.size() == 2);
+          REQUIRE(lines[0].rfind("# remesh", 0) == 0);
+          REQUIRE(Split(lines[1])[0] == "1");
+        }
+      }
+    }
+  }
+
+  std::remove(fname.c_str());
+}
@@ -147,6 +147,18 @@ TEST_CASE("Test behavior of sparse packs", "[SparsePack]") {
         REQUIRE(pack.ContainsHost<v1, v5>(2));
       }
 
+      THEN("A cached sparse pack is rebuilt when a variable in it is deallocated") {
+        auto desc = parthenon::MakePackDescriptor<v1, v3, v5>(pkg.get());
+        auto pack = desc.GetPack(&mesh_data);
+        REQUIRE(pack.ContainsHost(4, v5()));
+        const auto epoch = block_list[4]->GetAllocationEpoch();
+        block_list[4]->DeallocateSparse("v5");
+        REQUIRE(block_list[4]->GetAllocationEpoch() > epoch);
+        auto new_pack = desc.GetPack(&mesh_data);
+        REQUIRE(!new_pack.ContainsHost(4, v5()));
+        REQUIRE(new_pack.ContainsHost(4, v1()));
+      }
+
       THEN("A sparse pack correctly loads this data and can be read from v3 on all "
            "blocks") {
         // Create a pack use type variables
@@ -308,3 +320,52 @@ TEST_CASE("Test behavior of sparse packs", "[SparsePack]") {
     }
   }
 }
+
+TEST_CASE("Keys of pack descriptors", "[SparsePack]") {
+  GIVEN("A package with some fields") {
+    const std::vector<int> shape{6, 6, 6};
+    Metadata m({Metadata::Independent, Metadata::WithFluxes}, shape);
+    auto pkg = std::make_shared<StateDescriptor>("Test package");
+    pkg->AddField(v1::name(), m);
+    pkg->AddField(v3::name(), m);
+    pkg->AddField(v5::name(), m);
+
+    using parthenon::PDOpt;
+    auto desc = parthenon::MakePackDescriptor<v1, v3>(pkg.get());
+
+    THEN("equal descriptors have the same key and check") {
+      auto same = parthenon::MakePackDescriptor<v1, v3>(pkg.get());
+      auto same_notype = parthenon::MakePackDescriptor(
+          pkg.get(), std::vector<std::string>{"v1", "v3"});
+      REQUIRE(same.key == desc.key);
+      REQUIRE(same.check == desc.check);
+      REQUIRE(same_notype.key == desc.key);
+      REQUIRE(same_notype.check == desc.check);
+    }
+
+    THEN("read-only descriptors have the same key") {
+      auto read = parthenon::MakePackDescriptor<v1, v3>(pkg.get(), {}, {PDOpt::ReadOnly});
+      REQUIRE(read.key == desc.key);
+      REQUIRE(read.check == desc.check);
+    }
+
+    THEN("descriptors that differ in order, variables or options have different keys") {
+      std::vector<parthenon::impl::PackDescriptor> others{
+          parthenon::MakePackDescriptor<v3, v1>(pkg.get()),
+          parthenon::MakePackDescriptor<v1, v5>(pkg.get()),
+          parthenon::MakePackDescriptor<v1>(pkg.get()),
+          parthenon::MakePackDescriptor(pkg.get(), std::vector<std::string>{"v1|v3"},
+                                        std::vector<bool>{true}),
+          parthenon::MakePackDescriptor<v1, v3>(pkg.get(), {}, {PDOpt::WithFluxes}),
+          parthenon::MakePackDescriptor<v1, v3>(pkg.get(), {}, {PDOpt::Coarse}),
+          parthenon::MakePackDescriptor<v1, v3>(pkg.get(), {}, {PDOpt::Flatten})};
+      for (int i = 0; i < others.size(); ++i) {
+        REQUIRE(others[i].key != desc.key);
+        REQUIRE(others[i].check != desc.check);
+        for (int j = 0; j < i; ++j) {
+          REQUIRE(others[i].key != others[j].key);
+        }
+      }
+    }
+  }
+}
@@ -107,6 +107,35 @@ TEST_CASE("Add, Get, and Update are called", "[Add,Get,Update]") {
   }
 }
 
+TEST_CASE("Params handles", "[GetHandle]") {
+  GIVEN("A mutable key with some value") {
+    Params params;
+    std::string key = "test_key";
+    params.Add(key, -2.0, true);
+    THEN("a handle reads the value") {
+      auto handle = params.GetHandle<double>(key);
+      REQUIRE(handle.IsValid());
+      REQUIRE(*handle == Approx(-2.0));
+      AND_THEN("the handle reflects updates of the value") {
+        params.Update<double>(key, 3.0);
+        REQUIRE(handle.Get() == Approx(3.0));
+        *params.GetMutable<double>(key) = 4.0;
+        REQUIRE(*handle == Approx(4.0));
+      }
+    }
+    WHEN("attempting to get a handle of a different type") {
+      THEN("an error is thrown") {
+        REQUIRE_THROWS_AS(params.GetHandle<int>(key), std::runtime_error);
+      }
+    }
+    WHEN("attempting to get a handle of a key that does not exist") {
+      THEN("an error is thrown") {
+        REQUIRE_THROWS_AS(params.GetHandle<double>("other_key"), std::runtime_error);
+      }
+    }
+  }
+}
+
 TEST_CASE("reset is called", "[reset]") {
   GIVEN("A key is added") {
     Params params;
@@ -0,0 +1,137 @@
+//========================================================================================
+// Parthenon performance portable AMR framework
+// Copyright(C) 2023 The Parthenon collaboration
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "Kokkos_Core.hpp"
+#include "basic_types.hpp"
+#include "interface/variable_arena.hpp"
+
+using parthenon::Real;
+using parthenon::VariableArena;
+using parthenon::VariableArenaOptions;
+
+TEST_CASE("VariableArena", "[VariableArena]") {
+  GIVEN("An arena with aligned and padded variables") {
+    VariableArenaOptions options;
+    options.enabled = true;
+    options.alignment = 8 * sizeof(Real);
+    options.padding = 1;
+    VariableArena<Real> arena(options);
+    arena.Add("a", {5, 1, 1, 1, 1, 1, 1});
+    arena.Add("b", {4, 2, 1, 1, 1, 1, 1});
+    arena.Allocate("arena");
+
+    auto a = arena.Get("a");
+    auto b = arena.Get("b");
+    THEN("the variables are placed in order at aligned offsets") {
+      REQUIRE(arena.NumVariables() == 2);
+      REQUIRE(arena.Contains("a"));
+      REQUIRE(!arena.Contains("c"));
+      REQUIRE(a.data() == arena.Storage().data());
+      REQUIRE(b.data() - a.data() == 8);
+      REQUIRE(arena.SizeInBytes() == (8 + 8 + 1) * sizeof(Real));
+      REQUIRE(b.extent_int(6) == 4);
+      REQUIRE(b.extent_int(5) == 2);
+    }
+
+    WHEN("a variable is written") {
+      Kokkos::deep_copy(b, 1.0);
+      THEN("only its part of the arena changes") {
+        auto storage_h =
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), arena.Storage());
+        Real sum = 0.0;
+        for (int i = 0; i < storage_h.extent_int(0); ++i) {
+          sum += storage_h(i) * (i >= 8 && i < 16);
+        }
+        REQUIRE(sum == 8.0);
+        REQUIRE(storage_h(0) == 0.0);
+        REQUIRE(storage_h(16) == 0.0);
+      }
+    }
+
+    THEN("variables cannot be added after allocation") {
+      REQUIRE_THROWS(arena.Add("c", {1, 1, 1, 1, 1, 1, 1}));
+    }
+  }
+
+  GIVEN("An arena holding a variable for several blocks") {
+    VariableArenaOptions options;
+    options.mesh_wide = true;
+    VariableArena<Real> arena(options);
+    arena.Add("a", {3, 2, 1, 1, 1, 1, 1}, 4);
+    arena.Allocate("arena");
+
+    THEN("the blocks are contiguous") {
+      REQUIRE(arena.NumBlocks("a") == 4);
+      REQUIRE(arena.Get("a", 2).data() - arena.Get("a", 0).data() == 2 * 6);
+      REQUIRE(arena.GetAllBlocks("a").extent_int(0) == 4 * 6);
+      REQUIRE_THROWS(arena.Get("a", 4));
+    }
+  }
+
+  GIVEN("An arena of several variables for two blocks") {
+    VariableArenaOptions options;
+    options.alignment = 8 * sizeof(Real);
+    auto make_arena = [&](int padding) {
+      options.padding = padding;
+      VariableArena<Real> arena(options);
+      arena.Add("a", {3, 1, 1, 1, 1, 1, 1}, 2);
+      arena.Add("b", {4, 1, 1, 1, 1, 1, 1}, 2);
+      arena.Add("c", {8, 1, 1, 1, 1, 1, 1}, 2);
+      arena.Allocate("arena");
+      return arena;
+    };
+    auto arena = make_arena(0);
+    using ranges_t = std::vector<std::pair<std::size_t, std::size_t>>;
+
+    THEN("the data of every variable and block can be found") {
+      REQUIRE(arena.Data("b", 1) == arena.Storage().data() + 12);
+      REQUIRE(arena.Data("b", 1) == arena.Get("b", 1).data());
+      REQUIRE(arena.Data("b", 2) == nullptr);
+      REQUIRE(arena.Data("d") == nullptr);
+    }
+
+    THEN("variables that follow each other are merged into one range") {
+      REQUIRE(arena.Ranges({"a", "b", "c"}, 0, 2) == ranges_t{{0, 32}});
+      REQUIRE(arena.Ranges({"c", "b"}, 0, 2) == ranges_t{{8, 32}});
+      REQUIRE(arena.Ranges({"a", "c"}, 0, 2) == ranges_t{{0, 6}, {16, 32}});
+    }
+
+    THEN("the ranges of a subset of the blocks are separate") {
+      REQUIRE(arena.Ranges({"a", "b"}, 0, 1) == ranges_t{{0, 3}, {8, 12}});
+      REQUIRE(arena.Ranges({"b", "c"}, 1, 2) == ranges_t{{12, 16}, {24, 32}});
+    }
+
+    THEN("arenas of the same variables and options have the same layout") {
+      REQUIRE(arena.SameLayout(make_arena(0)));
+      REQUIRE(!arena.SameLayout(make_arena(8)));
+    }
+  }
+
+  GIVEN("An alignment that is not a multiple of the element size") {
+    VariableArenaOptions options;
+    options.alignment = sizeof(Real) + 1;
+    THEN("the arena cannot be created") {
+      REQUIRE_THROWS(VariableArena<Real>(options));
+    }
+  }
+}
@@ -0,0 +1,129 @@
+//========================================================================================
+// Parthenon performance portable AMR framework
+// Copyright(C) 2023 The Parthenon collaboration
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <catch2/catch.hpp>
+
+#include "Kokkos_Core.hpp"
+#include "basic_types.hpp"
+#include "interface/variable_storage_pool.hpp"
+
+using parthenon::Real;
+using parthenon::VariableStoragePool;
+
+TEST_CASE("VariableStoragePool", "[VariableStoragePool]") {
+  GIVEN("An empty pool") {
+    VariableStoragePool<Real> pool;
+    const VariableStoragePool<Real>::dims_t dims{8, 8, 1, 2, 1, 1, 1};
+
+    auto view = pool.Get("var", "var", dims);
+    THEN("storage is allocated with the requested shape") {
+      REQUIRE(pool.Misses() == 1);
+      REQUIRE(pool.Hits() == 0);
+      REQUIRE(view.extent_int(6) == 8);
+      REQUIRE(view.extent_int(5) == 8);
+      REQUIRE(view.extent_int(3) == 2);
+    }
+
+    WHEN("storage that is still referenced is released") {
+      auto copy = view;
+      pool.Release("var", view);
+      THEN("it is not kept") { REQUIRE(pool.SizeInBytes() == 0); }
+    }
+
+    WHEN("storage is released and requested again") {
+      Kokkos::deep_copy(view, 1.0);
+      auto data = view.data();
+      pool.Release("var", view);
+      view = decltype(view)();
+      REQUIRE(pool.SizeInBytes() == 8 * 8 * 2 * sizeof(Real));
+
+      auto other = pool.Get("var", "var", {4, 4, 1, 2, 1, 1, 1});
+      auto reused = pool.Get("var", "var", dims);
+      THEN("only a request with the same label and shape reuses it, zeroed") {
+        REQUIRE(pool.Misses() == 2);
+        REQUIRE(pool.Hits() == 1);
+        REQUIRE(reused.data() == data);
+        REQUIRE(pool.SizeInBytes() == 0);
+        auto reused_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), reused);
+        Real sum = 0.0;
+        for (int j = 0; j < 8; ++j) {
+          for (int i = 0; i < 8; ++i) {
+            sum += reused_h(0, 0, 0, 1, 0, j, i);
+          }
+        }
+        REQUIRE(sum == 0.0);
+      }
+    }
+
+    WHEN("storage is released under a key shared by several labels") {
+      auto data = view.data();
+      pool.Release("var", view);
+      view = decltype(view)();
+      auto reused = pool.Get("var", "var_2", dims);
+      THEN("it is reused for another label") {
+        REQUIRE(pool.Hits() == 1);
+        REQUIRE(reused.data() == data);
+      }
+    }
+  }
+
+  GIVEN("A pool with a size limit") {
+    const VariableStoragePool<Real>::dims_t dims{8, 8, 1, 1, 1, 1, 1};
+    VariableStoragePool<Real> pool(8 * 8 * sizeof(Real));
+    auto a = pool.Get("a", "a", dims);
+    auto b = pool.Get("b", "b", dims);
+
+    WHEN("more storage is released than the pool can hold") {
+      pool.Release("a", a);
+      pool.Release("b", b);
+      THEN("the storage over the limit is freed") {
+        REQUIRE(pool.Released() == 1);
+        REQUIRE(pool.Dropped() == 1);
+        REQUIRE(pool.SizeInBytes() == 8 * 8 * sizeof(Real));
+        REQUIRE(pool.PeakSizeInBytes() == 8 * 8 * sizeof(Real));
+      }
+    }
+  }
+
+  GIVEN("A pool that is trimmed after every remesh") {
+    const VariableStoragePool<Real>::dims_t dims{8, 8, 1, 1, 1, 1, 1};
+    VariableStoragePool<Real> pool;
+    auto a = pool.Get("a", "a", dims);
+    auto b = pool.Get("b", "b", dims);
+    pool.Release("a", a);
+    a = decltype(a)();
+    pool.Trim();
+
+    WHEN("storage released before the previous trim is not reused") {
+      pool.Release("b", b);
+      b = decltype(b)();
+      pool.Trim();
+      THEN("it is freed and the storage released since then is kept") {
+        REQUIRE(pool.SizeInBytes() == 8 * 8 * sizeof(Real));
+        auto c = pool.Get("a", "a", dims);
+        auto d = pool.Get("b", "b", dims);
+        REQUIRE(pool.Hits() == 1);
+        REQUIRE(pool.Misses() == 3);
+      }
+    }
+
+    WHEN("storage is trimmed twice") {
+      pool.Trim();
+      THEN("nothing is held") { REQUIRE(pool.SizeInBytes() == 0); }
+    }
+  }
+}